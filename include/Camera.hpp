@@ -4,8 +4,10 @@
 #include <basic/Ray.hpp>
 #include <basic/Color3.hpp>
 #include <hittable/HittableCollection.hpp>
+#include <hittable/RayRecorder.hpp>
 #include <material/AbstractLight.hpp>
 #include <util/Denoiser.hpp>
+#include <util/SceneResources.hpp>
 
 namespace renderer {
     /*
@@ -24,11 +26,11 @@ namespace renderer {
         // ====== 相机属性 ======
         Point3 cameraCenter;
         Point3 cameraTarget;                    //相机放置在cameraCenter，看向cameraTarget，此两点间距为焦距
-        double horizontalFOV;                   //水平方向的视角，构造时单位为角度，决定视口宽度
+        Real horizontalFOV;                   //水平方向的视角，构造时单位为角度，决定视口宽度
 
         //视口属性
-        double viewPortWidth;
-        double viewPortHeight;
+        Real viewPortWidth;
+        Real viewPortHeight;
 
         /*
          * 视口平面的基向量，用于定位视口
@@ -45,15 +47,15 @@ namespace renderer {
         Point3 pixelOrigin;                     //第一个像素的空间坐标
 
         //采样属性
-        double focusDiskRadius;                 //光线虚化强度，采样平面的圆盘半径
-        double focusDistance;                   //焦距
+        Real focusDiskRadius;                 //光线虚化强度，采样平面的圆盘半径
+        Real focusDistance;                   //焦距
 
         Range shutterRange;                     //相机快门的开启时间段
 
         Uint32 sampleCount;                     //SSAA：每像素采样数
-        double sampleRange;                     //SSAA：采样偏移半径
+        Real sampleRange;                     //SSAA：采样偏移半径
         size_t sqrtSampleCount;
-        double reciprocalSqrtSampleCount;
+        Real reciprocalSqrtSampleCount;
 
         Uint32 rayTraceDepth;                   //光线追踪深度
 
@@ -64,16 +66,27 @@ namespace renderer {
         std::vector<Vec3> normalList;
         std::vector<bool> isRecordList;
 
+        //分块渲染的块边长（像素），针孔相机对每个块进行一次视锥剔除
+        static constexpr Uint32 TILE_SIZE = 16;
+
         Camera(Uint32 windowWidth, Uint32 windowHeight, const Color3 & backgroundColor,
-               const Point3 & center, const Point3 & target, double fov, double focusDiskRadius,
-               const Range & shutterRange, Uint32 sampleCount, double sampleRange, Uint32 rayTraceDepth);
+               const Point3 & center, const Point3 & target, Real fov, Real focusDiskRadius,
+               const Range & shutterRange, Uint32 sampleCount, Real sampleRange, Uint32 rayTraceDepth);
         ~Camera() override = default;
 
         // ====== 对象操作函数 ======
 
-        //渲染图像并写入到参数指定的窗口
-        void render(SDL_Window * window, Uint32 * pixels, const SDL_PixelFormat * format,
-                    const HittableCollection & collection, const std::vector<std::shared_ptr<AbstractHittable>> * pdfObjectList = null);
+        //渲染图像并写入到参数指定的窗口，resources为场景中物体的材质句柄所在的场景资源，渲染期间只读
+        void render(SDL_Window * window, Uint32 * pixels, const SDL_PixelFormat * format, const HittableCollection & collection,
+                    SceneResources & resources, const std::vector<std::shared_ptr<AbstractHittable>> * pdfObjectList = null);
+
+        //包含像素行[startRow, endRow)和列[startColumn, endColumn)所有主光线的视锥，只对针孔相机有效
+        Frustum tileFrustum(Uint32 startRow, Uint32 endRow, Uint32 startColumn, Uint32 endColumn) const;
+
+        //低采样预渲染：每隔pixelStride个像素发射一条光线并追踪完整路径，记录所有对object的求交查询，不写入屏幕
+        //记录的光线用于BVHOptimizer根据真实光线分布优化加速结构
+        std::vector<RecordedRay> recordRays(const std::shared_ptr<AbstractHittable> & object, SceneResources & resources,
+                                            const std::vector<std::shared_ptr<AbstractHittable>> * pdfObjectList = null, Uint32 pixelStride = 4);
 
         // ====== 类封装函数 ======
 
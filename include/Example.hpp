@@ -9,14 +9,22 @@
 #include <material/Isotropic.hpp>
 #include <hittable/Sphere.hpp>
 #include <hittable/Parallelogram.hpp>
+#include <hittable/Box.hpp>
+#include <hittable/InfinitePlane.hpp>
 #include <hittable/Triangle.hpp>
 #include <hittable/Polyhedron.hpp>
+#include <hittable/TriangleMesh.hpp>
+#include <hittable/SphereSet.hpp>
 #include <hittable/Transform.hpp>
 #include <hittable/ConstantMedium.hpp>
+#include <hittable/ProceduralNode.hpp>
 #include <texture/CheckerBoard.hpp>
 #include <texture/Image.hpp>
 #include <texture/PerlinNoise.hpp>
 #include <box/BVHTree.hpp>
+#include <box/KDTree.hpp>
+#include <box/BVHOptimizer.hpp>
+#include <box/SceneOptimizer.hpp>
 
 namespace {
     //窗口比例
@@ -87,6 +95,26 @@ namespace renderer {
          * Test case 8: Rendering a polyhedron.
          */
          static void test08();
+
+        /**
+         * Test case 9: Rendering dense box architecture with both BVH and kd-tree, comparing render time.
+         */
+        static void test09();
+
+        /**
+         * Test case 10: Rendering randomly rotated boxes with AABB only and with OBB / k-DOP selection, comparing render time.
+         */
+        static void test10();
+
+        /**
+         * Test case 11: Optimizing a BVH with rays recorded from a low sample pre-render, comparing render time before and after.
+         */
+        static void test11();
+
+        /**
+         * Test case 12: Rendering a large random sphere field as lazily expanded procedural tiles sharing one bounded cache.
+         */
+        static void test12();
     };
 }
 
@@ -15,6 +15,7 @@
 #include <stdexcept>
 
 #include <mylibrary/lib_sdl.hpp>
+#include <Real.hpp>
 
 #ifdef INFINITY
 #undef INFINITY
@@ -59,10 +60,18 @@ namespace renderer {
         return std::abs(val) < FLOAT_VALUE_ZERO_EPSILON;
     }
 
+    inline bool floatValueNearZero(float val) {
+        return std::abs(val) < static_cast<float>(FLOAT_VALUE_ZERO_EPSILON);
+    }
+
     //判断两个浮点数是否相等
     inline bool floatValueEquals(double v1, double v2) {
         return std::abs(v1 - v2) < FLOAT_VALUE_ZERO_EPSILON;
     }
+
+    inline bool floatValueEquals(float v1, float v2) {
+        return std::abs(v1 - v2) < static_cast<float>(FLOAT_VALUE_ZERO_EPSILON);
+    }
 }
 
 #endif //RENDERERTEST_GLOBAL_HPP
@@ -0,0 +1,19 @@
+#ifndef RENDERERTEST_REAL_HPP
+#define RENDERERTEST_REAL_HPP
+
+namespace renderer {
+    /*
+     * 渲染管线的标量类型：向量、点、颜色、区间、光线、包围盒和几何体都使用Real
+     * 定义RENDERER_USE_FLOAT时使用float，内存占用和带宽减半，每条SIMD指令处理的分量加倍
+     * 默认使用double，坐标范围很大的场景需要double的精度。矩阵变换等需要高精度的部分始终使用double
+     *
+     * 单独定义在此文件中，使用特定指令集编译的计算核源文件不需要包含Global.hpp
+     */
+#ifdef RENDERER_USE_FLOAT
+    using Real = float;
+#else
+    using Real = double;
+#endif
+}
+
+#endif //RENDERERTEST_REAL_HPP
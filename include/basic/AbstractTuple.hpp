@@ -2,41 +2,32 @@
 #define RENDERERTEST_ABSTRACTTUPLE_HPP
 
 #include <AbstractObject.hpp>
+#include <type_traits>
 
 namespace renderer {
     /*
-     * 三元素对象抽象类，数组元素类型自定义
+     * 三元素对象基类，数组元素类型自定义
+     *
+     * 三元组为热路径上的值类型，每次求交、散射和PDF计算都会构造和拷贝大量三元组
+     * 因此不继承AbstractObject：没有虚函数表指针，可平凡拷贝，标准布局，可以直接memcpy和向量化
+     * 比较和转换为字符串由各个子类文件中的非成员函数equals、toString和比较运算符提供
      */
     template <typename T>
-    class AbstractTuple : public AbstractObject {
+    class AbstractTuple {
     protected:
         T elements[3];
 
-    public:
-        explicit AbstractTuple(const T & e1, const T & e2, const T & e3) {
-            elements[0] = e1; elements[1] = e2; elements[2] = e3;
-        }
-
-        explicit AbstractTuple(const T elements[3]) {
-            memcpy(this->elements, elements, 3 * sizeof(T));
-        }
+        constexpr AbstractTuple(const T & e1, const T & e2, const T & e3) : elements{e1, e2, e3} {}
 
-        ~AbstractTuple() override = default;
-
-        bool equals(const AbstractObject & obj) const override {
-            if (this == &obj)  return true;
-            //向下转型
-            const auto * tuple = dynamic_cast<const AbstractTuple*>(&obj);
-            if (tuple == null) return false; //类型不匹配
-            return elements[0] == tuple->elements[0] && elements[1] == tuple->elements[1] && elements[2] == tuple->elements[2];
-        }
+        explicit constexpr AbstractTuple(const T elements[3]) : elements{elements[0], elements[1], elements[2]} {}
 
+    public:
         //通过下标访问elements数组，省略下标检查
-        T operator[](size_t index) const {
+        constexpr T operator[](size_t index) const {
             return elements[index];
         }
 
-        T & operator[](size_t index) {
+        constexpr T & operator[](size_t index) {
             return elements[index];
         }
     };
@@ -16,101 +16,103 @@ namespace renderer {
      *
      * 写入方法：将当前颜色写入到屏幕指定位置处(对象方法)
      */
-    class Color3 final : public AbstractTuple<double> {
-    public:
-        explicit Color3(double r = 0.0, double g = 0.0, double b = 0.0)
-            : AbstractTuple(r, g, b) {}
+    template <typename T>
+    class Color3T final : public AbstractTuple<T> {
+    private:
+        using AbstractTuple<T>::elements;
 
-        ~Color3() override = default;
+    public:
+        explicit constexpr Color3T(T r = 0.0, T g = 0.0, T b = 0.0)
+            : AbstractTuple<T>(r, g, b) {}
 
         // ====== 对象操作函数 ======
 
         //不进行范围校验，只在写入时裁切范围
-        Color3 & operator+=(const Color3 & obj) {
+        constexpr Color3T & operator+=(const Color3T & obj) {
             for (size_t i = 0; i < 3; i++) {
                 elements[i] += obj.elements[i];
             }
             return *this;
         }
 
-        Color3 operator+(const Color3 & obj) const {
-            Color3 ret(*this); ret += obj; return ret;
+        constexpr Color3T operator+(const Color3T & obj) const {
+            Color3T ret(*this); ret += obj; return ret;
         }
 
-        Color3 & operator-=(const Color3 & obj) {
+        constexpr Color3T & operator-=(const Color3T & obj) {
             for (size_t i = 0; i < 3; i++) {
                 elements[i] -= obj.elements[i];
             }
             return *this;
         }
 
-        Color3 operator-(const Color3 & obj) const {
-            Color3 ret(*this); ret -= obj; return ret;
+        constexpr Color3T operator-(const Color3T & obj) const {
+            Color3T ret(*this); ret -= obj; return ret;
         }
 
-        Color3 & operator*=(double num) {
-            for (double & element : elements) {
+        constexpr Color3T & operator*=(T num) {
+            for (T & element : elements) {
                 element *= num;
             }
             return *this;
         }
 
-        Color3 operator*(double num) const {
-            Color3 ret(*this); ret *= num; return ret;
+        constexpr Color3T operator*(T num) const {
+            Color3T ret(*this); ret *= num; return ret;
         }
 
-        Color3 & operator/=(double num) {
-            for (double & element : elements) {
+        constexpr Color3T & operator/=(T num) {
+            for (T & element : elements) {
                 element /= num;
             }
             return *this;
         }
 
-        Color3 operator/(double num) const {
-            Color3 ret(*this); ret /= num; return ret;
+        constexpr Color3T operator/(T num) const {
+            Color3T ret(*this); ret /= num; return ret;
         }
 
-        Color3 & operator*=(const Color3 & obj) {
+        constexpr Color3T & operator*=(const Color3T & obj) {
             for (size_t i = 0; i < 3; i++) {
                 elements[i] *= obj.elements[i];
             }
             return *this;
         }
 
-        Color3 operator*(const Color3 & obj) const {
-            Color3 ret(*this); ret *= obj; return ret;
+        constexpr Color3T operator*(const Color3T & obj) const {
+            Color3T ret(*this); ret *= obj; return ret;
         }
 
-        Color3 & operator/=(const Color3 & obj) {
+        constexpr Color3T & operator/=(const Color3T & obj) {
             for (size_t i = 0; i < 3; i++) {
                 elements[i] /= obj.elements[i];
             }
             return *this;
         }
 
-        Color3 operator/(const Color3 & obj) const {
-            Color3 ret(*this); ret /= obj; return ret;
+        constexpr Color3T operator/(const Color3T & obj) const {
+            Color3T ret(*this); ret /= obj; return ret;
         }
 
         //数乘除允许左操作数为实数
-        friend Color3 operator*(double num, const Color3 & obj) {
+        friend constexpr Color3T operator*(T num, const Color3T & obj) {
             return obj * num;
         }
 
-        friend Color3 operator/(double num, const Color3 & obj) {
+        friend constexpr Color3T operator/(T num, const Color3T & obj) {
             return obj / num;
         }
 
         //颜色写入函数
-        void writeColor(Uint32 * pixelPointer, const SDL_PixelFormat * format, double gamma = 2.0) const {
+        void writeColor(Uint32 * pixelPointer, const SDL_PixelFormat * format, T gamma = 2.0) const {
             //进行伽马校正
-            const double power = 1.0 / gamma;
-            const double r = std::pow(elements[0], power);
-            const double g = std::pow(elements[1], power);
-            const double b = std::pow(elements[2], power);
+            const T power = 1.0 / gamma;
+            const T r = std::pow(elements[0], power);
+            const T g = std::pow(elements[1], power);
+            const T b = std::pow(elements[2], power);
 
             //将[0.0, 1.0]的颜色值映射到[0, 255]并写入
-            const Range intensity(0.0, 0.999);
+            const RangeT<T> intensity(0.0, 0.999);
             const auto r_byte = static_cast<Uint8>(256 * intensity.clamp(r));
             const auto g_byte = static_cast<Uint8>(256 * intensity.clamp(g));
             const auto b_byte = static_cast<Uint8>(256 * intensity.clamp(b));
@@ -121,18 +123,42 @@ namespace renderer {
         // ====== 静态操作函数 ======
 
         //生成随机颜色
-        static Color3 randomColor(double min = 0.0, double max = 1.0) {
-            return Color3(randomDouble(min, max), randomDouble(min, max), randomDouble(min, max));
+        static Color3T randomColor(T min = 0.0, T max = 1.0) {
+            return Color3T(randomDouble(min, max), randomDouble(min, max), randomDouble(min, max));
         }
+    };
 
-        // ====== 类封装函数 ======
+    //渲染管线使用的颜色类型，精度由Real决定
+    using Color3 = Color3T<Real>;
+    using Color3f = Color3T<float>;
+    using Color3d = Color3T<double>;
 
-        std::string toString() const override {
-            char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
-            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Color3: (%.2lf, %.2lf, %.2lf)", elements[0], elements[1], elements[2]);
-            return {buffer};
-        }
-    };
+    static_assert(std::is_trivially_copyable<Color3>::value && std::is_standard_layout<Color3>::value, "Color3 must be a plain value type");
+
+    // ====== 非成员函数 ======
+
+    template <typename T>
+    constexpr bool equals(const Color3T<T> & c1, const Color3T<T> & c2) {
+        return c1[0] == c2[0] && c1[1] == c2[1] && c1[2] == c2[2];
+    }
+
+    template <typename T>
+    constexpr bool operator==(const Color3T<T> & c1, const Color3T<T> & c2) { return equals(c1, c2); }
+
+    template <typename T>
+    constexpr bool operator!=(const Color3T<T> & c1, const Color3T<T> & c2) { return !equals(c1, c2); }
+
+    template <typename T>
+    inline std::string toString(const Color3T<T> & obj) {
+        char buffer[AbstractObject::TOSTRING_BUFFER_SIZE] = { 0 };
+        snprintf(buffer, AbstractObject::TOSTRING_BUFFER_SIZE, "Color3: (%.2lf, %.2lf, %.2lf)", obj[0], obj[1], obj[2]);
+        return {buffer};
+    }
+
+    template <typename T>
+    inline std::ostream & operator<<(std::ostream & os, const Color3T<T> & obj) {
+        return os << toString(obj);
+    }
 }
 
 #endif //COLOR3_HPP
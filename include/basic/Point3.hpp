@@ -13,82 +13,108 @@ namespace renderer {
      * 点加减向量(点偏移) (对象)
      * 点转向量(对象)，向量转点(构造方法)
      */
-    class Point3 final : public AbstractTuple<double> {
-    public:
-        explicit Point3(double x = 0.0, double y = 0.0, double z = 0.0)
-                    : AbstractTuple(x, y, z) {}
+    template <typename T>
+    class Point3T final : public AbstractTuple<T> {
+    private:
+        using AbstractTuple<T>::elements;
 
-        explicit Point3(const Vec3 & obj) : AbstractTuple(obj[0], obj[1], obj[2]) {}
+    public:
+        explicit constexpr Point3T(T x = 0.0, T y = 0.0, T z = 0.0)
+                    : AbstractTuple<T>(x, y, z) {}
 
-        ~Point3() override = default;
+        explicit constexpr Point3T(const Vec3T<T> & obj) : AbstractTuple<T>(obj[0], obj[1], obj[2]) {}
 
         // ====== 对象操作函数 ======
 
-        double distanceSquare(const Point3 & anotherPoint) const {
-            double sum = 0.0;
+        constexpr T distanceSquare(const Point3T & anotherPoint) const {
+            T sum = 0.0;
             for (size_t i = 0; i < 3; i++) {
                 sum += (elements[i] - anotherPoint.elements[i]) * (elements[i] - anotherPoint.elements[i]);
             }
             return sum;
         }
 
-        double distance(const Point3 & anotherPoint) const {
+        T distance(const Point3T & anotherPoint) const {
             return std::sqrt(distanceSquare(anotherPoint));
         }
 
-        Point3 & operator+=(const Vec3 & offset) {
+        constexpr Point3T & operator+=(const Vec3T<T> & offset) {
             for (size_t i = 0; i < 3; i++) {
                 elements[i] += offset[i];
             }
             return *this;
         }
 
-        Point3 operator+(const Vec3 & offset) const {
-            Point3 ret(*this); ret += offset; return ret;
+        constexpr Point3T operator+(const Vec3T<T> & offset) const {
+            Point3T ret(*this); ret += offset; return ret;
         }
 
-        Point3 & operator-=(const Vec3 & offset) {
+        constexpr Point3T & operator-=(const Vec3T<T> & offset) {
             for (size_t i = 0; i < 3; i++) {
                 elements[i] -= offset[i];
             }
             return *this;
         }
 
-        Point3 operator-(const Vec3 & offset) const {
-            Point3 ret(*this); ret -= offset; return ret;
+        constexpr Point3T operator-(const Vec3T<T> & offset) const {
+            Point3T ret(*this); ret -= offset; return ret;
         }
 
         //点转向量
-        Vec3 toVector() const  {
-            return Vec3(elements[0], elements[1], elements[2]);
+        constexpr Vec3T<T> toVector() const {
+            return Vec3T<T>(elements[0], elements[1], elements[2]);
         }
 
         // ====== 静态操作函数 ======
 
-        static inline double distanceSquare(const Point3 & p1, const Point3 & p2) {
+        static constexpr T distanceSquare(const Point3T & p1, const Point3T & p2) {
             return p1.distanceSquare(p2);
         }
 
-        static inline double distance(const Point3 & p1, const Point3 & p2) {
+        static inline T distance(const Point3T & p1, const Point3T & p2) {
             return std::sqrt(p1.distanceSquare(p2));
         }
 
-        static inline Vec3 constructVector(const Point3 & from, const Point3 & to) {
-            Vec3 ret;
+        static constexpr Vec3T<T> constructVector(const Point3T & from, const Point3T & to) {
+            Vec3T<T> ret;
             for (size_t i = 0; i < 3; i++) {
                 ret[i] = to.elements[i] - from.elements[i];
             }
             return ret;
         }
+    };
 
-        // ====== 类封装函数 ======
+    //渲染管线使用的点类型，精度由Real决定
+    using Point3 = Point3T<Real>;
+    using Point3f = Point3T<float>;
+    using Point3d = Point3T<double>;
 
-        std::string toString() const override {
-            char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
-            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Point3: (%.4lf, %.4lf, %.4lf)", elements[0], elements[1], elements[2]);
-            return {buffer};
-        }
-    };
+    static_assert(std::is_trivially_copyable<Point3>::value && std::is_standard_layout<Point3>::value, "Point3 must be a plain value type");
+
+    // ====== 非成员函数 ======
+
+    template <typename T>
+    constexpr bool equals(const Point3T<T> & p1, const Point3T<T> & p2) {
+        return p1[0] == p2[0] && p1[1] == p2[1] && p1[2] == p2[2];
+    }
+
+    template <typename T>
+    constexpr bool operator==(const Point3T<T> & p1, const Point3T<T> & p2) { return equals(p1, p2); }
+
+    template <typename T>
+    constexpr bool operator!=(const Point3T<T> & p1, const Point3T<T> & p2) { return !equals(p1, p2); }
+
+    template <typename T>
+    inline std::string toString(const Point3T<T> & obj) {
+        char buffer[AbstractObject::TOSTRING_BUFFER_SIZE] = { 0 };
+        snprintf(buffer, AbstractObject::TOSTRING_BUFFER_SIZE, "Point3: (%.4lf, %.4lf, %.4lf)", obj[0], obj[1], obj[2]);
+        return {buffer};
+    }
+
+    template <typename T>
+    inline std::ostream & operator<<(std::ostream & os, const Point3T<T> & obj) {
+        return os << toString(obj);
+    }
 }
 
 #endif //POINT3_HPP
@@ -8,47 +8,85 @@ namespace renderer {
      * 光线类。P(t) = A + tB，A为光线的起点，t为实数，B为光线的方向向量，一般为单位向量
      *
      * at(t)：获取光线在参数为t的空间位置（一个点）
+     *
+     * 值类型，不继承AbstractObject，起点和方向以引用返回，避免每次访问都拷贝
+     *
+     * 构造和修改方向时预计算方向的倒数和每个分量的符号，包围盒测试不需要除法，按符号直接选出进入和离开的边界
+     * 方向分量为±0时倒数为±INFINITY，符号由倒数判断，-0.0视为负方向
      */
-    class Ray final : public AbstractObject {
+    template <typename T>
+    class RayT final {
     private:
-        Point3 origin;
-        Vec3 direction;
-        double time; //光线被发射出的时间
+        Point3T<T> origin;
+        Vec3T<T> direction;
+        Vec3T<T> inverseDirection;
+        T time; //光线被发射出的时间
+        bool isNegative[3];
+
+        constexpr void updateInverseDirection() {
+            for (size_t i = 0; i < 3; i++) {
+                inverseDirection[i] = 1 / direction[i];
+                isNegative[i] = inverseDirection[i] < 0;
+            }
+        }
 
     public:
-        explicit Ray(const Point3 & origin = Point3(), const Vec3 & direction = Vec3(1.0, 0.0, 0.0), double time = 0.0) :
-            origin(origin), direction(direction), time(time) {}
-        ~Ray() override = default;
+        explicit constexpr RayT(const Point3T<T> & origin = Point3T<T>(), const Vec3T<T> & direction = Vec3T<T>(1.0, 0.0, 0.0), T time = 0.0) :
+            origin(origin), direction(direction), inverseDirection(), time(time), isNegative()
+        {
+            updateInverseDirection();
+        }
 
         // ====== 对象操作函数 ======
 
-        Point3 at(double t) const {
+        constexpr Point3T<T> at(T t) const {
             return origin + t * direction;
         }
 
         // ====== 类封装函数 ======
 
-        bool equals(const AbstractObject& obj) const override {
-            if (this == &obj) return true;
-            const auto * ray = dynamic_cast<const Ray *>(&obj);
-            if (ray == null) return false;
-            return origin == ray->origin && direction == ray->direction && time == ray->time;
-        }
+        constexpr const Point3T<T> & getOrigin() const { return origin; }
+        constexpr void setOrigin(const Point3T<T>& _origin) { this->origin = _origin; }
+        constexpr const Vec3T<T> & getDirection() const { return direction; }
+        constexpr void setDirection(const Vec3T<T>& _direction) { this->direction = _direction; updateInverseDirection(); }
+        constexpr const Vec3T<T> & getInverseDirection() const { return inverseDirection; }
+        constexpr bool isDirectionNegative(size_t axis) const { return isNegative[axis]; }
+        constexpr T getTime() const { return time; }
+        constexpr void setTime(T _time) {this->time = _time; }
+    };
 
-        std::string toString() const override {
-            char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
-            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Ray: Time = %.4lf, Origin = (%.4lf, %.4lf, %.4lf), Direction = (%.4lf, %.4lf, %.4lf)",
-                time, origin[0], origin[1], origin[2], direction[0], direction[1], direction[2]);
-            return {buffer};
-        }
+    //渲染管线使用的光线类型，精度由Real决定
+    using Ray = RayT<Real>;
+    using Rayd = RayT<double>;
 
-        Point3 getOrigin() const { return origin; }
-        void setOrigin(const Point3& _origin) { this->origin = _origin; }
-        Vec3 getDirection() const { return direction; }
-        void setDirection(const Vec3& _direction) { this->direction = _direction; }
-        double getTime() const { return time; }
-        void setTime(double _time) {this->time = _time; }
-    };
+    static_assert(std::is_trivially_copyable<Ray>::value && std::is_standard_layout<Ray>::value, "Ray must be a plain value type");
+
+    // ====== 非成员函数 ======
+
+    template <typename T>
+    constexpr bool equals(const RayT<T> & r1, const RayT<T> & r2) {
+        return r1.getOrigin() == r2.getOrigin() && r1.getDirection() == r2.getDirection() && r1.getTime() == r2.getTime();
+    }
+
+    template <typename T>
+    constexpr bool operator==(const RayT<T> & r1, const RayT<T> & r2) { return equals(r1, r2); }
+
+    template <typename T>
+    constexpr bool operator!=(const RayT<T> & r1, const RayT<T> & r2) { return !equals(r1, r2); }
+
+    template <typename T>
+    inline std::string toString(const RayT<T> & obj) {
+        char buffer[AbstractObject::TOSTRING_BUFFER_SIZE] = { 0 };
+        snprintf(buffer, AbstractObject::TOSTRING_BUFFER_SIZE, "Ray: Time = %.4lf, Origin = (%.4lf, %.4lf, %.4lf), Direction = (%.4lf, %.4lf, %.4lf)",
+                 obj.getTime(), obj.getOrigin()[0], obj.getOrigin()[1], obj.getOrigin()[2],
+                 obj.getDirection()[0], obj.getDirection()[1], obj.getDirection()[2]);
+        return {buffer};
+    }
+
+    template <typename T>
+    inline std::ostream & operator<<(std::ostream & os, const RayT<T> & obj) {
+        return os << toString(obj);
+    }
 }
 
 #endif //RAY_HPP
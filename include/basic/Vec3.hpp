@@ -21,133 +21,135 @@ namespace renderer {
      * 随机生成函数：
      * 生成模长不大于指定范围的平面向量（z = 0）
      */
-    class Vec3 final : public AbstractTuple<double> {
-    public:
-        static constexpr double VECTOR_LENGTH_SQUARE_ZERO_EPSILON = FLOAT_VALUE_ZERO_EPSILON * FLOAT_VALUE_ZERO_EPSILON;
+    template <typename T>
+    class Vec3T final : public AbstractTuple<T> {
+    private:
+        using AbstractTuple<T>::elements;
 
-        explicit Vec3(double x = 0.0, double y = 0.0, double z = 0.0)
-            : AbstractTuple(x, y, z) {}
+    public:
+        static constexpr T VECTOR_LENGTH_SQUARE_ZERO_EPSILON = FLOAT_VALUE_ZERO_EPSILON * FLOAT_VALUE_ZERO_EPSILON;
 
-        ~Vec3() override = default;
+        explicit constexpr Vec3T(T x = 0.0, T y = 0.0, T z = 0.0)
+            : AbstractTuple<T>(x, y, z) {}
 
         // ====== 对象操作函数 ======
 
-        Vec3 operator-() const {
-            return Vec3(-elements[0], -elements[1], -elements[2]);
+        constexpr Vec3T operator-() const {
+            return Vec3T(-elements[0], -elements[1], -elements[2]);
         }
 
-        Vec3 & negate() {
-            for (double & element : elements) {
+        constexpr Vec3T & negate() {
+            for (T & element : elements) {
                 element = -element;
             }
             return *this;
         }
 
-        Vec3 & operator+=(const Vec3 & obj) {
+        constexpr Vec3T & operator+=(const Vec3T & obj) {
             for (size_t i = 0; i < 3; i++) {
                 elements[i] += obj.elements[i];
             }
             return *this;
         }
 
-        Vec3 operator+(const Vec3 & obj) const {
-            Vec3 ret(*this); ret += obj; return ret;
+        constexpr Vec3T operator+(const Vec3T & obj) const {
+            Vec3T ret(*this); ret += obj; return ret;
         }
 
-        Vec3 & operator-=(const Vec3 & obj) {
+        constexpr Vec3T & operator-=(const Vec3T & obj) {
             for (size_t i = 0; i < 3; i++) {
                 elements[i] -= obj.elements[i];
             }
             return *this;
         }
 
-        Vec3 operator-(const Vec3 & obj) const {
-            Vec3 ret(*this); ret -= obj; return ret;
+        constexpr Vec3T operator-(const Vec3T & obj) const {
+            Vec3T ret(*this); ret -= obj; return ret;
         }
 
-        Vec3 & operator*=(double num) {
-            for (double & element : elements) {
+        constexpr Vec3T & operator*=(T num) {
+            for (T & element : elements) {
                 element *= num;
             }
             return *this;
         }
 
-        Vec3 operator*(double num) const {
-            Vec3 ret(*this); ret *= num; return ret;
+        constexpr Vec3T operator*(T num) const {
+            Vec3T ret(*this); ret *= num; return ret;
         }
 
-        Vec3 & operator/=(double num) {
-            for (double & element : elements) {
+        constexpr Vec3T & operator/=(T num) {
+            for (T & element : elements) {
                 element /= num;
             }
             return *this;
         }
 
-        Vec3 operator/(double num) const {
-            Vec3 ret(*this); ret /= num; return ret;
+        constexpr Vec3T operator/(T num) const {
+            Vec3T ret(*this); ret /= num; return ret;
         }
 
         //数乘除操作允许左操作数为实数
 
-        friend Vec3 & operator*=(double num, Vec3 & obj) {
+        friend constexpr Vec3T & operator*=(T num, Vec3T & obj) {
             return obj *= num;
         }
 
-        friend Vec3 & operator/=(double num, Vec3 & obj) {
+        friend constexpr Vec3T & operator/=(T num, Vec3T & obj) {
             return obj /= num;
         }
 
-        friend Vec3 operator*(double num, const Vec3 & obj) {
-            Vec3 ret(obj); ret *= num; return ret;
+        friend constexpr Vec3T operator*(T num, const Vec3T & obj) {
+            Vec3T ret(obj); ret *= num; return ret;
         }
 
-        friend Vec3 operator/(double num, const Vec3 & obj) {
-            Vec3 ret(obj); ret /= num; return ret;
+        friend constexpr Vec3T operator/(T num, const Vec3T & obj) {
+            Vec3T ret(obj); ret /= num; return ret;
         }
 
-        double lengthSquare() const {
-            double sum = 0.0;
-            for (const double & element : elements) {
+        constexpr T lengthSquare() const {
+            T sum = 0.0;
+            for (const T & element : elements) {
                 sum += element * element;
             }
             return sum;
         }
 
-        double length() const {
+        T length() const {
             return std::sqrt(lengthSquare());
         }
 
-        double dot(const Vec3 & obj) const {
-            double sum = 0.0;
+        constexpr T dot(const Vec3T & obj) const {
+            T sum = 0.0;
             for (size_t i = 0; i < 3; i++) {
                 sum += elements[i] * obj.elements[i];
             }
             return sum;
         }
 
-        Vec3 cross(const Vec3 & obj) const {
-            return Vec3(elements[1] * obj.elements[2] - elements[2] * obj.elements[1],
+        constexpr Vec3T cross(const Vec3T & obj) const {
+            return Vec3T(elements[1] * obj.elements[2] - elements[2] * obj.elements[1],
                         elements[2] * obj.elements[0] - elements[0] * obj.elements[2],
                         elements[0] * obj.elements[1] - elements[1] * obj.elements[0]);
         }
 
-        Vec3 & unitize() {
-            const double len = length();
-            for (double & element : elements) {
+        Vec3T & unitize() {
+            const T len = length();
+            for (T & element : elements) {
                 element /= len;
             }
             return *this;
         }
 
-        Vec3 unitVector() const {
-            Vec3 ret(*this); ret.unitize(); return ret;
+        Vec3T unitVector() const {
+            Vec3T ret(*this); ret.unitize(); return ret;
         }
 
         // ====== 静态操作函数 ======
 
         //生成遵守按指定轴余弦分布的随机向量，非单位向量（Integration::randomCosinePointsOnUnitSphere）
-        static inline Vec3 randomCosineVector(int axis, bool toPositive) {
-            double coord[3];
+        static inline Vec3T randomCosineVector(int axis, bool toPositive) {
+            T coord[3];
             const auto r1 = randomDouble();
             const auto r2 = randomDouble();
 
@@ -170,28 +172,28 @@ namespace renderer {
             if (!toPositive) {
                 coord[axis] = -coord[axis];
             }
-            return Vec3(coord[0], coord[1], coord[2]);
+            return Vec3T(coord[0], coord[1], coord[2]);
         }
 
         //生成每个分量都在指定范围内的随机向量
-        static inline Vec3 randomVector(double componentMin, double componentMax) {
-            return Vec3(randomDouble(componentMin, componentMax), randomDouble(componentMin, componentMax), randomDouble(componentMin, componentMax));
+        static inline Vec3T randomVector(T componentMin, T componentMax) {
+            return Vec3T(randomDouble(componentMin, componentMax), randomDouble(componentMin, componentMax), randomDouble(componentMin, componentMax));
         }
 
         //生成平面（x，y，0）上模长不大于maxLength的向量
-        static inline Vec3 randomPlaneVector(double maxLength) {
-            double x, y;
+        static inline Vec3T randomPlaneVector(T maxLength) {
+            T x, y;
             do {
                 x = randomDouble(-1.0, 1.0);
                 y = randomDouble(-1.0, 1.0);
             } while (x * x + y * y > maxLength * maxLength);
-            return Vec3(x, y, 0.0);
+            return Vec3T(x, y, 0.0);
         }
 
         //生成模长为length的空间向量
-        static inline Vec3 randomSpaceVector(double length) {
-            Vec3 ret;
-            double lengthSquare;
+        static inline Vec3T randomSpaceVector(T length) {
+            Vec3T ret;
+            T lengthSquare;
             //先生成单位向量，再缩放到指定模长
             do {
                 for (size_t i = 0; i < 3; i++) {
@@ -205,55 +207,79 @@ namespace renderer {
             return ret * length;
         }
 
-        static inline Vec3 negativeVector(const Vec3 & obj) {
+        static constexpr Vec3T negativeVector(const Vec3T & obj) {
             return -obj;
         }
 
-        static inline Vec3 add(const Vec3 & v1, const Vec3 & v2) {
+        static constexpr Vec3T add(const Vec3T & v1, const Vec3T & v2) {
             return v1 + v2;
         }
 
-        static inline Vec3 subtract(const Vec3 & origin, const Vec3 & sub) {
+        static constexpr Vec3T subtract(const Vec3T & origin, const Vec3T & sub) {
             return origin - sub;
         }
 
-        static inline Vec3 multiply(const Vec3 & obj, double num) {
+        static constexpr Vec3T multiply(const Vec3T & obj, T num) {
             return obj * num;
         }
 
-        static inline Vec3 divide(const Vec3 & origin, double num) {
+        static constexpr Vec3T divide(const Vec3T & origin, T num) {
             return origin / num;
         }
 
-        static inline double lengthSquare(const Vec3 & obj) {
+        static constexpr T lengthSquare(const Vec3T & obj) {
             return obj.lengthSquare();
         }
 
-        static inline double length(const Vec3 & obj) {
+        static inline T length(const Vec3T & obj) {
             return obj.length();
         }
 
-        static inline double dot(const Vec3 & v1, const Vec3 & v2) {
+        static constexpr T dot(const Vec3T & v1, const Vec3T & v2) {
             return v1.dot(v2);
         }
 
         //v1 x v2
-        static inline Vec3 cross(const Vec3 & v1, const Vec3 & v2) {
+        static constexpr Vec3T cross(const Vec3T & v1, const Vec3T & v2) {
             return v1.cross(v2);
         }
 
-        static inline Vec3 unitVector(const Vec3 & obj) {
+        static inline Vec3T unitVector(const Vec3T & obj) {
             return obj.unitVector();
         }
+    };
 
-        // ====== 类封装函数 ======
+    //渲染管线使用的向量类型，精度由Real决定
+    using Vec3 = Vec3T<Real>;
+    using Vec3f = Vec3T<float>;
+    using Vec3d = Vec3T<double>;
 
-        std::string toString() const override {
-            char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
-            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Vec3: (%.4lf, %.4lf, %.4lf)", elements[0], elements[1], elements[2]);
-            return {buffer};
-        }
-    };
+    static_assert(std::is_trivially_copyable<Vec3>::value && std::is_standard_layout<Vec3>::value, "Vec3 must be a plain value type");
+
+    // ====== 非成员函数 ======
+
+    template <typename T>
+    constexpr bool equals(const Vec3T<T> & v1, const Vec3T<T> & v2) {
+        return v1[0] == v2[0] && v1[1] == v2[1] && v1[2] == v2[2];
+    }
+
+    template <typename T>
+    constexpr bool operator==(const Vec3T<T> & v1, const Vec3T<T> & v2) { return equals(v1, v2); }
+
+    template <typename T>
+    constexpr bool operator!=(const Vec3T<T> & v1, const Vec3T<T> & v2) { return !equals(v1, v2); }
+
+    template <typename T>
+    inline std::string toString(const Vec3T<T> & obj) {
+        char buffer[AbstractObject::TOSTRING_BUFFER_SIZE] = { 0 };
+        snprintf(buffer, AbstractObject::TOSTRING_BUFFER_SIZE, "Vec3: (%.4lf, %.4lf, %.4lf)", obj[0], obj[1], obj[2]);
+        return {buffer};
+    }
+
+    template <typename T>
+    inline std::ostream & operator<<(std::ostream & os, const Vec3T<T> & obj) {
+        return os << toString(obj);
+    }
 }
 
 #endif //RENDERERTEST_VEC3_HPP
\ No newline at end of file
@@ -3,7 +3,7 @@
 
 #include <basic/Ray.hpp>
 #include <util/Range.hpp>
-#include <util/Matrix.hpp>
+#include <util/AffineTransform.hpp>
 
 namespace renderer {
     /*
@@ -30,7 +30,20 @@ namespace renderer {
         virtual int longestAxis() const = 0;
 
         //使用矩阵变换当前包围盒
-        virtual std::shared_ptr<AbstractBoundingBox> transformBoundingBox(const Matrix & matrix) = 0;
+        virtual std::shared_ptr<AbstractBoundingBox> transformBoundingBox(const AffineTransform & matrix) = 0;
+
+        //包围盒在方向direction上的投影区间：[min(direction · P), max(direction · P)]，P取遍包围盒内所有点
+        //不同类型的包围盒通过投影区间互相合并，direction不要求是单位向量
+        virtual Range project(const Vec3 & direction) const = 0;
+
+        //包围盒的所有顶点，用于变换包围盒和在不同类型之间转换
+        virtual std::vector<Point3> vertices() const = 0;
+
+        //表面积：光线击中凸包围盒的概率和其表面积成正比，用于比较不同包围盒的紧密程度
+        virtual Real surfaceArea() const = 0;
+
+        //一次hit测试的相对开销，轴对齐包围盒为1
+        virtual double hitCost() const = 0;
     };
 }
 
@@ -14,7 +14,7 @@ namespace renderer {
 
         //确保包围盒体积有效
         void ensureVolume() {
-            constexpr double EPSILON = 0.0005;
+            constexpr Real EPSILON = 0.0005;
             for (auto & i : range) {
                 if (i.length() < EPSILON) {
                     i.expand(EPSILON);
@@ -50,39 +50,69 @@ namespace renderer {
 
         bool hit(const Ray & ray, const Range & checkRange) const override {
             const Point3 & rayOrigin = ray.getOrigin();
-            const Vec3 & rayDirection = ray.getDirection();
-
-            Range currentRange(checkRange);
-            for (Uint32 axis = 0; axis < 3; axis++) {
-                const Range & axisRange = range[axis];
-                const double q = rayOrigin[axis];
-                const double d = rayDirection[axis];
-
-                //计算光在当前轴和边界的两个交点
-                const double t1 = (axisRange.getMin() - q) / d;
-                const double t2 = (axisRange.getMax() - q) / d;
-
-                //将currentRange限制到这两个交点的范围内
-                if (t1 < t2) {
-                    if (t1 > currentRange.getMin()) currentRange.setMin(t1);
-                    if (t2 < currentRange.getMax()) currentRange.setMax(t2);
-                } else {
-                    if (t2 > currentRange.getMin()) currentRange.setMin(t2);
-                    if (t1 < currentRange.getMax()) currentRange.setMax(t1);
-                }
-
-                if (!currentRange.isValid()) {
-                    return false;
-                }
+            const Vec3 & inverseDirection = ray.getInverseDirection();
+
+            Real tEnter = checkRange.getMin();
+            Real tExit = checkRange.getMax();
+            for (size_t axis = 0; axis < 3; axis++) {
+                //方向为负时光线从最大值一侧进入，使用预计算的符号选择边界，不需要比较两个交点
+                const bool isNegative = ray.isDirectionNegative(axis);
+                const Real near = ((isNegative ? range[axis].getMax() : range[axis].getMin()) - rayOrigin[axis]) * inverseDirection[axis];
+                const Real far = ((isNegative ? range[axis].getMin() : range[axis].getMax()) - rayOrigin[axis]) * inverseDirection[axis];
+
+                //光线平行于当前轴且起点恰好在边界上时为0 * INFINITY = NaN，比较结果为false，保持原值，视为在slab内
+                tEnter = near > tEnter ? near : tEnter;
+                tExit = far < tExit ? far : tExit;
             }
-            return true;
+            return tEnter <= tExit;
         }
 
         std::shared_ptr<AbstractBoundingBox> merge(const std::shared_ptr<AbstractBoundingBox> &box) const override {
             const auto _box = std::dynamic_pointer_cast<AxisAlignedBoundingBox>(box);
-            return std::make_shared<AxisAlignedBoundingBox>(*this, *_box);
+            if (_box) {
+                return std::make_shared<AxisAlignedBoundingBox>(*this, *_box);
+            }
+
+            //其他类型的包围盒，使用其在三个坐标轴上的投影区间合并
+            return std::make_shared<AxisAlignedBoundingBox>(
+                    Range(range[0], box->project(Vec3(1.0, 0.0, 0.0))),
+                    Range(range[1], box->project(Vec3(0.0, 1.0, 0.0))),
+                    Range(range[2], box->project(Vec3(0.0, 0.0, 1.0))));
         }
 
+        Range project(const Vec3 & direction) const override {
+            //每个分量取使点积最小和最大的端点，分量为0的轴不参与计算，避免0 * INFINITY
+            Real min = 0.0, max = 0.0;
+            for (size_t i = 0; i < 3; i++) {
+                if (direction[i] > 0.0) {
+                    min += direction[i] * range[i].getMin();
+                    max += direction[i] * range[i].getMax();
+                } else if (direction[i] < 0.0) {
+                    min += direction[i] * range[i].getMax();
+                    max += direction[i] * range[i].getMin();
+                }
+            }
+            return Range(min, max);
+        }
+
+        std::vector<Point3> vertices() const override {
+            std::vector<Point3> ret;
+            ret.reserve(8);
+            for (int i = 0; i < 8; i++) {
+                ret.emplace_back((i & 1) ? range[0].getMax() : range[0].getMin(),
+                                 (i & 2) ? range[1].getMax() : range[1].getMin(),
+                                 (i & 4) ? range[2].getMax() : range[2].getMin());
+            }
+            return ret;
+        }
+
+        Real surfaceArea() const override {
+            const Real dx = range[0].length(), dy = range[1].length(), dz = range[2].length();
+            return 2.0 * (dx * dy + dy * dz + dz * dx);
+        }
+
+        double hitCost() const override { return 1.0; }
+
         Point3 centerPoint() const override {
             Point3 ret;
             for (size_t i = 0; i < 3; i++) {
@@ -103,7 +133,7 @@ namespace renderer {
             return std::make_shared<AxisAlignedBoundingBox>();
         }
 
-        std::shared_ptr<AbstractBoundingBox> transformBoundingBox(const Matrix & matrix) override {
+        std::shared_ptr<AbstractBoundingBox> transformBoundingBox(const AffineTransform & matrix) override {
             //使用矩阵对包围盒的8个顶点进行变换
             Point3 min(INFINITY, INFINITY, INFINITY);
             Point3 max(-INFINITY, -INFINITY, -INFINITY);
@@ -112,13 +142,12 @@ namespace renderer {
                 for (int j = 0; j < 2; j++) {
                     for (int k = 0; k < 2; k++) {
                         //取出每个顶点的坐标
-                        const double x = i * range[0].getMax() + (1.0 - i) * range[0].getMin();
-                        const double y = j * range[1].getMax() + (1.0 - j) * range[1].getMin();
-                        const double z = k * range[2].getMax() + (1.0 - k) * range[2].getMin();
+                        const Real x = i * range[0].getMax() + (1.0 - i) * range[0].getMin();
+                        const Real y = j * range[1].getMax() + (1.0 - j) * range[1].getMin();
+                        const Real z = k * range[2].getMax() + (1.0 - k) * range[2].getMin();
 
                         //计算变换后的坐标
-                        Point3 point(x, y, z);
-                        point = (matrix * Matrix::toMatrix(point.toVector(), 1.0)).toPoint();
+                        const Point3 point = matrix.transformPoint(Point3(x, y, z));
 
                         //计算最值，保证包围盒和坐标轴对齐
                         for (int l = 0; l < 3; l++) {
@@ -151,7 +180,7 @@ namespace renderer {
             for (Uint8 i = 0; i < 3; i++) {
                 ret += "\n\t";
                 ret += static_cast<char>('x' + i);
-                ret += " = " + range[i].toString();
+                ret += " = " + renderer::toString(range[i]);
             }
             return ret;
         }
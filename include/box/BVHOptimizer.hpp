@@ -0,0 +1,489 @@
+#ifndef RENDERERTEST_BVHOPTIMIZER_HPP
+#define RENDERERTEST_BVHOPTIMIZER_HPP
+
+#include <box/BVHTree.hpp>
+#include <hittable/RayRecorder.hpp>
+#include <unordered_map>
+
+namespace renderer {
+    /*
+     * 基于光线分布的BVH优化器
+     *
+     * SAH和BVH构造时使用的表面积假设光线在空间中均匀分布，而相机光线和光源采样光线高度集中
+     * 优化器使用预渲染中记录的真实光线，测量每个节点被访问的次数，以此计算树的实际遍历开销：
+     *   C = Σ visits(N) * (testCost(N.left) + testCost(N.right))
+     * visits(N)为在[tMin, tMax]内穿过N及其所有祖先包围盒的光线数，tMax为光线的最近交点，与遍历顺序无关
+     *
+     * 使用两种局部操作降低测量开销，每轮结束后重新测量，开销没有下降时撤销整轮修改：
+     *   旋转：交换节点的子节点和孙节点，或交换两个孙节点
+     *   重插入：将访问次数远多于其父节点的子树摘下，插入到附近祖先下开销最小的位置
+     * 修改只会重新合并被修改节点的包围盒，其余节点的包围盒仍然包含其所有物体，树始终有效
+     */
+    class BVHOptimizer {
+    public:
+        //参与测量的最大光线数，超过时均匀抽样
+        static constexpr size_t MAX_RAY_COUNT = 16384;
+
+        //最大优化轮数
+        static constexpr Uint32 MAX_ITERATION = 4;
+
+        //重插入：每轮尝试的节点比例，以及从父节点向上的搜索起点层数和向下搜索的深度
+        static constexpr double REINSERT_FRACTION = 0.02;
+        static constexpr Uint32 REINSERT_ANCESTOR_LEVEL = 3;
+        static constexpr Uint32 REINSERT_SEARCH_DEPTH = 4;
+
+        //开销下降比例小于此值时不修改树
+        static constexpr double MIN_IMPROVEMENT = 1e-4;
+
+    private:
+        //工作节点，使用下标代替指针，便于修改和撤销
+        struct WorkNode {
+            std::shared_ptr<AbstractBoundingBox> box;
+            std::shared_ptr<AbstractHittable> primitive; //叶子节点对应的物体，内部节点为空
+            int left;
+            int right;
+            int parent;
+        };
+
+        std::vector<RecordedRay> rays;
+        std::vector<WorkNode> nodes;
+        std::vector<std::vector<Uint32>> nodeRays; //经过每个节点的光线下标
+        int root = -1;
+
+        explicit BVHOptimizer(const std::vector<RecordedRay> & recordedRays) {
+            //光线过多时均匀抽样
+            const size_t step = recordedRays.size() / MAX_RAY_COUNT + 1;
+            for (size_t i = 0; i < recordedRays.size(); i += step) {
+                rays.push_back(recordedRays[i]);
+            }
+        }
+
+        // ====== 树结构转换 ======
+
+        int convert(const std::shared_ptr<AbstractHittable> & obj, int parent) {
+            const auto node = std::dynamic_pointer_cast<BVHNode>(obj);
+
+            //只有一个物体的节点，左右子节点相同，直接使用物体作为叶子
+            if (node && node->left == node->right) {
+                return convert(node->left, parent);
+            }
+
+            const int index = static_cast<int>(nodes.size());
+            nodes.push_back({obj->getBoundingBox(), node ? null : obj, -1, -1, parent});
+            if (node) {
+                const int left = convert(node->left, index);
+                const int right = convert(node->right, index);
+                nodes[index].left = left;
+                nodes[index].right = right;
+            }
+            return index;
+        }
+
+        std::shared_ptr<AbstractHittable> restore(int index) const {
+            const auto & n = nodes[index];
+            if (n.primitive) {
+                return n.primitive;
+            }
+            auto node = std::make_shared<BVHNode>();
+            node->left = restore(n.left);
+            node->right = restore(n.right);
+            node->setBoundingBox(n.box);
+            return node;
+        }
+
+        // ====== 开销计算 ======
+
+        bool isLeaf(int index) const { return nodes[index].primitive != null; }
+
+        //父节点被访问时测试此节点的开销
+        double testCost(int index) const {
+            return isLeaf(index) ? nodes[index].primitive->hitCost() : nodes[index].box->hitCost();
+        }
+
+        double childCost(int index) const {
+            return testCost(nodes[index].left) + testCost(nodes[index].right);
+        }
+
+        int sibling(int index) const {
+            const auto & p = nodes[nodes[index].parent];
+            return p.left == index ? p.right : p.left;
+        }
+
+        void replaceChild(int parent, int oldChild, int newChild) {
+            if (nodes[parent].left == oldChild) {
+                nodes[parent].left = newChild;
+            } else {
+                nodes[parent].right = newChild;
+            }
+            nodes[newChild].parent = parent;
+        }
+
+        std::shared_ptr<AbstractBoundingBox> mergeBox(int a, int b) const {
+            return BoundingBoxSelector::merge(nodes[a].box, nodes[b].box, testCost(a) + testCost(b));
+        }
+
+        //从光线列表中筛选出穿过包围盒的光线
+        std::vector<Uint32> filterRays(const std::shared_ptr<AbstractBoundingBox> & box, const std::vector<Uint32> & candidates) const {
+            std::vector<Uint32> ret;
+            for (const Uint32 i : candidates) {
+                if (box->hit(rays[i].ray, Range(rays[i].tMin, rays[i].tMax))) {
+                    ret.push_back(i);
+                }
+            }
+            return ret;
+        }
+
+        size_t countRays(const std::shared_ptr<AbstractBoundingBox> & box, const std::vector<Uint32> & candidates) const {
+            size_t ret = 0;
+            for (const Uint32 i : candidates) {
+                if (box->hit(rays[i].ray, Range(rays[i].tMin, rays[i].tMax))) {
+                    ret++;
+                }
+            }
+            return ret;
+        }
+
+        //从指定节点开始向下重新计算经过每个节点的光线
+        void computeRays(int index, const std::vector<Uint32> & parentRays) {
+            nodeRays[index] = filterRays(nodes[index].box, parentRays);
+            if (!isLeaf(index)) {
+                computeRays(nodes[index].left, nodeRays[index]);
+                computeRays(nodes[index].right, nodeRays[index]);
+            }
+        }
+
+        //只更新单个节点的光线列表，子树中的列表在本轮结束后统一更新
+        void refreshRays(int index) {
+            nodeRays[index] = filterRays(nodes[index].box, nodeRays[nodes[index].parent]);
+        }
+
+        void computeAllRays() {
+            nodeRays.assign(nodes.size(), std::vector<Uint32>());
+            std::vector<Uint32> all(rays.size());
+            for (size_t i = 0; i < rays.size(); i++) {
+                all[i] = static_cast<Uint32>(i);
+            }
+            computeRays(root, all);
+        }
+
+        double totalCost() const {
+            double ret = 0.0;
+            for (size_t i = 0; i < nodes.size(); i++) {
+                if (!isLeaf(static_cast<int>(i))) {
+                    ret += static_cast<double>(nodeRays[i].size()) * childCost(static_cast<int>(i));
+                }
+            }
+            return ret;
+        }
+
+        // ====== 旋转 ======
+
+        //将node的子节点other和孙节点moved交换，moved的兄弟节点为stay，新的中间节点包围other和stay
+        bool tryRotate(int index) {
+            auto & n = nodes[index];
+            const double visits = static_cast<double>(nodeRays[index].size());
+            if (visits == 0.0) {
+                return false;
+            }
+
+            double bestDelta = 0.0;
+            int bestType = -1;          //0：子节点和孙节点交换，1：两个孙节点交换
+            int bestA = -1, bestB = -1; //交换的两个节点
+            std::shared_ptr<AbstractBoundingBox> bestBox1, bestBox2;
+
+            //子节点和孙节点交换
+            for (int side = 0; side < 2; side++) {
+                const int child = side ? n.right : n.left;
+                const int other = side ? n.left : n.right;
+                if (isLeaf(child)) continue;
+
+                const double oldCost = visits * (testCost(other) + testCost(child)) +
+                                       static_cast<double>(nodeRays[child].size()) * childCost(child);
+                for (int k = 0; k < 2; k++) {
+                    const int moved = k ? nodes[child].right : nodes[child].left;
+                    const int stay = k ? nodes[child].left : nodes[child].right;
+                    const auto box = mergeBox(other, stay);
+                    const double count = static_cast<double>(countRays(box, nodeRays[index]));
+                    const double newCost = visits * (testCost(moved) + box->hitCost()) + count * (testCost(other) + testCost(stay));
+                    if (newCost - oldCost < bestDelta) {
+                        bestDelta = newCost - oldCost;
+                        bestType = 0; bestA = other; bestB = moved; bestBox1 = box;
+                    }
+                }
+            }
+
+            //两个孙节点交换
+            if (!isLeaf(n.left) && !isLeaf(n.right)) {
+                const int a = n.left, b = n.right;
+                const double oldCost = visits * (testCost(a) + testCost(b)) +
+                                       static_cast<double>(nodeRays[a].size()) * childCost(a) +
+                                       static_cast<double>(nodeRays[b].size()) * childCost(b);
+                const int a1 = nodes[a].left, a2 = nodes[a].right;
+                for (int k = 0; k < 2; k++) {
+                    const int b1 = k ? nodes[b].right : nodes[b].left;
+                    const int b2 = k ? nodes[b].left : nodes[b].right;
+                    //交换a1和b1：a' = (b1, a2)，b' = (a1, b2)
+                    const auto boxA = mergeBox(b1, a2);
+                    const auto boxB = mergeBox(a1, b2);
+                    const double countA = static_cast<double>(countRays(boxA, nodeRays[index]));
+                    const double countB = static_cast<double>(countRays(boxB, nodeRays[index]));
+                    const double newCost = visits * (boxA->hitCost() + boxB->hitCost()) +
+                                           countA * (testCost(b1) + testCost(a2)) + countB * (testCost(a1) + testCost(b2));
+                    if (newCost - oldCost < bestDelta) {
+                        bestDelta = newCost - oldCost;
+                        bestType = 1; bestA = a1; bestB = b1; bestBox1 = boxA; bestBox2 = boxB;
+                    }
+                }
+            }
+
+            if (bestType < 0 || -bestDelta < MIN_IMPROVEMENT * visits) {
+                return false;
+            }
+
+            if (bestType == 0) {
+                //other移动到moved的位置，moved成为当前节点的子节点
+                const int child = nodes[bestB].parent;
+                replaceChild(index, bestA, bestB);
+                replaceChild(child, bestB, bestA);
+                nodes[child].box = bestBox1;
+                refreshRays(child);
+                refreshRays(bestB);
+                refreshRays(bestA);
+            } else {
+                const int a = nodes[bestA].parent, b = nodes[bestB].parent;
+                replaceChild(a, bestA, bestB);
+                replaceChild(b, bestB, bestA);
+                nodes[a].box = bestBox1;
+                nodes[b].box = bestBox2;
+                refreshRays(a);
+                refreshRays(b);
+                refreshRays(bestA);
+                refreshRays(bestB);
+            }
+            return true;
+        }
+
+        // ====== 重插入 ======
+
+        //重插入搜索范围内的节点：合并x后的包围盒和穿过该包围盒的光线，只和路径有关，所有候选位置共享
+        struct SearchNode {
+            int parent;
+            std::shared_ptr<AbstractBoundingBox> mergedBox;
+            std::vector<Uint32> mergedRays;
+        };
+
+        /*
+         * 将x摘下，插入为附近某个节点y的兄弟节点
+         * 摘除后兄弟节点s替代父节点p，p被复用为新的中间节点
+         * 搜索范围为父节点向上REINSERT_ANCESTOR_LEVEL层的祖先top下REINSERT_SEARCH_DEPTH层内的节点
+         * 从top到y的路径上的节点需要包围x，使用合并后的包围盒重新筛选光线；top和祖父节点的包围盒不变
+         */
+        bool tryReinsert(int x) {
+            const int p = nodes[x].parent;
+            if (p < 0) return false;
+            const int g = nodes[p].parent;
+            if (g < 0) return false;
+            const int s = sibling(x);
+
+            int top = g;
+            for (Uint32 i = 1; i < REINSERT_ANCESTOR_LEVEL && nodes[top].parent >= 0; i++) {
+                top = nodes[top].parent;
+            }
+
+            //在摘除p之后的树中遍历搜索范围，x所在的子树不可达
+            std::unordered_map<int, SearchNode> region;
+            std::vector<int> candidates;
+            {
+                std::vector<std::pair<int, Uint32>> queue = {{top, 0}};
+                for (size_t i = 0; i < queue.size(); i++) {
+                    const int a = queue[i].first;
+                    const Uint32 depth = queue[i].second;
+                    if (a != top) {
+                        candidates.push_back(a);
+                    }
+                    if (isLeaf(a) || depth >= REINSERT_SEARCH_DEPTH) continue;
+
+                    //a的子节点可能成为插入位置，a在路径上，需要包围x
+                    if (a != top) {
+                        const int parent = region[a].parent;
+                        const auto & parentRays = parent == top ? nodeRays[top] : region[parent].mergedRays;
+                        auto & item = region[a];
+                        item.mergedBox = BoundingBoxSelector::merge(nodes[a].box, nodes[x].box, testCost(a) + testCost(x));
+                        item.mergedRays = filterRays(item.mergedBox, parentRays);
+                    }
+                    for (int c : {nodes[a].left, nodes[a].right}) {
+                        if (c == p) c = s;
+                        if (c == x) continue;
+                        region[c].parent = a;
+                        queue.emplace_back(c, depth + 1);
+                    }
+                }
+            }
+
+            //修改前后p被兄弟节点替代，y被新节点替代，计算子节点的测试开销
+            const auto childTest = [&](int node, int y, const std::shared_ptr<AbstractBoundingBox> & newBox) {
+                double ret = 0.0;
+                for (const int c : {nodes[node].left, nodes[node].right}) {
+                    if (c == p) {
+                        ret += testCost(s);
+                    } else if (c == y) {
+                        ret += newBox->hitCost();
+                    } else {
+                        ret += testCost(c);
+                    }
+                }
+                return ret;
+            };
+            const auto oldCost = [&](int node) {
+                return static_cast<double>(nodeRays[node].size()) * childCost(node);
+            };
+
+            double bestDelta = 0.0;
+            int bestY = -1;
+            std::shared_ptr<AbstractBoundingBox> bestBox;
+
+            for (const int y : candidates) {
+                //y和s的位置相同，插入后树不变
+                if (y == s) continue;
+
+                const auto newBox = BoundingBoxSelector::merge(nodes[y].box, nodes[x].box, testCost(y) + testCost(x));
+                const int q = region[y].parent;
+                const auto & qRays = q == top ? nodeRays[top] : region[q].mergedRays;
+
+                //新节点和top
+                double before = oldCost(top) + oldCost(p);
+                double after = static_cast<double>(countRays(newBox, qRays)) * (testCost(x) + testCost(y)) +
+                               static_cast<double>(nodeRays[top].size()) * childTest(top, y, newBox);
+
+                //路径上的节点
+                bool isGrandParentOnPath = (g == top);
+                for (int a = q; a != top; a = region[a].parent) {
+                    before += oldCost(a);
+                    after += static_cast<double>(region[a].mergedRays.size()) * childTest(a, y, newBox);
+                    isGrandParentOnPath |= (a == g);
+                }
+
+                //不在路径上的祖父节点，包围盒不变，子节点p被s替代
+                if (!isGrandParentOnPath) {
+                    before += oldCost(g);
+                    after += static_cast<double>(nodeRays[g].size()) * childTest(g, y, newBox);
+                }
+
+                if (after - before < bestDelta) {
+                    bestDelta = after - before;
+                    bestY = y;
+                    bestBox = newBox;
+                }
+            }
+
+            if (bestY < 0 || -bestDelta < MIN_IMPROVEMENT * static_cast<double>(nodeRays[top].size())) {
+                return false;
+            }
+
+            //摘除：兄弟节点替代父节点，原来的祖先节点保留原包围盒
+            replaceChild(g, p, s);
+
+            //路径上的节点包围x
+            const int q = nodes[bestY].parent;
+            std::vector<int> path;
+            for (int a = q; a != top; a = nodes[a].parent) {
+                nodes[a].box = region[a].mergedBox;
+                path.push_back(a);
+            }
+
+            //插入：复用p作为新的中间节点
+            replaceChild(q, bestY, p);
+            nodes[p].left = bestY;
+            nodes[p].right = x;
+            nodes[bestY].parent = p;
+            nodes[x].parent = p;
+            nodes[p].box = bestBox;
+
+            //自上而下更新被修改节点的光线列表
+            for (auto it = path.rbegin(); it != path.rend(); ++it) {
+                refreshRays(*it);
+            }
+            refreshRays(s);
+            refreshRays(p);
+            refreshRays(bestY);
+            refreshRays(x);
+            return true;
+        }
+
+        // ====== 优化流程 ======
+
+        void run() {
+            computeAllRays();
+            const double initialCost = totalCost();
+            double currentCost = initialCost;
+
+            for (Uint32 iteration = 0; iteration < MAX_ITERATION; iteration++) {
+                const auto snapshot = nodes;
+                Uint32 rotateCount = 0, reinsertCount = 0;
+
+                //自底向上旋转
+                std::vector<int> order;
+                for (size_t i = 0; i < nodes.size(); i++) {
+                    if (!isLeaf(static_cast<int>(i))) order.push_back(static_cast<int>(i));
+                }
+                std::reverse(order.begin(), order.end());
+                for (const int index : order) {
+                    if (tryRotate(index)) rotateCount++;
+                }
+
+                //按浪费的访问次数（访问父节点但没有访问自身的光线数）选择需要重插入的节点
+                std::vector<std::pair<size_t, int>> waste;
+                for (size_t i = 0; i < nodes.size(); i++) {
+                    const int parent = nodes[i].parent;
+                    if (parent < 0 || nodes[parent].parent < 0) continue;
+                    waste.emplace_back(nodeRays[parent].size() - nodeRays[i].size(), static_cast<int>(i));
+                }
+                const auto reinsertCandidates = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(waste.size()) * REINSERT_FRACTION));
+                if (reinsertCandidates < waste.size()) {
+                    std::partial_sort(waste.begin(), waste.begin() + (long)reinsertCandidates, waste.end(),
+                                      [](const std::pair<size_t, int> & a, const std::pair<size_t, int> & b) { return a.first > b.first; });
+                    waste.resize(reinsertCandidates);
+                }
+                for (const auto & item : waste) {
+                    if (tryReinsert(item.second)) reinsertCount++;
+                }
+
+                //重新测量整棵树，没有下降时撤销整轮修改
+                computeAllRays();
+                const double cost = totalCost();
+                SDL_Log("BVH Optimize Iteration %u: Rotations = %u, Reinsertions = %u, Cost = %.0lf -> %.0lf",
+                        iteration, rotateCount, reinsertCount, currentCost, cost);
+                if (cost >= currentCost * (1.0 - MIN_IMPROVEMENT)) {
+                    if (cost > currentCost) {
+                        nodes = snapshot;
+                        computeAllRays();
+                    }
+                    break;
+                }
+                currentCost = cost;
+            }
+            SDL_Log("BVH Optimize Complete: Measured Cost %.0lf -> %.0lf (%.1lf%%)",
+                    initialCost, currentCost, initialCost > 0.0 ? 100.0 * currentCost / initialCost : 100.0);
+        }
+
+    public:
+        //使用记录的光线优化BVH树，直接修改树的结构
+        static void optimize(BVHTree & tree, const std::vector<RecordedRay> & recordedRays) {
+            if (!tree.root || recordedRays.empty()) {
+                return;
+            }
+
+            BVHOptimizer optimizer(recordedRays);
+            optimizer.root = optimizer.convert(tree.root, -1);
+            if (optimizer.isLeaf(optimizer.root)) {
+                return;
+            }
+            optimizer.run();
+
+            //根节点的包围盒没有被修改，树的包围盒不变
+            tree.root = std::dynamic_pointer_cast<BVHNode>(optimizer.restore(optimizer.root));
+        }
+    };
+}
+
+#endif //RENDERERTEST_BVHOPTIMIZER_HPP
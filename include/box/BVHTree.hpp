@@ -2,13 +2,14 @@
 #define RENDERERTEST_BVHTREE_HPP
 
 #include <hittable/HittableCollection.hpp>
-#include <box/AbstractBoundingBox.hpp>
+#include <hittable/AbstractBoxedHittable.hpp>
+#include <box/BoundingBoxSelector.hpp>
 
 namespace renderer {
     /*
      * BVH树节点类
      */
-    class BVHNode final : public AbstractHittable {
+    class BVHNode final : public AbstractBoxedHittable {
     public:
         /*
          * BVH为二叉树，节点成员为指向左右子节点的指针和当前节点的包围盒
@@ -19,18 +20,51 @@ namespace renderer {
 
         ~BVHNode() override = default;
 
-        bool hit(const Ray &ray, const Range &range, HitRecord &record) const override {
+        bool intersect(const Ray &ray, const Range &range, HitRecord &record) const override {
             //判断光线有没有和当前节点的包围盒碰撞
             if (!boundingBox->hit(ray, range)) {
                 return false;
             }
 
             //递归遍历左右子树的包围盒
-            const bool hitLeft = left->hit(ray, range, record);
-            const bool hitRight = right->hit(ray, Range(range.getMin(), hitLeft ? record.t : range.getMax()), record);
+            const bool hitLeft = left->intersect(ray, range, record);
+            const bool hitRight = right->intersect(ray, Range(range.getMin(), hitLeft ? record.t : range.getMax()), record);
             return hitLeft || hitRight;
         }
 
+        /*
+         * 以下两种情况下，视锥内的光线不需要测试当前节点的包围盒，直接从子节点开始遍历：
+         *   1. 只有一个子节点和视锥相交，另一个子节点被剔除
+         *   2. 包围盒覆盖整个视锥，视锥内的光线一定会击中包围盒
+         * 其他情况下两个子节点都可能被击中，以当前节点作为入口
+         */
+        void frustumEntries(const Frustum & frustum, std::vector<const AbstractHittable *> & entries) const override {
+            if (!frustum.intersects(*boundingBox)) {
+                return;
+            }
+            if (left == right) {
+                left->frustumEntries(frustum, entries);
+                return;
+            }
+            const bool isLeftInside = left->isInFrustum(frustum);
+            const bool isRightInside = right->isInFrustum(frustum);
+            if (isLeftInside && isRightInside && !frustum.isCoveredBy(*boundingBox)) {
+                entries.push_back(this);
+                return;
+            }
+            if (isLeftInside) {
+                left->frustumEntries(frustum, entries);
+            }
+            if (isRightInside) {
+                right->frustumEntries(frustum, entries);
+            }
+        }
+
+        //遍历节点时首先测试包围盒
+        double hitCost() const override {
+            return boundingBox->hitCost();
+        }
+
         bool equals(const AbstractObject &obj) const override { throw std::runtime_error("Not supported"); }
         std::string toString() const override { throw std::runtime_error("Not supported"); }
     };
@@ -41,103 +75,140 @@ namespace renderer {
      * 树本身作为一个整体可被击中
      * 树的包围盒，就是根节点的包围盒
      */
-    class BVHTree final : public AbstractHittable {
+    class BVHTree final : public AbstractBoxedHittable {
     private:
+        //优化器直接修改树的结构
+        friend class BVHOptimizer;
+        //场景优化器展开树中的物体
+        friend class SceneOptimizer;
+
+        //构造时使用的物体信息：内联的范围和中心点，划分时只移动这些POD数据，不移动智能指针，也不调用包围盒的虚函数
+        struct BuildEntry {
+            Bounds bounds;
+            Point3 center;
+            size_t index;
+        };
+
+        //每个物体对应的节点和包围盒字节数的估计值，用于确定小树的分配器内存块大小
+        static constexpr size_t BYTES_PER_OBJECT = 256;
+
+        //节点和节点包围盒的分配器，节点在内存中连续存放，树销毁时整体释放
+        SceneArena arena;
+
         //树的根节点
         std::shared_ptr<BVHNode> root;
 
-        //比较函数，比较两个 hittable 对象的包围盒在特定轴上的位置，使得空间上邻近的物体在数组内也相邻
-        static bool compare(const std::shared_ptr<AbstractHittable> & obj1, const std::shared_ptr<AbstractHittable> & obj2, size_t axis) {
-            const auto point1 = obj1->getBoundingBox()->centerPoint();
-            const auto point2 = obj2->getBoundingBox()->centerPoint();
-            return point1[axis] < point2[axis];
-        }
-
-        //分为x，y，z三个轴向的比较
-        static bool compare0(const std::shared_ptr<AbstractHittable> & obj1, const std::shared_ptr<AbstractHittable> & obj2) { return compare(obj1, obj2, 0); }
-        static bool compare1(const std::shared_ptr<AbstractHittable> & obj1, const std::shared_ptr<AbstractHittable> & obj2) { return compare(obj1, obj2, 1); }
-        static bool compare2(const std::shared_ptr<AbstractHittable> & obj1, const std::shared_ptr<AbstractHittable> & obj2) { return compare(obj1, obj2, 2); }
+        //不参与BVH划分的无限大或特别大的物体，在遍历BVH之后逐个测试
+        std::vector<std::shared_ptr<AbstractHittable>> unboundedList;
 
-        //树结构构造函数
-        std::shared_ptr<BVHNode> buildNode(std::vector<std::shared_ptr<AbstractHittable>> & array, size_t startIndex, size_t endIndex) {
+        //树结构构造函数，entries[startIndex, endIndex)为当前节点包含的物体
+        std::shared_ptr<BVHNode> buildNode(const std::vector<std::shared_ptr<AbstractHittable>> & objects, std::vector<BuildEntry> & entries,
+                                           size_t startIndex, size_t endIndex) {
             const size_t nodeCount = endIndex - startIndex;
 
             //当该层的物体个数不足以构成新的子树时，构造叶子节点
-            auto node = std::make_shared<BVHNode>();
+            auto node = arena.make<BVHNode>();
 
             if (nodeCount == 1) {
-                node->left = node->right = array[startIndex];
+                node->left = node->right = objects[entries[startIndex].index];
             } else if (nodeCount == 2) {
-                node->left = array[startIndex];
-                node->right = array[startIndex + 1];
+                node->left = objects[entries[startIndex].index];
+                node->right = objects[entries[startIndex + 1].index];
             } else {
                 //构造子树，递归调用此函数
 
-                //每一层都重新选择轴
-                //const int axis = randomInt(0, 2);
-                auto box = boundingBox->emptyBox();
+                //每一层都重新选择轴，使用内联范围的合并，不分配临时包围盒
+                Bounds bounds;
                 for (size_t i = startIndex; i < endIndex; i++) {
-                    box = box->merge(array[i]->getBoundingBox());
-                }
-                const int axis = box->longestAxis();
-
-                bool (*func) (const std::shared_ptr<AbstractHittable> & obj1, const std::shared_ptr<AbstractHittable> & obj2) = null;
-                switch (axis) {
-                    case 0: func = compare0; break;
-                    case 1: func = compare1; break;
-                    case 2: func = compare2; break;
-                    default:func = compare0;
+                    bounds.merge(entries[i].bounds);
                 }
+                const int axis = bounds.longestAxis();
 
-                //排序当前区间内的物体
-                std::sort(array.begin() + (long)startIndex, array.begin() + (long)endIndex, func);
-
-                //分割物体列表
+                //在中位数处分割物体列表，只需要找到中位数并将区间分为两侧，不需要排序整个区间
                 const size_t middleIndex = startIndex + nodeCount / 2;
+                std::nth_element(entries.begin() + (long)startIndex, entries.begin() + (long)middleIndex, entries.begin() + (long)endIndex,
+                                 [axis](const BuildEntry & e1, const BuildEntry & e2) { return e1.center[axis] < e2.center[axis]; });
 
                 //递归构造左右子节点
-                const auto leftNode = buildNode(array, startIndex, middleIndex);
-                const auto rightNode = buildNode(array, middleIndex, endIndex);
-                node->left = leftNode;
-                node->right = rightNode;
+                node->left = buildNode(objects, entries, startIndex, middleIndex);
+                node->right = buildNode(objects, entries, middleIndex, endIndex);
             }
 
-            //构造包围盒
-            node->setBoundingBox(node->left->getBoundingBox()->merge(node->right->getBoundingBox()));
+            //构造包围盒，由选择器决定使用轴对齐包围盒、有向包围盒或k-DOP
+            //光线没有击中更紧的包围盒时，节省的是测试子节点的开销
+            const double childCost = node->left == node->right ? node->left->hitCost() : node->left->hitCost() + node->right->hitCost();
+            node->setBoundingBox(BoundingBoxSelector::merge(node->left->getBoundingBox(), node->right->getBoundingBox(), childCost, &arena));
             return node;
         }
 
     public:
         //使用物体列表构造BVH树
-        explicit BVHTree(const HittableCollection & collection) {
-            //将物体列表拷贝一份，递归构造时需要排序修改物体列表
-            auto copyList = std::vector<std::shared_ptr<AbstractHittable>>(collection.getList());
-            if (collection.size() == 0) {
+        explicit BVHTree(const HittableCollection & collection) : BVHTree(collection.getList()) {}
+
+        explicit BVHTree(const std::vector<std::shared_ptr<AbstractHittable>> & objects) :
+            arena(std::min(static_cast<size_t>(MemoryArena::BLOCK_SIZE), std::max<size_t>(1, objects.size()) * BYTES_PER_OBJECT))
+        {
+            if (objects.empty()) {
                 return;
-            } else {
-                //Tree类的boundingBox在构造完成前设置一个初始值，使得构造过程中可以使用emptyBox虚函数
-                boundingBox = copyList[0]->getBoundingBox();
             }
 
-            //调用递归构造
-            root = buildNode(copyList, 0, collection.size());
+            //无限大和特别大的物体不参与划分
+            std::vector<std::shared_ptr<AbstractHittable>> boundedList;
+            HittableCollection::separateUnbounded(objects, boundedList, unboundedList);
+
+            if (!boundedList.empty()) {
+                //递归构造时只重排物体信息数组，物体列表保持不变
+                std::vector<BuildEntry> entries(boundedList.size());
+                for (size_t i = 0; i < boundedList.size(); i++) {
+                    entries[i].bounds = boundedList[i]->getBounds();
+                    entries[i].center = entries[i].bounds.centerPoint();
+                    entries[i].index = i;
+                }
+                root = buildNode(boundedList, entries, 0, boundedList.size());
+
+                //树的包围盒就是根节点的包围盒，包含了列表中所有物体
+                setBoundingBox(root->getBoundingBox());
+            } else {
+                setBoundingBox(unboundedList[0]->getBoundingBox());
+            }
 
-            //树的包围盒就是根节点的包围盒，包含了列表中所有物体
-            boundingBox = root->getBoundingBox();
+            //树的包围盒还需要包括BVH之外的物体，保证上层结构不会错误地剔除它们
+            for (const auto & obj : unboundedList) {
+                setBoundingBox(boundingBox->merge(obj->getBoundingBox()));
+            }
         }
         ~BVHTree() override = default;
 
-        //树的hit方法供外部调用，而node的hit方法为具体实现，在此方法中调用
-        bool hit(const Ray & ray, const Range & range, HitRecord & record) const override {
-            //检查树是否存在
-            if (!root) {
-                return false;
+        //树的intersect方法供外部调用，而node的intersect方法为具体实现，在此方法中调用
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            //调用node的intersect进行递归碰撞检查
+            bool isHit = root && root->intersect(ray, range, record);
+
+            //BVH之外的物体使用已找到的交点缩小检查范围
+            Real maxT = isHit ? record.t : range.getMax();
+            for (const auto & obj : unboundedList) {
+                if (obj->intersect(ray, Range(range.getMin(), maxT), record)) {
+                    isHit = true;
+                    maxT = record.t;
+                }
             }
+            return isHit;
+        }
 
-            //调用node的hit进行递归碰撞检查
-            return root->hit(ray, range, record);
+        void frustumEntries(const Frustum & frustum, std::vector<const AbstractHittable *> & entries) const override {
+            if (root) {
+                root->frustumEntries(frustum, entries);
+            }
+            for (const auto & obj : unboundedList) {
+                obj->frustumEntries(frustum, entries);
+            }
         }
 
+        // ====== 类封装函数 ======
+
+        //节点和节点包围盒占用的字节数，不包括物体本身
+        size_t memoryUsage() const { return arena.capacity(); }
+
         bool equals(const AbstractObject &obj) const override { throw std::runtime_error("Not supported"); }
         std::string toString() const override { throw std::runtime_error("Not supported"); }
     };
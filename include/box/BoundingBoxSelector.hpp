@@ -0,0 +1,138 @@
+#ifndef RENDERERTEST_BOUNDINGBOXSELECTOR_HPP
+#define RENDERERTEST_BOUNDINGBOXSELECTOR_HPP
+
+#include <box/OrientedBoundingBox.hpp>
+#include <box/KDOP.hpp>
+#include <util/SceneArena.hpp>
+
+namespace renderer {
+    /*
+     * 包围盒选择器：合并和变换包围盒时构造多种类型的候选包围盒，选择期望开销最小的一个
+     *
+     * 光线击中凸包围盒的概率和表面积成正比。候选包围盒都包含子节点，光线没有击中候选包围盒时一定不会击中子节点，
+     * 更紧的包围盒节省的是“击中包围盒但没有击中任何子节点”时测试子节点的开销，期望开销为
+     *   hitCost * A(aabb) + A(candidate) * childCost
+     * childCost为测试所有子节点的开销。k-DOP的测试开销更大，只有面积减少足够多，或子节点开销很大（如Transform）时才会被选中
+     *
+     * k-DOP的面积需要求出多面体的所有顶点，开销远大于合并本身。合并前先用面积下界判断候选能否胜出：
+     * 候选是包含两个子包围盒的凸体，凸体包含凸集时表面积不小于该凸集的表面积，因此子包围盒的面积是候选面积的下界
+     * 下界也不能使候选胜出的k-DOP不构造，子节点开销较小的内部节点（大部分节点）不计算k-DOP的面积，选择结果和逐个计算相同
+     */
+    class BoundingBoxSelector {
+    public:
+        enum class Policy {
+            AXIS_ALIGNED_ONLY, //只使用轴对齐包围盒，和之前的行为相同
+            TIGHTEST           //在轴对齐包围盒、有向包围盒、14-DOP和18-DOP中选择
+        };
+
+        //全局策略，在构造场景之前设置
+        static Policy & policy() {
+            static Policy p = Policy::TIGHTEST;
+            return p;
+        }
+
+        /*
+         * 选择期望开销最小的候选包围盒，返回其下标。第一个候选必须为轴对齐包围盒，为null的候选被跳过
+         * 候选使用裸指针，可以是栈上的临时对象，只有被选中的候选需要分配内存
+         */
+        template <size_t N>
+        static size_t select(const AbstractBoundingBox * const (&candidates)[N], double childCost) {
+            const double referenceArea = candidates[0]->surfaceArea();
+            if (std::isinf(referenceArea)) {
+                return 0;
+            }
+
+            size_t ret = 0;
+            double minCost = candidates[0]->hitCost() * referenceArea + referenceArea * childCost;
+            for (size_t i = 1; i < N; i++) {
+                if (candidates[i] == null) continue;
+                const double cost = candidates[i]->hitCost() * referenceArea + candidates[i]->surfaceArea() * childCost;
+                if (cost < minCost) {
+                    minCost = cost;
+                    ret = i;
+                }
+            }
+            return ret;
+        }
+
+        /*
+         * 合并两个包围盒，childCost为测试包围盒内子节点的开销
+         * 轴对齐包围盒和k-DOP候选在栈上构造，只为选中的包围盒分配内存，arena不为null时从场景分配器中分配
+         */
+        static std::shared_ptr<AbstractBoundingBox> merge(const std::shared_ptr<AbstractBoundingBox> & b1,
+                                                          const std::shared_ptr<AbstractBoundingBox> & b2, double childCost, SceneArena * arena = null) {
+            const AxisAlignedBoundingBox aabb(
+                    AxisAlignedBoundingBox(b1->project(Vec3(1.0, 0.0, 0.0)), b1->project(Vec3(0.0, 1.0, 0.0)), b1->project(Vec3(0.0, 0.0, 1.0))),
+                    AxisAlignedBoundingBox(b2->project(Vec3(1.0, 0.0, 0.0)), b2->project(Vec3(0.0, 1.0, 0.0)), b2->project(Vec3(0.0, 0.0, 1.0))));
+            if (policy() == Policy::AXIS_ALIGNED_ONLY) {
+                return SceneArena::create<AxisAlignedBoundingBox>(arena, aabb);
+            }
+
+            //有向包围盒沿用子包围盒的方向，由子包围盒的merge构造
+            //k-DOP子包围盒的merge和同阶的k-DOP候选相同，不重复构造
+            const std::shared_ptr<AbstractBoundingBox> merged1 = dynamic_cast<const OrientedBoundingBox *>(b1.get()) != null ? b1->merge(b2) : null;
+            const std::shared_ptr<AbstractBoundingBox> merged2 = dynamic_cast<const OrientedBoundingBox *>(b2.get()) != null ? b2->merge(b1) : null;
+
+            //k-DOP逐方向合并，面积取下界时也不可能比轴对齐包围盒更好则不构造，以轴对齐包围盒占位
+            const double referenceArea = aabb.surfaceArea();
+            const double areaBound = std::max(cheapSurfaceArea(*b1), cheapSurfaceArea(*b2));
+            const auto isPromising = [&](double hitCost) {
+                return hitCost * referenceArea + areaBound * childCost < (aabb.hitCost() + childCost) * referenceArea;
+            };
+            const bool tryDOP14 = isPromising(KDOP<14>::HIT_COST);
+            const bool tryDOP18 = isPromising(KDOP<18>::HIT_COST);
+            const KDOP<14> dop14 = tryDOP14 ? KDOP<14>(*b1, *b2) : KDOP<14>(aabb);
+            const KDOP<18> dop18 = tryDOP18 ? KDOP<18>(*b1, *b2) : KDOP<18>(aabb);
+            const AbstractBoundingBox * const candidates[] = {&aabb, merged1.get(), merged2.get(), tryDOP14 ? &dop14 : null, tryDOP18 ? &dop18 : null};
+            switch (select(candidates, childCost)) {
+                case 0: return SceneArena::create<AxisAlignedBoundingBox>(arena, aabb);
+                case 1: return merged1;
+                case 2: return merged2;
+                case 3: return SceneArena::create<KDOP<14>>(arena, dop14);
+                default: return SceneArena::create<KDOP<18>>(arena, dop18);
+            }
+        }
+
+        //变换包围盒，用于Transform物体，childCost为变换后物体的求交开销
+        static std::shared_ptr<AbstractBoundingBox> transform(const std::shared_ptr<AbstractBoundingBox> & box, const AffineTransform & matrix, double childCost) {
+            const auto transformed = box->transformBoundingBox(matrix);
+            const auto aabb = std::make_shared<AxisAlignedBoundingBox>(
+                    transformed->project(Vec3(1.0, 0.0, 0.0)), transformed->project(Vec3(0.0, 1.0, 0.0)), transformed->project(Vec3(0.0, 0.0, 1.0)));
+            if (policy() == Policy::AXIS_ALIGNED_ONLY) {
+                return aabb;
+            }
+
+            std::vector<Point3> points = box->vertices();
+            for (auto & p : points) {
+                p = matrix.transformPoint(p);
+            }
+
+            //轴对齐包围盒旋转后使用变换后的坐标轴构造有向包围盒
+            const std::shared_ptr<AbstractBoundingBox> candidates[] = {
+                    aabb, transformed,
+                    std::dynamic_pointer_cast<AxisAlignedBoundingBox>(box) ? std::make_shared<OrientedBoundingBox>(transformedAxis(matrix), points) : null,
+                    std::make_shared<KDOP<14>>(points), std::make_shared<KDOP<18>>(points)};
+            const AbstractBoundingBox * const pointers[] = {candidates[0].get(), candidates[1].get(), candidates[2].get(), candidates[3].get(), candidates[4].get()};
+            return candidates[select(pointers, childCost)];
+        }
+
+    private:
+        //可以直接计算的包围盒面积，用作合并候选的面积下界；k-DOP的面积需要求顶点，返回0（仍是有效的下界）
+        static double cheapSurfaceArea(const AbstractBoundingBox & box) {
+            if (dynamic_cast<const AxisAlignedBoundingBox *>(&box) != null || dynamic_cast<const OrientedBoundingBox *>(&box) != null) {
+                return box.surfaceArea();
+            }
+            return 0.0;
+        }
+
+        static std::array<Vec3, 3> transformedAxis(const AffineTransform & matrix) {
+            std::array<Vec3, 3> ret = {Vec3(1.0, 0.0, 0.0), Vec3(0.0, 1.0, 0.0), Vec3(0.0, 0.0, 1.0)};
+            for (auto & v : ret) {
+                v = matrix.transformVector(v);
+            }
+            return OrientedBoundingBox::orthonormalize(ret);
+        }
+    };
+}
+
+#endif //RENDERERTEST_BOUNDINGBOXSELECTOR_HPP
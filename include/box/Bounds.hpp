@@ -0,0 +1,90 @@
+#ifndef RENDERERTEST_BOUNDS_HPP
+#define RENDERERTEST_BOUNDS_HPP
+
+#include <box/AbstractBoundingBox.hpp>
+
+namespace renderer {
+    /*
+     * 内联存储的轴对齐范围，POD类型
+     * 和AxisAlignedBoundingBox不同，不是多态的包围盒对象，不需要堆分配，可以按值存放在物体和构造加速结构的数组中
+     * 加速结构构造时只使用Bounds计算划分，遍历使用的包围盒对象只在最终确定的节点上创建
+     * 默认构造为空范围（最小值为正无穷，最大值为负无穷），合并任意范围后得到该范围
+     */
+    struct Bounds {
+        Real minimum[3] = {static_cast<Real>(INFINITY), static_cast<Real>(INFINITY), static_cast<Real>(INFINITY)};
+        Real maximum[3] = {static_cast<Real>(-INFINITY), static_cast<Real>(-INFINITY), static_cast<Real>(-INFINITY)};
+
+        // ====== 对象操作函数 ======
+
+        void merge(const Bounds & bounds) {
+            for (size_t i = 0; i < 3; i++) {
+                minimum[i] = std::min(minimum[i], bounds.minimum[i]);
+                maximum[i] = std::max(maximum[i], bounds.maximum[i]);
+            }
+        }
+
+        void merge(const Point3 & point) {
+            for (size_t i = 0; i < 3; i++) {
+                minimum[i] = std::min(minimum[i], point[i]);
+                maximum[i] = std::max(maximum[i], point[i]);
+            }
+        }
+
+        //合并由3个连续坐标表示的点
+        void merge(const Real * point) {
+            for (size_t i = 0; i < 3; i++) {
+                minimum[i] = std::min(minimum[i], point[i]);
+                maximum[i] = std::max(maximum[i], point[i]);
+            }
+        }
+
+        //按x、y、z轴的最小值和最大值依次写入bounds（网格加载和网格文件接口使用的格式）
+        void copyTo(Real * bounds) const {
+            for (size_t i = 0; i < 3; i++) {
+                bounds[2 * i] = minimum[i];
+                bounds[2 * i + 1] = maximum[i];
+            }
+        }
+
+        Range operator[](size_t axis) const { return Range(minimum[axis], maximum[axis]); }
+
+        Point3 centerPoint() const {
+            return Point3((minimum[0] + maximum[0]) / 2.0, (minimum[1] + maximum[1]) / 2.0, (minimum[2] + maximum[2]) / 2.0);
+        }
+
+        //和AxisAlignedBoundingBox::longestAxis相同，长度相等时取靠后的轴
+        int longestAxis() const {
+            const Real x = maximum[0] - minimum[0], y = maximum[1] - minimum[1], z = maximum[2] - minimum[2];
+            if (x > y) {
+                return x > z ? 0 : 2;
+            } else {
+                return y > z ? 1 : 2;
+            }
+        }
+
+        bool isUnbounded() const {
+            for (size_t i = 0; i < 3; i++) {
+                if (std::isinf(maximum[i] - minimum[i])) return true;
+            }
+            return false;
+        }
+
+        // ====== 静态操作函数 ======
+
+        //任意类型的包围盒在三个坐标轴上的投影
+        static Bounds of(const AbstractBoundingBox & box) {
+            Bounds ret;
+            const Vec3 axes[3] = {Vec3(1.0, 0.0, 0.0), Vec3(0.0, 1.0, 0.0), Vec3(0.0, 0.0, 1.0)};
+            for (size_t i = 0; i < 3; i++) {
+                const Range range = box.project(axes[i]);
+                ret.minimum[i] = range.getMin();
+                ret.maximum[i] = range.getMax();
+            }
+            return ret;
+        }
+    };
+
+    static_assert(std::is_trivially_copyable<Bounds>::value && std::is_standard_layout<Bounds>::value, "Bounds must be a plain value type");
+}
+
+#endif //RENDERERTEST_BOUNDS_HPP
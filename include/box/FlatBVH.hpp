@@ -0,0 +1,149 @@
+#ifndef RENDERERTEST_FLATBVH_HPP
+#define RENDERERTEST_FLATBVH_HPP
+
+#include <box/Bounds.hpp>
+
+namespace renderer {
+    //扁平数组存储的BVH节点，POD类型，可以直接写入文件
+    struct FlatBVHNode {
+        Bounds bounds;
+        Uint32 offset;      //叶子节点为第一个图元的下标，内部节点为右子节点的下标，左子节点紧跟在当前节点之后
+        Uint16 count;       //叶子节点的图元个数，内部节点为0
+        Uint16 axis;        //内部节点的划分轴，遍历时按光线方向先访问近处的子节点
+    };
+
+    /*
+     * 扁平数组存储的BVH，供内部包含大量图元的物体使用（TriangleMesh、SphereSet），不为每个图元创建物体和包围盒
+     * 每个叶子最多包含LEAF_SIZE个图元，叶子由调用者提供的回调函数整体求交（通常是批量求交计算核）
+     *
+     * 构造时按中心点在最长轴上的中位数附近划分，左半部分取LEAF_SIZE的整数倍，除最后一个叶子外每个叶子都是满的
+     * 每层只扫描连续存放的构造信息，包围盒在子节点构造完成后自底向上合并
+     */
+    template <size_t LEAF_SIZE>
+    class FlatBVH {
+    public:
+        typedef FlatBVHNode Node;
+
+        //构造时使用的图元信息，构造后按叶子顺序排列，叶子节点的offset为其第一个图元在数组中的下标
+        struct BuildEntry {
+            Bounds bounds;
+            Uint32 primitive;
+        };
+
+    private:
+        //中心点坐标的两倍，只用于比较，省去除法
+        static Real doubledCenter(const BuildEntry & entry, size_t axis) {
+            return entry.bounds.minimum[axis] + entry.bounds.maximum[axis];
+        }
+
+        //递归构造[start, end)区间的节点
+        static void buildNode(std::vector<BuildEntry> & entries, size_t start, size_t end, std::vector<Node> & nodes) {
+            const size_t index = nodes.size();
+            nodes.emplace_back();
+
+            if (end - start <= LEAF_SIZE) {
+                Bounds bounds;
+                for (size_t i = start; i < end; i++) {
+                    bounds.merge(entries[i].bounds);
+                }
+                nodes[index].bounds = bounds;
+                nodes[index].offset = static_cast<Uint32>(start);
+                nodes[index].count = static_cast<Uint16>(end - start);
+                nodes[index].axis = 0;
+                return;
+            }
+
+            Bounds centerBounds;
+            for (size_t i = start; i < end; i++) {
+                centerBounds.merge(Point3(doubledCenter(entries[i], 0), doubledCenter(entries[i], 1), doubledCenter(entries[i], 2)));
+            }
+            const auto axis = static_cast<Uint16>(centerBounds.longestAxis());
+            const size_t middle = start + ((end - start) / 2 + LEAF_SIZE - 1) / LEAF_SIZE * LEAF_SIZE;
+            std::nth_element(entries.begin() + (long)start, entries.begin() + (long)middle, entries.begin() + (long)end,
+                             [axis](const BuildEntry & e1, const BuildEntry & e2) { return doubledCenter(e1, axis) < doubledCenter(e2, axis); });
+
+            buildNode(entries, start, middle, nodes);
+            const size_t right = nodes.size();
+            buildNode(entries, middle, end, nodes);
+            Bounds bounds = nodes[index + 1].bounds;
+            bounds.merge(nodes[right].bounds);
+            nodes[index].bounds = bounds;
+            nodes[index].offset = static_cast<Uint32>(right);
+            nodes[index].count = 0;
+            nodes[index].axis = axis;
+        }
+
+    public:
+        //构造BVH，entries被重排为叶子顺序，entries不能为空
+        static std::vector<Node> build(std::vector<BuildEntry> & entries) {
+            std::vector<Node> nodes;
+            nodes.reserve(2 * entries.size() / LEAF_SIZE + 1);
+            buildNode(entries, 0, entries.size(), nodes);
+            nodes.shrink_to_fit();
+            return nodes;
+        }
+
+        /*
+         * 和AxisAlignedBoundingBox::hit相同的slab测试
+         * 光线恰好经过包围盒边界上的图元时，舍入误差可能使far略小于near，叶子中的图元会被整个节点跳过
+         * 因此将far放大三次浮点运算的最大相对误差的两倍（Ize 2013），保证节点测试是保守的
+         */
+        static bool hitNode(const Node & node, const Ray & ray, Real tMin, Real tMax) {
+            constexpr Real unit = std::numeric_limits<Real>::epsilon() / 2;
+            constexpr Real farScale = 1 + 2 * (3 * unit / (1 - 3 * unit));
+            const Point3 & origin = ray.getOrigin();
+            const Vec3 & inverseDirection = ray.getInverseDirection();
+            for (size_t axis = 0; axis < 3; axis++) {
+                const bool isNegative = ray.isDirectionNegative(axis);
+                const Real near = ((isNegative ? node.bounds.maximum : node.bounds.minimum)[axis] - origin[axis]) * inverseDirection[axis];
+                const Real far = ((isNegative ? node.bounds.minimum : node.bounds.maximum)[axis] - origin[axis]) * inverseDirection[axis] * farScale;
+                tMin = near > tMin ? near : tMin;
+                tMax = far < tMax ? far : tMax;
+            }
+            return tMin <= tMax;
+        }
+
+        /*
+         * 使用栈遍历BVH，中位数划分的树深度不超过log2(图元个数)，64层足够
+         * hitLeaf(node, closest)测试叶子中的图元，击中比closest更近的图元时填写记录、更新closest并返回true
+         */
+        template <typename LeafHit>
+        static bool intersect(const Node * nodes, const Ray & ray, const Range & range, LeafHit && hitLeaf) {
+            Uint32 stack[64];
+            size_t stackSize = 0;
+            Uint32 current = 0;
+            Real closest = range.getMax();
+            bool isHit = false;
+
+            while (true) {
+                const Node & node = nodes[current];
+                if (hitNode(node, ray, range.getMin(), closest)) {
+                    if (node.count > 0) {
+                        if (hitLeaf(node, closest)) {
+                            isHit = true;
+                        }
+                    } else {
+                        //光线在划分轴上为负方向时先访问右子节点
+                        if (ray.isDirectionNegative(node.axis)) {
+                            stack[stackSize++] = current + 1;
+                            current = node.offset;
+                        } else {
+                            stack[stackSize++] = node.offset;
+                            current = current + 1;
+                        }
+                        continue;
+                    }
+                }
+                if (stackSize == 0) {
+                    break;
+                }
+                current = stack[--stackSize];
+            }
+            return isHit;
+        }
+    };
+
+    static_assert(std::is_trivially_copyable<FlatBVHNode>::value && std::is_standard_layout<FlatBVHNode>::value, "Flat BVH node must be a plain value type");
+}
+
+#endif //RENDERERTEST_FLATBVH_HPP
@@ -0,0 +1,81 @@
+#ifndef RENDERERTEST_FRUSTUM_HPP
+#define RENDERERTEST_FRUSTUM_HPP
+
+#include <box/AbstractBoundingBox.hpp>
+
+namespace renderer {
+    /*
+     * 视锥：以apex为顶点，四条棱穿过四个角点的无限长四棱锥
+     * 用于针孔相机的分块渲染：同一个块内所有主光线都从相机中心出发，穿过块在视口上的矩形，因此都位于这个视锥内
+     * 和视锥不相交的物体不可能被块内的主光线击中
+     */
+    class Frustum final : public AbstractObject {
+    private:
+        Point3 apex;
+        std::array<Vec3, 4> edge;    //从apex指向四个角点的棱
+        std::array<Vec3, 4> normal;  //四个侧面的外法向量，不要求是单位向量
+        std::array<Real, 4> limit; //apex在每个法向量上的投影，视锥内的点满足 normal · P <= limit
+
+    public:
+        //corners为四棱锥的四个角点，按照相邻顺序排列（顺时针或逆时针均可）
+        Frustum(const Point3 & apex, const std::array<Point3, 4> & corners) : apex(apex), limit() {
+            Vec3 middle;
+            for (size_t i = 0; i < 4; i++) {
+                edge[i] = Point3::constructVector(apex, corners[i]);
+                middle += edge[i];
+            }
+            for (size_t i = 0; i < 4; i++) {
+                normal[i] = Vec3::cross(edge[i], edge[(i + 1) % 4]);
+                //中心方向在视锥内，法向量需要背离中心方向
+                if (Vec3::dot(normal[i], middle) > 0.0) {
+                    normal[i] = -normal[i];
+                }
+                limit[i] = Vec3::dot(normal[i], apex.toVector());
+            }
+        }
+
+        ~Frustum() override = default;
+
+        //保守测试：包围盒完全位于某个侧面外侧时返回false，其余情况返回true
+        bool intersects(const AbstractBoundingBox & box) const {
+            for (size_t i = 0; i < 4; i++) {
+                if (box.project(normal[i]).getMin() > limit[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*
+         * 判断视锥内所有光线是否都会击中包围盒
+         * 从apex出发能击中凸包围盒的方向构成一个凸锥，四条棱都击中包围盒时，棱的凸组合（视锥内的所有方向）也都会击中包围盒
+         */
+        bool isCoveredBy(const AbstractBoundingBox & box) const {
+            for (const auto & e : edge) {
+                if (!box.hit(Ray(apex, e), Range(0.0, INFINITY))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // ====== 类封装函数 ======
+
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * frustum = dynamic_cast<const Frustum *>(&obj);
+            if (frustum == null) return false;
+            return apex == frustum->apex && normal == frustum->normal;
+        }
+
+        std::string toString() const override {
+            std::string ret("Frustum: Apex = " + renderer::toString(apex));
+            for (size_t i = 0; i < 4; i++) {
+                ret += "\n\tNormal = " + renderer::toString(normal[i]);
+            }
+            return ret;
+        }
+    };
+}
+
+#endif //RENDERERTEST_FRUSTUM_HPP
@@ -0,0 +1,340 @@
+#ifndef RENDERERTEST_KDOP_HPP
+#define RENDERERTEST_KDOP_HPP
+
+#include <box/AxisAlignedBoundingBox.hpp>
+
+namespace renderer {
+    /*
+     * k-DOP（离散有向多面体）包围盒：由K / 2组固定方向上的平行平面对围成的凸多面体
+     * 14-DOP：3个坐标轴 + 4个体对角线方向，18-DOP：3个坐标轴 + 6个面对角线方向
+     * 所有k-DOP使用相同的方向，合并只需要逐方向合并区间；前3个方向为坐标轴，区间即为轴对齐包围盒
+     */
+    template<size_t K>
+    class KDOP final : public AbstractBoundingBox {
+        static_assert(K == 14 || K == 18, "Only 14-DOP and 18-DOP are supported!");
+
+    public:
+        static constexpr size_t DIRECTION_COUNT = K / 2;
+
+        //开销和平面对的个数成正比，BVH遍历中每组平面对的除法和分支约为轴对齐包围盒单轴的1.5倍
+        static constexpr double HIT_COST = static_cast<double>(DIRECTION_COUNT) / 2.0;
+
+    private:
+        std::array<Range, DIRECTION_COUNT> range;
+
+        //确保包围盒体积有效，同轴对齐包围盒
+        void ensureVolume() {
+            constexpr Real EPSILON = 0.0005;
+            for (auto & i : range) {
+                if (i.length() < EPSILON) {
+                    i.expand(EPSILON);
+                }
+            }
+        }
+
+        bool isBounded() const {
+            for (const auto & r : range) {
+                if (std::isinf(r.length())) return false;
+            }
+            return true;
+        }
+
+        /*
+         * 判断点是否在平面上的容差：顶点由三个平面求交得到，误差为坐标最大值的若干个ulp
+         * 对角线方向上的区间端点可能接近0而顶点坐标很大，因此按所有区间端点的最大绝对值放大，而不是只按当前平面的偏移
+         */
+        Real planeTolerance() const {
+            Real magnitude = 0.0;
+            for (const auto & r : range) {
+                magnitude = std::max(magnitude, std::max(std::fabs(r.getMin()), std::fabs(r.getMax())));
+            }
+            return 64 * std::numeric_limits<Real>::epsilon() * (1 + magnitude);
+        }
+
+        static bool onPlane(Real value, Real offset, Real tolerance) {
+            return std::fabs(value - offset) <= tolerance;
+        }
+
+    public:
+        //k-DOP的平面法向量，不是单位向量
+        static const std::array<Vec3, DIRECTION_COUNT> & directions() {
+            static const std::array<Vec3, DIRECTION_COUNT> ret = [] {
+                std::array<Vec3, DIRECTION_COUNT> dirs;
+                dirs[0] = Vec3(1.0, 0.0, 0.0);
+                dirs[1] = Vec3(0.0, 1.0, 0.0);
+                dirs[2] = Vec3(0.0, 0.0, 1.0);
+                if (K == 14) {
+                    const Vec3 diagonal[] = {Vec3(1.0, 1.0, 1.0), Vec3(1.0, -1.0, 1.0), Vec3(1.0, 1.0, -1.0), Vec3(1.0, -1.0, -1.0)};
+                    std::copy(std::begin(diagonal), std::end(diagonal), dirs.begin() + 3);
+                } else {
+                    const Vec3 diagonal[] = {Vec3(1.0, 1.0, 0.0), Vec3(1.0, -1.0, 0.0), Vec3(1.0, 0.0, 1.0),
+                                             Vec3(1.0, 0.0, -1.0), Vec3(0.0, 1.0, 1.0), Vec3(0.0, 1.0, -1.0)};
+                    std::copy(std::begin(diagonal), std::end(diagonal), dirs.begin() + 3);
+                }
+                return dirs;
+            }();
+            return ret;
+        }
+
+        //包住所有点的最小k-DOP
+        explicit KDOP(const std::vector<Point3> & points) {
+            const auto & dirs = directions();
+            for (size_t i = 0; i < DIRECTION_COUNT; i++) {
+                Real min = INFINITY, max = -INFINITY;
+                for (const auto & p : points) {
+                    const Real d = Vec3::dot(p.toVector(), dirs[i]);
+                    min = std::min(min, d);
+                    max = std::max(max, d);
+                }
+                range[i] = Range(min, max);
+            }
+            ensureVolume();
+        }
+
+        //包住一个或两个任意类型包围盒的k-DOP
+        explicit KDOP(const AbstractBoundingBox & b1) {
+            const auto & dirs = directions();
+            for (size_t i = 0; i < DIRECTION_COUNT; i++) {
+                range[i] = b1.project(dirs[i]);
+            }
+            ensureVolume();
+        }
+
+        KDOP(const AbstractBoundingBox & b1, const AbstractBoundingBox & b2) {
+            const auto & dirs = directions();
+            for (size_t i = 0; i < DIRECTION_COUNT; i++) {
+                range[i] = Range(b1.project(dirs[i]), b2.project(dirs[i]));
+            }
+            //合并不会减小包围盒的体积
+        }
+
+        ~KDOP() override = default;
+
+        bool hit(const Ray & ray, const Range & checkRange) const override {
+            const Point3 & rayOrigin = ray.getOrigin();
+            const Vec3 & rayDirection = ray.getDirection();
+
+            //对角线方向的点积只有加减法，直接展开计算，避免在遍历中构造向量对象
+            Real q[DIRECTION_COUNT], d[DIRECTION_COUNT];
+            for (size_t i = 0; i < 3; i++) {
+                q[i] = rayOrigin[i];
+                d[i] = rayDirection[i];
+            }
+            if (K == 14) {
+                q[3] = q[0] + q[1] + q[2]; d[3] = d[0] + d[1] + d[2];
+                q[4] = q[0] - q[1] + q[2]; d[4] = d[0] - d[1] + d[2];
+                q[5] = q[0] + q[1] - q[2]; d[5] = d[0] + d[1] - d[2];
+                q[6] = q[0] - q[1] - q[2]; d[6] = d[0] - d[1] - d[2];
+            } else {
+                q[3] = q[0] + q[1]; d[3] = d[0] + d[1];
+                q[4] = q[0] - q[1]; d[4] = d[0] - d[1];
+                q[5] = q[0] + q[2]; d[5] = d[0] + d[2];
+                q[6] = q[0] - q[2]; d[6] = d[0] - d[2];
+                q[DIRECTION_COUNT - 2] = q[1] + q[2]; d[DIRECTION_COUNT - 2] = d[1] + d[2];
+                q[DIRECTION_COUNT - 1] = q[1] - q[2]; d[DIRECTION_COUNT - 1] = d[1] - d[2];
+            }
+
+            //和轴对齐包围盒相同的slab测试，只是平面对的个数更多
+            Range currentRange(checkRange);
+            for (size_t i = 0; i < DIRECTION_COUNT; i++) {
+
+                const Real t1 = (range[i].getMin() - q[i]) / d[i];
+                const Real t2 = (range[i].getMax() - q[i]) / d[i];
+
+                if (t1 < t2) {
+                    if (t1 > currentRange.getMin()) currentRange.setMin(t1);
+                    if (t2 < currentRange.getMax()) currentRange.setMax(t2);
+                } else {
+                    if (t2 > currentRange.getMin()) currentRange.setMin(t2);
+                    if (t1 < currentRange.getMax()) currentRange.setMax(t1);
+                }
+
+                if (!currentRange.isValid()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::shared_ptr<AbstractBoundingBox> merge(const std::shared_ptr<AbstractBoundingBox> & box) const override {
+            return std::make_shared<KDOP>(*this, *box);
+        }
+
+        Point3 centerPoint() const override {
+            Point3 ret;
+            for (size_t i = 0; i < 3; i++) {
+                ret[i] = (range[i].getMin() + range[i].getMax()) / 2.0;
+            }
+            return ret;
+        }
+
+        int longestAxis() const override {
+            if (range[0].length() > range[1].length()) {
+                return range[0].length() > range[2].length() ? 0 : 2;
+            } else {
+                return range[1].length() > range[2].length() ? 1 : 2;
+            }
+        }
+
+        std::shared_ptr<AbstractBoundingBox> emptyBox() const override {
+            return std::make_shared<AxisAlignedBoundingBox>();
+        }
+
+        std::shared_ptr<AbstractBoundingBox> transformBoundingBox(const AffineTransform & matrix) override {
+            //变换多面体的所有顶点，然后重新构造k-DOP
+            std::vector<Point3> points = vertices();
+            for (auto & p : points) {
+                p = matrix.transformPoint(p);
+            }
+            return std::make_shared<KDOP>(points);
+        }
+
+        Range project(const Vec3 & direction) const override {
+            //投影到自身的方向上时直接返回区间
+            const auto & dirs = directions();
+            for (size_t i = 0; i < DIRECTION_COUNT; i++) {
+                if (direction[0] == dirs[i][0] && direction[1] == dirs[i][1] && direction[2] == dirs[i][2]) {
+                    return range[i];
+                }
+            }
+
+            //其他方向使用多面体的顶点计算，无限大的k-DOP退化为轴对齐包围盒
+            if (!isBounded()) {
+                return AxisAlignedBoundingBox(range[0], range[1], range[2]).project(direction);
+            }
+            Real min = INFINITY, max = -INFINITY;
+            for (const auto & p : vertices()) {
+                const Real d = Vec3::dot(p.toVector(), direction);
+                min = std::min(min, d);
+                max = std::max(max, d);
+            }
+            return Range(min, max);
+        }
+
+        std::vector<Point3> vertices() const override {
+            if (!isBounded()) {
+                return AxisAlignedBoundingBox(range[0], range[1], range[2]).vertices();
+            }
+
+            //多面体的顶点是三个不平行平面的交点中满足所有平面约束的点
+            const auto & dirs = directions();
+            const Real tolerance = planeTolerance();
+            std::vector<Point3> ret;
+            for (size_t i = 0; i < DIRECTION_COUNT; i++) {
+                for (size_t j = i + 1; j < DIRECTION_COUNT; j++) {
+                    for (size_t k = j + 1; k < DIRECTION_COUNT; k++) {
+                        const Vec3 jk = Vec3::cross(dirs[j], dirs[k]);
+                        const Vec3 ki = Vec3::cross(dirs[k], dirs[i]);
+                        const Vec3 ij = Vec3::cross(dirs[i], dirs[j]);
+                        const Real det = Vec3::dot(dirs[i], jk);
+                        if (floatValueNearZero(det)) continue;
+
+                        //每个方向分别取最小和最大平面，使用克拉默法则求交点
+                        for (int side = 0; side < 8; side++) {
+                            const Real a = (side & 1) ? range[i].getMax() : range[i].getMin();
+                            const Real b = (side & 2) ? range[j].getMax() : range[j].getMin();
+                            const Real c = (side & 4) ? range[k].getMax() : range[k].getMin();
+                            const Point3 p((jk * a + ki * b + ij * c) / det);
+
+                            bool isInside = true;
+                            for (size_t l = 0; l < DIRECTION_COUNT && isInside; l++) {
+                                const Real d = Vec3::dot(p.toVector(), dirs[l]);
+                                isInside = (d >= range[l].getMin() || onPlane(d, range[l].getMin(), tolerance)) &&
+                                           (d <= range[l].getMax() || onPlane(d, range[l].getMax(), tolerance));
+                            }
+                            if (!isInside) continue;
+
+                            //多于三个平面交于一点时去掉重复的顶点，使用和平面相同的容差，很小的k-DOP上相近的不同顶点不会被合并
+                            bool isDuplicate = false;
+                            for (const auto & q : ret) {
+                                if (Point3::distanceSquare(p, q) <= tolerance * tolerance) {
+                                    isDuplicate = true;
+                                    break;
+                                }
+                            }
+                            if (!isDuplicate) {
+                                ret.push_back(p);
+                            }
+                        }
+                    }
+                }
+            }
+            return ret;
+        }
+
+        Real surfaceArea() const override {
+            if (!isBounded()) {
+                return INFINITY;
+            }
+
+            //逐个平面收集在平面上的顶点，按角度排序后计算多边形面积
+            const auto points = vertices();
+            const auto & dirs = directions();
+            const Real tolerance = planeTolerance();
+            Real area = 0.0;
+            std::vector<Point3> face;
+            std::vector<std::pair<Real, size_t>> angles;
+            for (size_t i = 0; i < DIRECTION_COUNT; i++) {
+                const Vec3 normal = dirs[i].unitVector();
+                const Vec3 u = Vec3::cross(normal, std::fabs(normal[0]) > 0.9 ? Vec3(0.0, 1.0, 0.0) : Vec3(1.0, 0.0, 0.0)).unitVector();
+                const Vec3 w = Vec3::cross(normal, u);
+
+                for (int side = 0; side < 2; side++) {
+                    const Real offset = side ? range[i].getMax() : range[i].getMin();
+                    face.clear();
+                    for (const auto & p : points) {
+                        if (onPlane(Vec3::dot(p.toVector(), dirs[i]), offset, tolerance)) {
+                            face.push_back(p);
+                        }
+                    }
+                    if (face.size() < 3) continue;
+
+                    Vec3 centroid;
+                    for (const auto & p : face) centroid += p.toVector();
+                    centroid /= static_cast<Real>(face.size());
+
+                    angles.clear();
+                    for (size_t j = 0; j < face.size(); j++) {
+                        const Vec3 local = face[j].toVector() - centroid;
+                        angles.emplace_back(std::atan2(Vec3::dot(local, w), Vec3::dot(local, u)), j);
+                    }
+                    std::sort(angles.begin(), angles.end());
+
+                    //鞋带公式
+                    Real faceArea = 0.0;
+                    for (size_t j = 0; j < angles.size(); j++) {
+                        const Vec3 p1 = face[angles[j].second].toVector() - centroid;
+                        const Vec3 p2 = face[angles[(j + 1) % angles.size()].second].toVector() - centroid;
+                        faceArea += Vec3::dot(p1, u) * Vec3::dot(p2, w) - Vec3::dot(p2, u) * Vec3::dot(p1, w);
+                    }
+                    area += std::fabs(faceArea) / 2.0;
+                }
+            }
+            return area;
+        }
+
+        double hitCost() const override { return HIT_COST; }
+
+        // ====== 类封装函数 ======
+
+        Range operator[](size_t index) const { return range[index]; }
+
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * box = dynamic_cast<const KDOP *>(&obj);
+            if (box == null) return false;
+            return range == box->range;
+        }
+
+        std::string toString() const override {
+            std::string ret(std::to_string(K) + "-DOP:");
+            const auto & dirs = directions();
+            for (size_t i = 0; i < DIRECTION_COUNT; i++) {
+                ret += "\n\t" + renderer::toString(dirs[i]) + " = " + renderer::toString(range[i]);
+            }
+            return ret;
+        }
+    };
+}
+
+#endif //RENDERERTEST_KDOP_HPP
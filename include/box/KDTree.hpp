@@ -0,0 +1,351 @@
+#ifndef RENDERERTEST_KDTREE_HPP
+#define RENDERERTEST_KDTREE_HPP
+
+#include <hittable/HittableCollection.hpp>
+#include <hittable/AbstractBoxedHittable.hpp>
+#include <box/AxisAlignedBoundingBox.hpp>
+
+namespace renderer {
+    /*
+     * SAH kd树，作为BVHTree之外的另一种加速结构，对外同样表现为一个可被击中的物体
+     * 与BVH按物体划分不同，kd树按空间划分：每个内部节点用一个轴对齐平面把空间一分为二，跨越平面的物体会同时出现在两侧
+     * 对由大量轴对齐长方体组成的场景（Box），空间划分能更快地剔除空区域
+     *
+     * 遍历：由近及远访问叶子，使用定长的短栈保存远侧子节点，找到不超过当前叶子出口t值的交点后立即结束
+     * 邮箱：同一物体可能位于多个叶子中，单次遍历内记录最近测试过的物体下标，避免重复求交
+     */
+    class KDTree final : public AbstractBoxedHittable {
+    private:
+        //扁平化存储的树节点，左子节点紧跟在父节点之后，只需记录右子节点下标
+        struct KDNode {
+            Real split;       //内部节点：分割平面位置
+            Uint32 data;        //内部节点：右子节点下标；叶子节点：在primitiveIndices中的起始位置
+            Uint32 flags;       //低2位：分割轴（0，1，2），值为3表示叶子节点；高30位：叶子节点的物体个数
+
+            bool isLeaf() const { return (flags & 3u) == 3u; }
+            Uint32 axis() const { return flags & 3u; }
+            Uint32 primitiveCount() const { return flags >> 2u; }
+        };
+
+        //构造时使用的分割候选边界：物体包围盒在某一轴上的起点或终点
+        struct BoundEdge {
+            Real position;
+            Uint32 primitiveIndex;
+            bool isStart;
+
+            bool operator<(const BoundEdge & obj) const {
+                //位置相同时起点排在终点之前（与PBRT相同），在分割平面上厚度为零的物体至少进入一侧，不会从两个子节点中同时丢失
+                if (position == obj.position) {
+                    return isStart && !obj.isStart;
+                }
+                return position < obj.position;
+            }
+        };
+
+        //遍历栈中待访问的远侧节点
+        struct KDTraverseItem {
+            Uint32 nodeIndex;
+            Real tMin, tMax;
+        };
+
+        // ====== SAH参数 ======
+        static constexpr Real TRAVERSAL_COST = 1.0;   //遍历一个内部节点的代价
+        static constexpr Real INTERSECT_COST = 80.0;  //与一个物体求交的代价
+        static constexpr Real EMPTY_BONUS = 0.5;      //一侧为空时的代价折扣，鼓励切除空区域
+        static constexpr Uint32 MAX_LEAF_PRIMITIVES = 2;
+        static constexpr Uint32 MAX_BAD_REFINES = 3;    //允许连续多少次代价不降低的划分
+        static constexpr Uint32 MAX_STACK_SIZE = 64;
+        static constexpr Uint32 MAILBOX_SIZE = 8;
+
+        std::vector<std::shared_ptr<AbstractHittable>> primitives;
+        std::vector<std::shared_ptr<AbstractHittable>> unboundedList; //不参与空间划分的无限大或特别大的物体
+        std::vector<std::array<Range, 3>> primitiveBounds;
+        std::vector<Uint32> primitiveIndices;
+        std::vector<KDNode> nodes;
+        std::array<Range, 3> treeBounds;
+        Uint32 maxDepth = 0;
+
+        //任意类型的包围盒都使用其在三个坐标轴上的投影，即物体内联存储的范围
+        static std::array<Range, 3> boundsOf(const Bounds & bounds) {
+            return {{bounds[0], bounds[1], bounds[2]}};
+        }
+
+        static Real surfaceArea(const std::array<Range, 3> & bounds) {
+            const Real dx = bounds[0].length(), dy = bounds[1].length(), dz = bounds[2].length();
+            return 2.0 * (dx * dy + dy * dz + dz * dx);
+        }
+
+        static int longestAxis(const std::array<Range, 3> & bounds) {
+            if (bounds[0].length() > bounds[1].length()) {
+                return bounds[0].length() > bounds[2].length() ? 0 : 2;
+            } else {
+                return bounds[1].length() > bounds[2].length() ? 1 : 2;
+            }
+        }
+
+        void createLeaf(const std::vector<Uint32> & indices) {
+            KDNode node {};
+            node.data = static_cast<Uint32>(primitiveIndices.size());
+            node.flags = (static_cast<Uint32>(indices.size()) << 2u) | 3u;
+            primitiveIndices.insert(primitiveIndices.end(), indices.begin(), indices.end());
+            nodes.push_back(node);
+        }
+
+        //递归构造，按照PBRT的做法在每层的三个轴上扫描所有包围盒边界，选取SAH代价最小的分割平面
+        void buildNode(const std::array<Range, 3> & nodeBounds, const std::vector<Uint32> & indices,
+                       Uint32 depth, Uint32 badRefines, std::vector<BoundEdge> edges[3]) {
+            const auto count = static_cast<Uint32>(indices.size());
+            if (count <= MAX_LEAF_PRIMITIVES || depth >= maxDepth) {
+                createLeaf(indices);
+                return;
+            }
+
+            const Real totalArea = surfaceArea(nodeBounds);
+            const Real invTotalArea = 1.0 / totalArea;
+            const Real leafCost = INTERSECT_COST * count;
+
+            Real bestCost = INFINITY;
+            int bestAxis = -1;
+            size_t bestOffset = 0;
+
+            //优先尝试最长轴，若找不到有效分割再尝试其余两轴
+            int axis = longestAxis(nodeBounds);
+            for (int retries = 0; retries < 3 && bestAxis == -1; retries++, axis = (axis + 1) % 3) {
+                //收集当前轴上的所有边界并排序
+                auto & axisEdges = edges[axis];
+                axisEdges.clear();
+                for (const Uint32 index : indices) {
+                    const Range & r = primitiveBounds[index][axis];
+                    axisEdges.push_back({r.getMin(), index, true});
+                    axisEdges.push_back({r.getMax(), index, false});
+                }
+                std::sort(axisEdges.begin(), axisEdges.end());
+
+                //从左到右扫描，维护平面两侧的物体个数
+                Uint32 belowCount = 0, aboveCount = count;
+                const int otherAxis0 = (axis + 1) % 3, otherAxis1 = (axis + 2) % 3;
+                const Real d0 = nodeBounds[otherAxis0].length();
+                const Real d1 = nodeBounds[otherAxis1].length();
+                const Real nodeMin = nodeBounds[axis].getMin();
+                const Real nodeMax = nodeBounds[axis].getMax();
+
+                for (size_t i = 0; i < axisEdges.size(); i++) {
+                    if (!axisEdges[i].isStart) aboveCount--;
+
+                    const Real position = axisEdges[i].position;
+                    if (position > nodeMin && position < nodeMax) {
+                        //分割平面两侧子空间的表面积
+                        const Real belowArea = 2.0 * (d0 * d1 + (position - nodeMin) * (d0 + d1));
+                        const Real aboveArea = 2.0 * (d0 * d1 + (nodeMax - position) * (d0 + d1));
+                        const Real pBelow = belowArea * invTotalArea;
+                        const Real pAbove = aboveArea * invTotalArea;
+                        const Real bonus = (aboveCount == 0 || belowCount == 0) ? EMPTY_BONUS : 0.0;
+                        const Real cost = TRAVERSAL_COST + INTERSECT_COST * (1.0 - bonus) * (pBelow * belowCount + pAbove * aboveCount);
+
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            bestAxis = axis;
+                            bestOffset = i;
+                        }
+                    }
+
+                    if (axisEdges[i].isStart) belowCount++;
+                }
+            }
+
+            //代价不下降时允许少量的“坏划分”，期望后续划分能够降低总代价
+            if (bestCost > leafCost) badRefines++;
+            if ((bestCost > 4.0 * leafCost && count < 16) || bestAxis == -1 || badRefines >= MAX_BAD_REFINES) {
+                createLeaf(indices);
+                return;
+            }
+
+            //按最佳平面分配物体，跨越平面的物体同时进入两侧
+            const auto & bestEdges = edges[bestAxis];
+            std::vector<Uint32> below, above;
+            for (size_t i = 0; i < bestOffset; i++) {
+                if (bestEdges[i].isStart) below.push_back(bestEdges[i].primitiveIndex);
+            }
+            for (size_t i = bestOffset + 1; i < bestEdges.size(); i++) {
+                if (!bestEdges[i].isStart) above.push_back(bestEdges[i].primitiveIndex);
+            }
+
+            const Real split = bestEdges[bestOffset].position;
+            auto belowBounds = nodeBounds, aboveBounds = nodeBounds;
+            belowBounds[bestAxis].setMax(split);
+            aboveBounds[bestAxis].setMin(split);
+
+            //先放入内部节点占位，左子树紧随其后，构造完左子树后回填右子节点下标
+            const auto nodeIndex = static_cast<Uint32>(nodes.size());
+            KDNode node {};
+            node.split = split;
+            node.flags = static_cast<Uint32>(bestAxis);
+            nodes.push_back(node);
+
+            buildNode(belowBounds, below, depth + 1, badRefines, edges);
+            nodes[nodeIndex].data = static_cast<Uint32>(nodes.size());
+            buildNode(aboveBounds, above, depth + 1, badRefines, edges);
+        }
+
+    public:
+        //使用和BVHTree相同的物体列表构造kd树
+        explicit KDTree(const HittableCollection & collection) {
+            HittableCollection::separateUnbounded(collection.getList(), primitives, unboundedList);
+            for (const auto & obj : unboundedList) {
+                setBoundingBox(boundingBox ? boundingBox->merge(obj->getBoundingBox()) : obj->getBoundingBox());
+            }
+            if (primitives.empty()) {
+                return;
+            }
+
+            //计算每个物体的包围盒和整棵树的范围，合并内联的范围，最后只分配一个包围盒
+            primitiveBounds.reserve(primitives.size());
+            Bounds rootBounds;
+            for (const auto & obj : primitives) {
+                primitiveBounds.push_back(boundsOf(obj->getBounds()));
+                rootBounds.merge(obj->getBounds());
+            }
+            treeBounds = boundsOf(rootBounds);
+            const auto rootBox = std::make_shared<AxisAlignedBoundingBox>(treeBounds[0], treeBounds[1], treeBounds[2]);
+            setBoundingBox(getBoundingBox() ? getBoundingBox()->merge(rootBox) : rootBox);
+
+            //经验最大深度：8 + 1.3 * log2(n)
+            maxDepth = static_cast<Uint32>(std::round(8.0 + 1.3 * std::log2(static_cast<Real>(primitives.size()))));
+            maxDepth = std::min(maxDepth, MAX_STACK_SIZE);
+
+            std::vector<Uint32> indices(primitives.size());
+            for (size_t i = 0; i < indices.size(); i++) {
+                indices[i] = static_cast<Uint32>(i);
+            }
+            std::vector<BoundEdge> edges[3];
+            for (auto & e : edges) {
+                e.reserve(2 * primitives.size());
+            }
+            buildNode(treeBounds, indices, 0, 0, edges);
+        }
+
+        ~KDTree() override = default;
+
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            bool isHit = intersectTree(ray, range, record);
+
+            //空间划分之外的物体使用已找到的交点缩小检查范围
+            Real maxT = isHit ? record.t : range.getMax();
+            for (const auto & obj : unboundedList) {
+                if (obj->intersect(ray, Range(range.getMin(), maxT), record)) {
+                    isHit = true;
+                    maxT = record.t;
+                }
+            }
+            return isHit;
+        }
+
+        // ====== 类封装函数 ======
+
+        size_t nodeCount() const { return nodes.size(); }
+
+        bool equals(const AbstractObject &obj) const override { throw std::runtime_error("Not supported"); }
+
+        std::string toString() const override {
+            return "KDTree: Primitives = " + std::to_string(primitives.size()) + ", Nodes = " + std::to_string(nodes.size()) +
+                   ", Leaf References = " + std::to_string(primitiveIndices.size()) + ", Unbounded = " + std::to_string(unboundedList.size());
+        }
+
+    private:
+        //遍历kd树，只处理参与空间划分的物体
+        bool intersectTree(const Ray & ray, const Range & range, HitRecord & record) const {
+            if (nodes.empty()) {
+                return false;
+            }
+
+            //计算光线和整棵树范围的交点区间
+            const Point3 & origin = ray.getOrigin();
+            const Vec3 & direction = ray.getDirection();
+            const Vec3 & inverseDirection = ray.getInverseDirection();
+            Real tMin = range.getMin(), tMax = range.getMax();
+            for (int axis = 0; axis < 3; axis++) {
+                Real t1 = (treeBounds[axis].getMin() - origin[axis]) * inverseDirection[axis];
+                Real t2 = (treeBounds[axis].getMax() - origin[axis]) * inverseDirection[axis];
+                if (t1 > t2) std::swap(t1, t2);
+                //NaN比较结果为false，保持原值
+                if (t1 > tMin) tMin = t1;
+                if (t2 < tMax) tMax = t2;
+                if (tMin > tMax) return false;
+            }
+
+            //单次遍历的邮箱，环形记录最近测试过的物体
+            Uint32 mailbox[MAILBOX_SIZE];
+            Uint32 mailboxCount = 0;
+
+            KDTraverseItem stack[MAX_STACK_SIZE];
+            Uint32 stackSize = 0;
+
+            bool isHit = false;
+            Real closestT = range.getMax();
+            Uint32 nodeIndex = 0;
+
+            while (true) {
+                //当前节点的入口已经远于已找到的交点，剩余节点无需访问
+                if (closestT < tMin) break;
+
+                const KDNode & node = nodes[nodeIndex];
+                if (!node.isLeaf()) {
+                    //计算光线和分割平面的交点，决定先访问哪一侧
+                    const Uint32 axis = node.axis();
+                    const Real tPlane = (node.split - origin[axis]) * inverseDirection[axis];
+                    const bool belowFirst = origin[axis] < node.split || (origin[axis] == node.split && direction[axis] <= 0.0);
+
+                    const Uint32 firstChild = belowFirst ? nodeIndex + 1 : node.data;
+                    const Uint32 secondChild = belowFirst ? node.data : nodeIndex + 1;
+
+                    if (tPlane > tMax || tPlane <= 0.0) {
+                        //只穿过近侧
+                        nodeIndex = firstChild;
+                    } else if (tPlane < tMin) {
+                        //只穿过远侧
+                        nodeIndex = secondChild;
+                    } else {
+                        //两侧都穿过，远侧入栈。树深度不超过MAX_STACK_SIZE，栈不会溢出
+                        stack[stackSize++] = {secondChild, tPlane, tMax};
+                        nodeIndex = firstChild;
+                        tMax = tPlane;
+                    }
+                } else {
+                    //叶子节点：对叶子内的物体逐个求交
+                    const Uint32 count = node.primitiveCount();
+                    for (Uint32 i = 0; i < count; i++) {
+                        const Uint32 index = primitiveIndices[node.data + i];
+
+                        //检查邮箱，跳过本次遍历中已经测试过的物体
+                        bool tested = false;
+                        const Uint32 mailboxEnd = mailboxCount < MAILBOX_SIZE ? mailboxCount : MAILBOX_SIZE;
+                        for (Uint32 m = 0; m < mailboxEnd; m++) {
+                            if (mailbox[m] == index) { tested = true; break; }
+                        }
+                        if (tested) continue;
+                        mailbox[mailboxCount++ % MAILBOX_SIZE] = index;
+
+                        //使用完整的光线范围求交，保证邮箱跳过的物体结果已经体现在closestT中
+                        if (primitives[index]->intersect(ray, Range(range.getMin(), closestT), record)) {
+                            isHit = true;
+                            closestT = record.t;
+                        }
+                    }
+
+                    //交点位于当前叶子内部，后续的叶子都更远
+                    if (isHit && closestT <= tMax) break;
+
+                    //弹出下一个待访问节点
+                    if (stackSize == 0) break;
+                    const KDTraverseItem & item = stack[--stackSize];
+                    nodeIndex = item.nodeIndex;
+                    tMin = item.tMin;
+                    tMax = item.tMax;
+                }
+            }
+            return isHit;
+        }
+    };
+}
+
+#endif //RENDERERTEST_KDTREE_HPP
@@ -0,0 +1,209 @@
+#ifndef RENDERERTEST_ORIENTEDBOUNDINGBOX_HPP
+#define RENDERERTEST_ORIENTEDBOUNDINGBOX_HPP
+
+#include <box/AxisAlignedBoundingBox.hpp>
+
+namespace renderer {
+    /*
+     * 有向包围盒：包围盒为长方体，三条棱的方向为任意一组正交单位向量
+     * 旋转后的物体使用有向包围盒不会因为重新和坐标轴对齐而变大
+     * 构造方式：中心点 + 三个轴 + 半边长，或给定三个轴，包住一组点或另一个包围盒
+     */
+    class OrientedBoundingBox final : public AbstractBoundingBox {
+    private:
+        Point3 center;
+        std::array<Vec3, 3> axis;         //三个互相正交的单位向量
+        std::array<Real, 3> halfExtent; //在每个轴上的半边长
+
+        //确保包围盒体积有效，同轴对齐包围盒
+        void ensureVolume() {
+            constexpr Real EPSILON = 0.0005;
+            for (auto & h : halfExtent) {
+                if (2.0 * h < EPSILON) {
+                    h = EPSILON / 2.0;
+                }
+            }
+        }
+
+        //使用在每个轴上的投影区间设置中心点和半边长
+        void setRanges(const std::array<Range, 3> & ranges) {
+            Vec3 c;
+            for (size_t i = 0; i < 3; i++) {
+                c += axis[i] * ((ranges[i].getMin() + ranges[i].getMax()) / 2.0);
+                halfExtent[i] = ranges[i].length() / 2.0;
+            }
+            center = Point3(c);
+            ensureVolume();
+        }
+
+    public:
+        OrientedBoundingBox(const Point3 & center, const std::array<Vec3, 3> & axis, const std::array<Real, 3> & halfExtent) :
+                center(center), axis(axis), halfExtent(halfExtent)
+        {
+            ensureVolume();
+        }
+
+        //使用给定的三个轴，构造包住所有点的最小有向包围盒
+        OrientedBoundingBox(const std::array<Vec3, 3> & axis, const std::vector<Point3> & points) : axis(axis), halfExtent() {
+            std::array<Range, 3> ranges;
+            for (size_t i = 0; i < 3; i++) {
+                ranges[i] = Range(INFINITY, -INFINITY);
+            }
+            for (const auto & p : points) {
+                for (size_t i = 0; i < 3; i++) {
+                    const Real d = Vec3::dot(p.toVector(), axis[i]);
+                    ranges[i].setMin(std::min(ranges[i].getMin(), d));
+                    ranges[i].setMax(std::max(ranges[i].getMax(), d));
+                }
+            }
+            setRanges(ranges);
+        }
+
+        //使用给定的三个轴，构造包住另一个包围盒的有向包围盒
+        OrientedBoundingBox(const std::array<Vec3, 3> & axis, const AbstractBoundingBox & box) : axis(axis), halfExtent() {
+            setRanges({box.project(axis[0]), box.project(axis[1]), box.project(axis[2])});
+        }
+
+        ~OrientedBoundingBox() override = default;
+
+        bool hit(const Ray & ray, const Range & checkRange) const override {
+            //在包围盒的局部坐标系中进行和轴对齐包围盒相同的slab测试
+            const Vec3 origin = Point3::constructVector(center, ray.getOrigin());
+            const Vec3 & rayDirection = ray.getDirection();
+
+            Range currentRange(checkRange);
+            for (size_t i = 0; i < 3; i++) {
+                const Real q = Vec3::dot(origin, axis[i]);
+                const Real d = Vec3::dot(rayDirection, axis[i]);
+
+                const Real t1 = (-halfExtent[i] - q) / d;
+                const Real t2 = (halfExtent[i] - q) / d;
+
+                if (t1 < t2) {
+                    if (t1 > currentRange.getMin()) currentRange.setMin(t1);
+                    if (t2 < currentRange.getMax()) currentRange.setMax(t2);
+                } else {
+                    if (t2 > currentRange.getMin()) currentRange.setMin(t2);
+                    if (t1 < currentRange.getMax()) currentRange.setMax(t1);
+                }
+
+                if (!currentRange.isValid()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //合并结果沿用当前包围盒的三个轴
+        std::shared_ptr<AbstractBoundingBox> merge(const std::shared_ptr<AbstractBoundingBox> & box) const override {
+            auto ret = std::make_shared<OrientedBoundingBox>(*this);
+            std::array<Range, 3> ranges;
+            for (size_t i = 0; i < 3; i++) {
+                ranges[i] = Range(project(axis[i]), box->project(axis[i]));
+            }
+            ret->setRanges(ranges);
+            return ret;
+        }
+
+        Point3 centerPoint() const override {
+            return center;
+        }
+
+        int longestAxis() const override {
+            //返回世界坐标系中投影最长的坐标轴
+            const Real x = project(Vec3(1.0, 0.0, 0.0)).length();
+            const Real y = project(Vec3(0.0, 1.0, 0.0)).length();
+            const Real z = project(Vec3(0.0, 0.0, 1.0)).length();
+            if (x > y) {
+                return x > z ? 0 : 2;
+            } else {
+                return y > z ? 1 : 2;
+            }
+        }
+
+        std::shared_ptr<AbstractBoundingBox> emptyBox() const override {
+            return std::make_shared<AxisAlignedBoundingBox>();
+        }
+
+        std::shared_ptr<AbstractBoundingBox> transformBoundingBox(const AffineTransform & matrix) override {
+            //变换三个轴并重新正交化（存在非均匀缩放时变换后的轴不再正交），然后包住变换后的8个顶点
+            std::array<Vec3, 3> transformed;
+            for (size_t i = 0; i < 3; i++) {
+                transformed[i] = matrix.transformVector(axis[i]);
+            }
+
+            std::vector<Point3> points = vertices();
+            for (auto & p : points) {
+                p = matrix.transformPoint(p);
+            }
+            return std::make_shared<OrientedBoundingBox>(orthonormalize(transformed), points);
+        }
+
+        Range project(const Vec3 & direction) const override {
+            const Real c = Vec3::dot(center.toVector(), direction);
+            Real r = 0.0;
+            for (size_t i = 0; i < 3; i++) {
+                r += halfExtent[i] * std::fabs(Vec3::dot(axis[i], direction));
+            }
+            return Range(c - r, c + r);
+        }
+
+        std::vector<Point3> vertices() const override {
+            std::vector<Point3> ret;
+            ret.reserve(8);
+            for (int i = 0; i < 8; i++) {
+                Point3 p(center);
+                p += axis[0] * ((i & 1) ? halfExtent[0] : -halfExtent[0]);
+                p += axis[1] * ((i & 2) ? halfExtent[1] : -halfExtent[1]);
+                p += axis[2] * ((i & 4) ? halfExtent[2] : -halfExtent[2]);
+                ret.push_back(p);
+            }
+            return ret;
+        }
+
+        Real surfaceArea() const override {
+            return 8.0 * (halfExtent[0] * halfExtent[1] + halfExtent[1] * halfExtent[2] + halfExtent[2] * halfExtent[0]);
+        }
+
+        //每个轴多两次点积
+        double hitCost() const override { return 1.5; }
+
+        // ====== 静态操作函数 ======
+
+        //Gram-Schmidt正交化，第一个向量的方向保持不变。向量退化时返回坐标轴
+        static std::array<Vec3, 3> orthonormalize(const std::array<Vec3, 3> & vectors) {
+            std::array<Vec3, 3> ret;
+            ret[0] = vectors[0];
+            ret[1] = vectors[1] - vectors[0] * (Vec3::dot(vectors[1], vectors[0]) / vectors[0].lengthSquare());
+            ret[2] = Vec3::cross(ret[0], ret[1]);
+            if (floatValueNearZero(ret[2].lengthSquare())) {
+                return {Vec3(1.0, 0.0, 0.0), Vec3(0.0, 1.0, 0.0), Vec3(0.0, 0.0, 1.0)};
+            }
+            for (auto & v : ret) {
+                v.unitize();
+            }
+            return ret;
+        }
+
+        // ====== 类封装函数 ======
+
+        const std::array<Vec3, 3> & getAxis() const { return axis; }
+
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * box = dynamic_cast<const OrientedBoundingBox *>(&obj);
+            if (box == null) return false;
+            return center == box->center && axis == box->axis && halfExtent == box->halfExtent;
+        }
+
+        std::string toString() const override {
+            std::string ret("OrientedBoundingBox: Center = " + renderer::toString(center));
+            for (size_t i = 0; i < 3; i++) {
+                ret += "\n\tAxis = " + renderer::toString(axis[i]) + ", Half Extent = " + std::to_string(halfExtent[i]);
+            }
+            return ret;
+        }
+    };
+}
+
+#endif //RENDERERTEST_ORIENTEDBOUNDINGBOX_HPP
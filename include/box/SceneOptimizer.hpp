@@ -0,0 +1,216 @@
+#ifndef RENDERERTEST_SCENEOPTIMIZER_HPP
+#define RENDERERTEST_SCENEOPTIMIZER_HPP
+
+#include <box/BVHTree.hpp>
+#include <hittable/Transform.hpp>
+#include <unordered_map>
+
+namespace renderer {
+    /*
+     * 渲染前的场景优化：展开嵌套的结构，使场景中的物体尽量由同一层BVH管理
+     *
+     * 构造场景时常常层层包裹：集合中放BVHTree，树中放Transform，Transform中又是集合（如constructBox的6个四边形）
+     * 每一层都多一次虚函数调用和包围盒测试，Transform还需要变换光线。优化器将场景改写为扁平的物体列表：
+     *   1. 展开：HittableCollection和BVHTree中的物体直接放入结果，由结果集合统一构造BVH
+     *   2. 合并：嵌套的Transform相乘为一个矩阵，外层变换下的集合把矩阵传给其中的每个物体
+     *   3. 烘焙：支持bake的小物体（四边形、三角形、长方体、球体）将变换直接应用到几何数据上，不再需要Transform
+     *      变换下的小集合（如constructBox的6个四边形）烘焙后保留为世界空间中的一个组，不拆入上层BVH：
+     *      BVH按物体个数的中位数划分，紧凑的小集合被拆开后常被划分到不同子树，节点包围盒相互重叠，遍历反而更慢
+     *   4. 实例：被多处引用、且展开后的物体数超过INSTANCE_THRESHOLD的集合只优化一次，各处用Transform引用同一个结果，
+     *      烘焙会为每处引用复制一份几何数据，只有共享能节省内存时才保留实例
+     * 不能烘焙的物体（网格、体积、包含镜像的变换等）保留一层使用合并后矩阵的Transform
+     *
+     * 没有变换的基本物体原样放入结果，仍是同一个对象，光源采样列表中的指针依然有效；烘焙后的物体是新对象
+     * 原有BVHTree的结构（包括BVHOptimizer的优化结果）被丢弃，需要时对结果重新优化
+     */
+    class SceneOptimizer {
+    public:
+        //共享集合展开后的物体数超过此值时保留实例
+        static constexpr size_t INSTANCE_THRESHOLD = 64;
+
+        //变换下展开后的物体数不超过此值的集合保留为一个组
+        static constexpr size_t GROUP_THRESHOLD = 16;
+
+        //优化结果的统计信息
+        struct Statistics {
+            size_t objectCount = 0;     //结果中的物体数
+            size_t flattenedCount = 0;  //被展开的集合和BVHTree个数
+            size_t collapsedCount = 0;  //被合并到外层变换中或为单位变换的Transform个数
+            size_t bakedCount = 0;      //被烘焙的物体个数
+            size_t groupCount = 0;      //保留的组的个数
+            size_t instanceCount = 0;   //保留的实例个数
+        };
+
+    private:
+        //集合被引用的次数和展开后的基本物体数，键为集合或BVHTree
+        std::unordered_map<const AbstractHittable *, size_t> referenceCounts;
+        std::unordered_map<const AbstractHittable *, size_t> primitiveCounts;
+
+        //已优化的共享集合，同一个集合的所有实例共享同一个结果
+        std::unordered_map<const AbstractHittable *, std::shared_ptr<HittableCollection>> instances;
+
+        Statistics statistics;
+
+        SceneOptimizer() = default;
+
+        static std::shared_ptr<HittableCollection> makeCollection(const std::vector<std::shared_ptr<AbstractHittable>> & objects) {
+            auto ret = std::make_shared<HittableCollection>();
+            for (const auto & obj : objects) {
+                ret->add(obj);
+            }
+            return ret;
+        }
+
+        //收集BVH子树中的物体，叶子节点的左右子节点为同一个物体
+        static void collectNode(const std::shared_ptr<AbstractHittable> & node, std::vector<std::shared_ptr<AbstractHittable>> & result) {
+            const auto * bvhNode = dynamic_cast<const BVHNode *>(node.get());
+            if (bvhNode == null) {
+                result.push_back(node);
+                return;
+            }
+            collectNode(bvhNode->left, result);
+            if (bvhNode->right != bvhNode->left) {
+                collectNode(bvhNode->right, result);
+            }
+        }
+
+        //获取集合或BVHTree中的物体，其他物体返回false
+        static bool children(const AbstractHittable * obj, std::vector<std::shared_ptr<AbstractHittable>> & result) {
+            if (const auto * collection = dynamic_cast<const HittableCollection *>(obj)) {
+                result.insert(result.end(), collection->getList().begin(), collection->getList().end());
+                return true;
+            }
+            if (const auto * tree = dynamic_cast<const BVHTree *>(obj)) {
+                if (tree->root) {
+                    collectNode(tree->root, result);
+                }
+                result.insert(result.end(), tree->unboundedList.begin(), tree->unboundedList.end());
+                return true;
+            }
+            return false;
+        }
+
+        //统计集合的引用次数，返回物体展开后的基本物体数。同一个集合只展开统计一次，每经过一次引用计数加1
+        size_t count(const std::shared_ptr<AbstractHittable> & obj) {
+            if (const auto * transform = dynamic_cast<const Transform *>(obj.get())) {
+                return count(transform->getObject());
+            }
+            std::vector<std::shared_ptr<AbstractHittable>> list;
+            if (!children(obj.get(), list)) {
+                return 1;
+            }
+            referenceCounts[obj.get()]++;
+            const auto iterator = primitiveCounts.find(obj.get());
+            if (iterator != primitiveCounts.end()) {
+                return iterator->second;
+            }
+            size_t total = 0;
+            for (const auto & child : list) {
+                total += count(child);
+            }
+            primitiveCounts[obj.get()] = total;
+            return total;
+        }
+
+        /*
+         * 将obj展开后写入result，matrix为从obj的局部空间到世界空间的变换，为null时obj已位于世界空间
+         * isGrouped表示obj位于正在构造的组中，组内的集合全部展开到组里，不再嵌套
+         */
+        void flatten(const std::shared_ptr<AbstractHittable> & obj, const AffineTransform * matrix,
+                     std::vector<std::shared_ptr<AbstractHittable>> & result, bool isGrouped = false) {
+            //合并变换，单位变换直接去掉
+            if (const auto * transform = dynamic_cast<const Transform *>(obj.get())) {
+                const AffineTransform combined = matrix == null ? transform->getTransformMatrix() : *matrix * transform->getTransformMatrix();
+                const bool isIdentity = combined == AffineTransform();
+                if (matrix != null || isIdentity) {
+                    statistics.collapsedCount++;
+                }
+                flatten(transform->getObject(), isIdentity ? null : &combined, result, isGrouped);
+                return;
+            }
+
+            std::vector<std::shared_ptr<AbstractHittable>> list;
+            if (children(obj.get(), list)) {
+                if (matrix != null && referenceCounts[obj.get()] > 1 && primitiveCounts[obj.get()] > INSTANCE_THRESHOLD) {
+                    result.push_back(std::make_shared<Transform>(instance(obj.get(), list), *matrix));
+                    statistics.instanceCount++;
+                    return;
+                }
+                if (matrix != null && !isGrouped && primitiveCounts[obj.get()] <= GROUP_THRESHOLD) {
+                    result.push_back(group(list, *matrix));
+                    return;
+                }
+                statistics.flattenedCount++;
+                for (const auto & child : list) {
+                    flatten(child, matrix, result, isGrouped);
+                }
+                return;
+            }
+
+            if (matrix == null) {
+                result.push_back(obj);
+                return;
+            }
+
+            //镜像变换会翻转四边形和三角形的正面，不烘焙
+            const auto baked = matrix->determinant() > 0.0 ? obj->bake(*matrix) : null;
+            if (baked) {
+                statistics.bakedCount++;
+                result.push_back(baked);
+            } else {
+                result.push_back(std::make_shared<Transform>(obj, *matrix));
+            }
+        }
+
+        //将变换下的小集合烘焙为世界空间中的一个组，组内只有一个物体时直接使用该物体
+        std::shared_ptr<AbstractHittable> group(const std::vector<std::shared_ptr<AbstractHittable>> & list, const AffineTransform & matrix) {
+            std::vector<std::shared_ptr<AbstractHittable>> objects;
+            for (const auto & child : list) {
+                flatten(child, &matrix, objects, true);
+            }
+            if (objects.size() == 1) {
+                return objects[0];
+            }
+            statistics.groupCount++;
+            return makeCollection(objects);
+        }
+
+        //在局部空间中优化共享集合，每个集合只优化一次
+        std::shared_ptr<HittableCollection> instance(const AbstractHittable * obj, const std::vector<std::shared_ptr<AbstractHittable>> & list) {
+            const auto iterator = instances.find(obj);
+            if (iterator != instances.end()) {
+                return iterator->second;
+            }
+            std::vector<std::shared_ptr<AbstractHittable>> objects;
+            for (const auto & child : list) {
+                flatten(child, null, objects);
+            }
+            const auto ret = makeCollection(objects);
+            instances[obj] = ret;
+            return ret;
+        }
+
+    public:
+        //优化场景，返回扁平化的新集合，原场景不被修改。statistics不为null时输出统计信息
+        static std::shared_ptr<HittableCollection> optimize(const HittableCollection & scene, Statistics * statistics = null) {
+            SceneOptimizer optimizer;
+            for (const auto & obj : scene.getList()) {
+                optimizer.count(obj);
+            }
+
+            std::vector<std::shared_ptr<AbstractHittable>> objects;
+            for (const auto & obj : scene.getList()) {
+                optimizer.flatten(obj, null, objects);
+            }
+            auto ret = makeCollection(objects);
+
+            if (statistics != null) {
+                *statistics = optimizer.statistics;
+                statistics->objectCount = objects.size();
+            }
+            return ret;
+        }
+    };
+}
+
+#endif //RENDERERTEST_SCENEOPTIMIZER_HPP
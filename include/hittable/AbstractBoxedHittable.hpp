@@ -0,0 +1,37 @@
+#ifndef RENDERERTEST_ABSTRACTBOXEDHITTABLE_HPP
+#define RENDERERTEST_ABSTRACTBOXEDHITTABLE_HPP
+
+#include <hittable/AbstractHittable.hpp>
+
+namespace renderer {
+    /*
+     * 持有多态包围盒的物体：加速结构的节点和树、Transform等
+     * 包围盒由BoundingBoxSelector选择，可能是有向包围盒或k-DOP，求交和视锥预处理直接测试它
+     * 基本物体只需要轴对齐的范围，直接继承AbstractHittable，不为每个图元分配包围盒对象
+     */
+    class AbstractBoxedHittable : public AbstractHittable {
+    protected:
+        //只能通过setBoundingBox修改，保证内联的范围同步
+        std::shared_ptr<AbstractBoundingBox> boundingBox;
+
+    public:
+        ~AbstractBoxedHittable() override = default;
+
+        bool isInFrustum(const Frustum & frustum) const override {
+            //空的BVHTree和KDTree没有包围盒，不可能出现在视锥中
+            return boundingBox != null && frustum.intersects(*boundingBox);
+        }
+
+        //设置和获取包围盒
+        void setBoundingBox(const std::shared_ptr<AbstractBoundingBox> & _boundingBox) {
+            AbstractBoxedHittable::boundingBox = _boundingBox;
+            setBounds(_boundingBox ? Bounds::of(*_boundingBox) : Bounds());
+        }
+
+        std::shared_ptr<AbstractBoundingBox> getBoundingBox() const override {
+            return boundingBox;
+        }
+    };
+}
+
+#endif //RENDERERTEST_ABSTRACTBOXEDHITTABLE_HPP
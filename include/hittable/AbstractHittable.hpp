@@ -3,51 +3,119 @@
 
 #include <basic/Ray.hpp>
 #include <util/Range.hpp>
-#include <box/AbstractBoundingBox.hpp>
+#include <box/Bounds.hpp>
+#include <box/AxisAlignedBoundingBox.hpp>
+#include <box/Frustum.hpp>
+#include <util/ResourceTable.hpp>
 
 namespace renderer {
     //前置声明，告知编译器该类稍后定义
     class AbstractMaterial;
+    class AbstractHittable;
 
-    //碰撞记录，POD类型
+    /*
+     * 碰撞记录，POD类型
+     * 求交阶段只填写t、object、params和primitive，最近交点确定后由object的finalize填写其余信息
+     */
     struct HitRecord {
         Point3 hitPoint;
         Vec3 normalVector;
-        double t;                                   //光线撞击物体时对应的t值
+        Real t;                                   //光线撞击物体时对应的t值
         bool hitFrontFace;                          //光线是否撞击到物体的外表面
-        std::shared_ptr<AbstractMaterial> material; //碰撞位置材质信息
-        std::pair<double, double> uvPair;           //纹理映射信息
+        ResourceHandle material;                    //碰撞位置材质在材质表中的句柄
+        std::pair<Real, Real> uvPair;           //纹理映射信息
+
+        const AbstractHittable * object;            //被撞击的基本物体，负责填写碰撞表面信息
+        std::pair<Real, Real> params;           //求交阶段的表面参数（如三角形的重心坐标），供finalize使用
+        Uint32 primitive;                           //被撞击物体内部的图元下标（如网格中的三角形），供finalize使用
     };
 
     class AbstractHittable : public AbstractObject {
+    private:
+        //包围盒在三个坐标轴上的投影，内联存储，构造加速结构时直接读取，不需要调用包围盒的虚函数
+        //基本物体只保存这一份范围，多态的包围盒对象只在需要时创建（见getBoundingBox和AbstractBoxedHittable）
+        Bounds bounds;
+
     protected:
-        //所有能被光线撞击的物体都有包围盒
-        std::shared_ptr<AbstractBoundingBox> boundingBox;
+        void setBounds(const Bounds & _bounds) {
+            bounds = _bounds;
+        }
+
+        //使用轴对齐包围盒的范围，包围盒在栈上构造，和直接持有它的物体一样保证最小厚度
+        void setBounds(const AxisAlignedBoundingBox & box) {
+            bounds = Bounds::of(box);
+        }
 
     public:
         ~AbstractHittable() override = default;
 
-        //所有可碰撞物体都有hit方法，用于判断光线是否和物体相交。如果相交，需要记录交点信息到record中
-        virtual bool hit(const Ray & ray, const Range & range, HitRecord & record) const = 0;
+        /*
+         * 求交：判断光线是否和物体在range范围内相交，相交时只记录t值、被撞击的物体和表面参数
+         * 没有相交时不能修改record，加速结构直接将子物体的结果写入同一个record，不需要临时记录的拷贝
+         */
+        virtual bool intersect(const Ray & ray, const Range & range, HitRecord & record) const = 0;
+
+        //根据求交阶段的记录计算碰撞点、法向量、纹理坐标和材质，只对最终的最近交点调用一次
+        virtual void finalize(const Ray & ray, HitRecord & record) const {}
+
+        //完整的碰撞测试：求交后由被撞击的物体填写碰撞信息
+        bool hit(const Ray & ray, const Range & range, HitRecord & record) const {
+            if (!intersect(ray, range, record)) {
+                return false;
+            }
+            record.object->finalize(ray, record);
+            return true;
+        }
 
         //获取可碰撞物体在指定起点和方向的PDF函数值
-        virtual double pdfValue(const Point3 & origin, const Vec3 & direction) const {
+        virtual Real pdfValue(const Point3 & origin, const Vec3 & direction) const {
             return 1.0;
         }
 
+        //一次hit调用的相对开销，轴对齐包围盒的一次测试为1，用于选择包围盒类型
+        virtual double hitCost() const {
+            return 1.5;
+        }
+
+        /*
+         * 视锥预处理：收集视锥内的光线需要遍历的入口物体，写入entries
+         * 位于视锥内的光线依次测试entries中的物体，和测试当前物体的结果相同
+         * 默认情况下物体不可再分，包围盒和视锥相交时以自身作为入口；加速结构重写此函数，跳过被剔除的节点和只有一个子节点在视锥内的节点
+         */
+        virtual void frustumEntries(const Frustum & frustum, std::vector<const AbstractHittable *> & entries) const {
+            if (isInFrustum(frustum)) {
+                entries.push_back(this);
+            }
+        }
+
+        //包围盒是否和视锥相交，只有范围的物体在栈上构造轴对齐包围盒测试
+        virtual bool isInFrustum(const Frustum & frustum) const {
+            return frustum.intersects(AxisAlignedBoundingBox(bounds[0], bounds[1], bounds[2]));
+        }
+
+        /*
+         * 烘焙变换：将仿射变换直接应用到物体的几何数据上，返回世界空间中的等价物体，供场景优化器代替Transform包裹
+         * 烘焙后的物体和Transform包裹的物体对任意光线的t值、法向量、正反面和纹理坐标都相同，不能做到时返回null
+         * 调用者保证变换的行列式大于0；默认不支持烘焙，大型物体（如网格）也不烘焙，以免复制几何数据
+         */
+        virtual std::shared_ptr<AbstractHittable> bake(const AffineTransform & transform) const {
+            return null;
+        }
+
         //在物体范围内随机生成一个点
         //生成从指定点指向物体上一点的向量
         virtual Vec3 randomVector(const Point3 & origin) const {
             return Vec3();
         }
 
-        //设置和获取包围盒
-        void setBoundingBox(const std::shared_ptr<AbstractBoundingBox> & _boundingBox) {
-            AbstractHittable::boundingBox = _boundingBox;
+        const Bounds & getBounds() const {
+            return bounds;
         }
 
-        const std::shared_ptr<AbstractBoundingBox> & getBoundingBox() const {
-            return boundingBox;
+        //多态的包围盒，供构造加速结构节点和Transform选择包围盒使用，不在求交中调用
+        //只有范围的物体每次调用都由范围构造一个新的轴对齐包围盒
+        virtual std::shared_ptr<AbstractBoundingBox> getBoundingBox() const {
+            return std::make_shared<AxisAlignedBoundingBox>(bounds[0], bounds[1], bounds[2]);
         }
     };
 }
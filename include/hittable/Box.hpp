@@ -0,0 +1,136 @@
+#ifndef RENDERERTEST_BOX_HPP
+#define RENDERERTEST_BOX_HPP
+
+#include <hittable/AbstractHittable.hpp>
+#include <material/AbstractMaterial.hpp>
+#include <box/AxisAlignedBoundingBox.hpp>
+
+namespace renderer {
+    /*
+     * 轴对齐长方体，使用一次slab测试求交，代替Parallelogram::constructBox构造的6个四边形
+     * 求交时记录光线进入（或从内部离开）长方体的面，finalize时由该面确定法向量和纹理坐标
+     * 每个面的法向量和纹理坐标和constructBox中对应的四边形相同，替换后渲染结果不变
+     * 长方体是凸的，可以作为ConstantMedium的边界
+     */
+    class Box final : public AbstractHittable {
+    private:
+        Point3 minimum, maximum;
+
+        ResourceHandle material;
+
+        //面的编号为2 * 轴 + (是否为最大值一侧)，记录在HitRecord::primitive中
+        static Uint32 faceIndex(size_t axis, bool isMax) {
+            return static_cast<Uint32>(2 * axis + (isMax ? 1 : 0));
+        }
+
+    public:
+        //以a和b为对角点构造长方体
+        Box(ResourceHandle material, const Point3 & a, const Point3 & b) : material(material) {
+            for (size_t i = 0; i < 3; i++) {
+                minimum[i] = std::min(a[i], b[i]);
+                maximum[i] = std::max(a[i], b[i]);
+            }
+            setBounds(AxisAlignedBoundingBox(minimum, maximum));
+        }
+
+        ~Box() override = default;
+
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            //和AxisAlignedBoundingBox::hit相同的slab测试，同时记录决定进入和离开t值的轴
+            const Point3 & origin = ray.getOrigin();
+            const Vec3 & inverseDirection = ray.getInverseDirection();
+            Real tEnter = -INFINITY, tExit = INFINITY;
+            size_t enterAxis = 0, exitAxis = 0;
+            for (size_t axis = 0; axis < 3; axis++) {
+                const bool isNegative = ray.isDirectionNegative(axis);
+                const Real near = ((isNegative ? maximum[axis] : minimum[axis]) - origin[axis]) * inverseDirection[axis];
+                const Real far = ((isNegative ? minimum[axis] : maximum[axis]) - origin[axis]) * inverseDirection[axis];
+                if (near > tEnter) {
+                    tEnter = near;
+                    enterAxis = axis;
+                }
+                if (far < tExit) {
+                    tExit = far;
+                    exitAxis = axis;
+                }
+            }
+            if (tEnter > tExit) {
+                return false;
+            }
+
+            //先判断进入点，起点在长方体内部时进入点在起点之后不存在，使用离开点
+            if (range.inRange(tEnter)) {
+                record.t = tEnter;
+                record.primitive = faceIndex(enterAxis, ray.isDirectionNegative(enterAxis));
+            } else if (range.inRange(tExit)) {
+                record.t = tExit;
+                record.primitive = faceIndex(exitAxis, !ray.isDirectionNegative(exitAxis));
+            } else {
+                return false;
+            }
+            record.object = this;
+            return true;
+        }
+
+        void finalize(const Ray & ray, HitRecord & record) const override {
+            record.hitPoint = ray.at(record.t);
+            record.material = material;
+
+            const size_t axis = record.primitive / 2;
+            const bool isMax = (record.primitive & 1) != 0;
+            Vec3 outwardNormal;
+            outwardNormal[axis] = isMax ? 1.0 : -1.0;
+            record.hitFrontFace = Vec3::dot(ray.getDirection(), outwardNormal) < 0.0;
+            record.normalVector = record.hitFrontFace ? outwardNormal : -outwardNormal;
+
+            //和constructBox中各个四边形的q、u、v对应的系数相同
+            const Point3 & p = record.hitPoint;
+            const auto coefficient = [&](size_t i, bool isReversed) {
+                const Real length = maximum[i] - minimum[i];
+                if (length <= 0.0) return static_cast<Real>(0.0);
+                return (isReversed ? maximum[i] - p[i] : p[i] - minimum[i]) / length;
+            };
+            switch (axis) {
+                case 0:     //左侧和右侧
+                    record.uvPair = std::pair<Real, Real>(coefficient(2, isMax), coefficient(1, false));
+                    break;
+                case 1:     //底面和顶面
+                    record.uvPair = std::pair<Real, Real>(coefficient(0, false), coefficient(2, isMax));
+                    break;
+                default:    //后面和前面
+                    record.uvPair = std::pair<Real, Real>(coefficient(0, !isMax), coefficient(1, false));
+                    break;
+            }
+        }
+
+        //沿坐标轴的正缩放和平移后仍是轴对齐长方体，纹理坐标为面内的相对位置，保持不变
+        //旋转后不再轴对齐，保留Transform：拆成6个四边形需要测试更多物体，并不更快
+        std::shared_ptr<AbstractHittable> bake(const AffineTransform & transform) const override {
+            Real scale[3];
+            if (!transform.isAxisScale(scale)) {
+                return null;
+            }
+            return std::make_shared<Box>(material, transform.transformPoint(minimum), transform.transformPoint(maximum));
+        }
+
+        // ====== 类封装函数 ======
+
+        const Point3 & getMinimum() const { return minimum; }
+        const Point3 & getMaximum() const { return maximum; }
+
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * box = dynamic_cast<const Box *>(&obj);
+            if (box == null) return false;
+            return minimum == box->minimum && maximum == box->maximum && material == box->material;
+        }
+
+        std::string toString() const override {
+            char buffer[TOSTRING_BUFFER_SIZE];
+            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Box: %p, Min: %s, Max: %s", this, renderer::toString(minimum).c_str(), renderer::toString(maximum).c_str());
+            return {buffer};
+        }
+    };
+}
+
+#endif //RENDERERTEST_BOX_HPP
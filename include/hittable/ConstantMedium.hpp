@@ -2,6 +2,7 @@
 #define RENDERERTEST_CONSTANTMEDIUM_HPP
 
 #include <hittable/AbstractHittable.hpp>
+#include <material/AbstractMaterial.hpp>
 
 namespace renderer {
     /*
@@ -15,36 +16,36 @@ namespace renderer {
         //包围物体
         std::shared_ptr<AbstractHittable> object;
         //将材质替换，可以实现不同的自定义效果
-        std::shared_ptr<AbstractMaterial> material;
+        ResourceHandle material;
         //比尔-朗伯定律因子
-        double density;
-        double factor;
+        Real density;
+        Real factor;
 
     public:
         //使用物体，材质和密度构造均匀介质
-        ConstantMedium(const std::shared_ptr<AbstractHittable> &object, const std::shared_ptr<AbstractMaterial> &material, double density) :
+        ConstantMedium(const std::shared_ptr<AbstractHittable> &object, ResourceHandle material, Real density) :
             object(object), material(material), density(density), factor(-1.0 / density)
         {
-            this->boundingBox = object->getBoundingBox();
+            setBounds(object->getBounds());
         }
 
         ~ConstantMedium() override = default;
 
-        bool hit(const Ray &ray, const Range &range, HitRecord &record) const override {
+        bool intersect(const Ray &ray, const Range &range, HitRecord &record) const override {
             /*
              * 首先调用边界物体的 hit 函数两次，以找到光线进入和射出该体积的两个交点
              * 如果光线没有进入或者只进入一次（擦边），则认为没有命中
              * 每次碰撞都随机变换方向，多次迭代后就能形成柔和、弥散的视觉效果
              *
-             * 1：正常与物体求交，找到一个交点（hit方法自动记录最近交点）
+             * 1：正常与物体求交，找到一个交点（intersect方法自动记录最近交点，只需要t值，不需要填写表面信息）
              * 2：前进一小段距离，再次求交，尝试寻找第二个交点
              * 3：光线在介质中行进的距离为两个交点的t值之差乘以光线的方向向量的模
              */
             HitRecord rec1, rec2;
-            if (!object->hit(ray, Range(-INFINITY, INFINITY), rec1)) {
+            if (!object->intersect(ray, Range(-INFINITY, INFINITY), rec1)) {
                 return false;
             }
-            if (!object->hit(ray, Range(rec1.t + 0.001, INFINITY), rec2)) {
+            if (!object->intersect(ray, Range(rec1.t + 0.001, INFINITY), rec2)) {
                 return false;
             }
 
@@ -79,16 +80,29 @@ namespace renderer {
                 //光没有在介质内部发生散射
                 return false;
             } else {
-                //发生散射，计算碰撞点并填充碰撞信息
+                //发生散射，记录碰撞位置
                 record.t = rec1.t + hitDistance / rayLength;
-                record.hitPoint = ray.at(record.t);
-                record.normalVector = Vec3(1.0, 0.0, 0.0); //任意
-                record.hitFrontFace = true; //任意
-                record.material = this->material;
+                record.object = this;
                 return true;
             }
         }
 
+        void finalize(const Ray &ray, HitRecord &record) const override {
+            record.hitPoint = ray.at(record.t);
+            record.normalVector = Vec3(1.0, 0.0, 0.0); //任意
+            record.hitFrontFace = true; //任意
+            record.material = this->material;
+        }
+
+        //包围盒和被包装的物体相同，不另外保存
+        std::shared_ptr<AbstractBoundingBox> getBoundingBox() const override {
+            return object->getBoundingBox();
+        }
+
+        bool isInFrustum(const Frustum & frustum) const override {
+            return object->isInFrustum(frustum);
+        }
+
         // ====== 类封装函数 ======
 
         bool equals(const AbstractObject &obj) const override {
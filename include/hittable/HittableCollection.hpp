@@ -2,54 +2,115 @@
 #define RENDERERTEST_HITTABLECOLLECTION_HPP
 
 #include <hittable/AbstractHittable.hpp>
-#include <box/AbstractBoundingBox.hpp>
+#include <box/AxisAlignedBoundingBox.hpp>
+#include <atomic>
+#include <mutex>
 
 namespace renderer {
     /*
      * 所有可碰撞物体组成的集合，也继承自Hittable抽象类，拥有全局包围盒，只支持添加物体
+     *
+     * 物体个数超过ACCELERATE_THRESHOLD时，第一次被光线击中前自动构造BVH，之后的hit调用转发给BVH
+     * 添加新物体会使已构造的BVH失效，下一次hit时重新构造
      */
     class HittableCollection final : public AbstractHittable {
     private:
         std::vector<std::shared_ptr<AbstractHittable>> list;
 
-        //AbstractHittable中定义了包围盒成员，子类不要重复定义，否则子类add方法修改子类的包围盒，而继承下来的getBoundingBox方法返回父类包围盒
-        //std::shared_ptr<AbstractBoundingBox> boundingBox;
+        //自动构造的加速结构，hit为const方法，使用互斥锁保证多线程下只构造一次
+        mutable std::shared_ptr<AbstractHittable> accelerator;
+        mutable std::atomic<bool> isAccelerated;
+        mutable std::mutex acceleratorMutex;
+
+        //构造加速结构，定义在HittableCollection.cpp中，避免和BVHTree.hpp相互包含
+        void buildAccelerator() const;
 
     public:
-        HittableCollection() = default;
+        //物体个数超过此值时自动构造BVH
+        static constexpr size_t ACCELERATE_THRESHOLD = 4;
+
+        //包围盒最长边超过列表中位数的此倍数时，物体被视为“大物体”，不参与BVH划分
+        static constexpr Real LARGE_PRIMITIVE_RATIO = 16.0;
+
+        HittableCollection() : isAccelerated(false) {}
         ~HittableCollection() override = default;
 
-        bool hit(const Ray & ray, const Range & range, HitRecord & record) const override {
-            //遍历列表中所有物体，依次调用其hit方法，找出最近的交点
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            if (list.size() > ACCELERATE_THRESHOLD) {
+                if (!isAccelerated.load(std::memory_order_acquire)) {
+                    buildAccelerator();
+                }
+                return accelerator->intersect(ray, range, record);
+            }
+
+            //遍历列表中所有物体，依次调用其intersect方法，找出最近的交点
+            //未命中的物体不会修改record，命中的物体只覆盖t值和物体信息，因此不需要临时记录
             bool isHit = false;
-            double maxT = range.getMax();
-            HitRecord tempRecord;
+            Real maxT = range.getMax();
 
             for (const auto & obj : list) {
-                if (obj->hit(ray, Range(range.getMin(), maxT), tempRecord)) {
-                    isHit = true;        //碰撞到了任意物体
-                    maxT = tempRecord.t; //记录当前碰撞的t值并作为下一次碰撞检查范围的最大t值，使得之后忽略t值更大的碰撞
-                    record = tempRecord;
+                if (obj->intersect(ray, Range(range.getMin(), maxT), record)) {
+                    isHit = true;    //碰撞到了任意物体
+                    maxT = record.t; //记录当前碰撞的t值并作为下一次碰撞检查范围的最大t值，使得之后忽略t值更大的碰撞
                 }
             }
             return isHit;
         }
 
+        //已加速时转发给加速结构，否则逐个收集列表中的物体
+        void frustumEntries(const Frustum & frustum, std::vector<const AbstractHittable *> & entries) const override {
+            if (list.size() > ACCELERATE_THRESHOLD) {
+                if (!isAccelerated.load(std::memory_order_acquire)) {
+                    buildAccelerator();
+                }
+                accelerator->frustumEntries(frustum, entries);
+                return;
+            }
+            for (const auto & obj : list) {
+                obj->frustumEntries(frustum, entries);
+            }
+        }
+
         // ====== 对象操作函数 ======
 
         //添加一个Hittable
         void add(const std::shared_ptr<AbstractHittable> & obj) {
+            std::lock_guard<std::mutex> lock(acceleratorMutex);
             list.push_back(obj);
-            //合并新物体的包围盒，保证总包围盒包括所有物体
-            if (boundingBox) {
-                boundingBox = boundingBox->merge(obj->getBoundingBox());
-            } else {
-                boundingBox = obj->getBoundingBox();
-            }
+            //合并新物体的范围，保证总范围包括所有物体，添加物体不分配包围盒
+            Bounds bounds = getBounds();
+            bounds.merge(obj->getBounds());
+            setBounds(bounds);
+
+            //已构造的加速结构不再包含所有物体
+            accelerator = null;
+            isAccelerated.store(false, std::memory_order_release);
         }
 
         size_t size() const { return list.size(); }
 
+        //只有一个物体时使用其包围盒，否则为所有物体范围的轴对齐包围盒
+        std::shared_ptr<AbstractBoundingBox> getBoundingBox() const override {
+            return list.size() == 1 ? list[0]->getBoundingBox() : AbstractHittable::getBoundingBox();
+        }
+
+        bool isInFrustum(const Frustum & frustum) const override {
+            return list.size() == 1 ? list[0]->isInFrustum(frustum) : AbstractHittable::isInFrustum(frustum);
+        }
+
+        // ====== 静态操作函数 ======
+
+        //判断包围盒是否在任意轴上无限延伸
+        static bool isUnbounded(const std::shared_ptr<AbstractHittable> & obj);
+
+        /*
+         * 将物体列表分为有限大小的物体和无限大/特别大的物体
+         * 特别大的物体（如半径1000的地面球）会撑大BVH根节点的包围盒，使所有划分都变差，这类物体单独存放，在BVH之外逐个测试
+         */
+        static void separateUnbounded(const std::vector<std::shared_ptr<AbstractHittable>> & objects,
+                                      std::vector<std::shared_ptr<AbstractHittable>> & bounded,
+                                      std::vector<std::shared_ptr<AbstractHittable>> & unbounded);
+
         // ====== 类封装函数 ======
 
         bool equals(const AbstractObject &obj) const override {
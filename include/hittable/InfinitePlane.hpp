@@ -0,0 +1,86 @@
+#ifndef RENDERERTEST_INFINITEPLANE_HPP
+#define RENDERERTEST_INFINITEPLANE_HPP
+
+#include <hittable/AbstractHittable.hpp>
+#include <material/AbstractMaterial.hpp>
+#include <box/AxisAlignedBoundingBox.hpp>
+#include <util/OrthonormalBase.hpp>
+
+namespace renderer {
+    /*
+     * 无限平面类，由平面上一点和法向量确定，用于地面、水面等无边界的表面
+     * 包围盒在平面方向上无限延伸，加速结构会将其放入单独的列表中，不参与划分
+     */
+    class InfinitePlane final : public AbstractHittable {
+    private:
+        Point3 point;
+        Vec3 normalVector;  //单位法向量
+        Real planeD;      //平面方程n · P = D
+
+        //平面内的两个正交方向，用于计算纹理坐标
+        OrthonormalBase base;
+
+        ResourceHandle material;
+
+    public:
+        InfinitePlane(ResourceHandle material, const Point3 & point, const Vec3 & normal) :
+                point(point), normalVector(normal.unitVector()), base(normal, 2), material(material)
+        {
+            planeD = Vec3::dot(normalVector, point.toVector());
+
+            //法向量和某个坐标轴平行时，平面在该轴上的范围只有一个点，其余轴上无限延伸
+            Range range[3];
+            for (int i = 0; i < 3; i++) {
+                const bool isParallel = floatValueNearZero(normalVector[(i + 1) % 3]) && floatValueNearZero(normalVector[(i + 2) % 3]);
+                range[i] = isParallel ? Range(point[i], point[i]) : Range(-INFINITY, INFINITY);
+            }
+            setBounds(AxisAlignedBoundingBox(range[0], range[1], range[2]));
+        }
+
+        ~InfinitePlane() override = default;
+
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            //光线参数t = (D - n · P) / (n · d)，光线和平面平行时没有交点
+            const Real NDotD = Vec3::dot(normalVector, ray.getDirection());
+            if (floatValueNearZero(NDotD)) {
+                return false;
+            }
+
+            const Real t = (planeD - Vec3::dot(normalVector, ray.getOrigin().toVector())) / NDotD;
+            if (!range.inRange(t)) {
+                return false;
+            }
+
+            record.t = t;
+            record.object = this;
+            return true;
+        }
+
+        void finalize(const Ray & ray, HitRecord & record) const override {
+            record.hitPoint = ray.at(record.t);
+            record.material = material;
+
+            //纹理坐标为交点在平面内两个正交方向上的坐标，不限制在[0, 1]内
+            const Vec3 local = Point3::constructVector(point, record.hitPoint);
+            record.uvPair = std::pair<Real, Real>(Vec3::dot(local, base[0]), Vec3::dot(local, base[1]));
+
+            record.hitFrontFace = Vec3::dot(normalVector, ray.getDirection()) < 0.0;
+            record.normalVector = record.hitFrontFace ? normalVector : -normalVector;
+        }
+
+        // ====== 类封装函数 ======
+
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * plane = dynamic_cast<const InfinitePlane *>(&obj);
+            if (plane == null) return false;
+            return point == plane->point && normalVector == plane->normalVector && material == plane->material;
+        }
+
+        std::string toString() const override {
+            return "Infinite Plane: Point = " + renderer::toString(point) + ", Normal = " + renderer::toString(normalVector);
+        }
+    };
+}
+
+#endif //RENDERERTEST_INFINITEPLANE_HPP
@@ -2,6 +2,7 @@
 #define RENDERERTEST_PARALLELOGRAM_HPP
 
 #include <hittable/HittableCollection.hpp>
+#include <material/AbstractMaterial.hpp>
 
 namespace renderer {
     /*
@@ -13,29 +14,29 @@ namespace renderer {
         Point3 q;
         Vec3 u, v;
         //四边形的面积
-        double area;
+        Real area;
 
-        std::shared_ptr<AbstractMaterial> material;
+        ResourceHandle material;
 
         //判断光线和四边形相交的属性
         Vec3 normalVector; //四边形所在平面的法向量
-        double planeD;     //平面一般方程Ax + By + Cz = D，由常量D和法向量(A, B, C)确定
+        Real planeD;     //平面一般方程Ax + By + Cz = D，由常量D和法向量(A, B, C)确定
 
     public:
-        Parallelogram(const std::shared_ptr<AbstractMaterial> & material, const Point3 & q, const Vec3 & u, const Vec3 & v):
+        Parallelogram(ResourceHandle material, const Point3 & q, const Vec3 & u, const Vec3 & v):
                 material(material), q(q), u(u), v(v)
         {
             //将四个顶点都包进包围盒中
             const auto boundBox1 = AxisAlignedBoundingBox(q, q + u + v);
             const auto boundBox2 = AxisAlignedBoundingBox(q + u, q + v);
-            this->boundingBox = std::make_shared<AxisAlignedBoundingBox>(boundBox1, boundBox2);
+            setBounds(AxisAlignedBoundingBox(boundBox1, boundBox2));
 
             //计算四边形所在平面的属性
             this->normalVector = Vec3::cross(u, v);
             this->area = normalVector.length(); //|u||v|sin(theta)
             this->normalVector.unitize();
 
-            double sum = 0.0;
+            Real sum = 0.0;
             for (int i = 0; i < 3; i++) {
                 sum += normalVector[i] * q[i]; //D = Ax + By + Cz
             }
@@ -43,20 +44,20 @@ namespace renderer {
         }
         ~Parallelogram() override = default;
 
-        bool hit(const Ray & ray, const Range & range, HitRecord & hitInfo) const override {
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
             //光线参数t = (D - n · P) / (n · d)
             //若(n · d) = 0，则光线和四边形所在平面平行
-            const double NDotD = Vec3::dot(normalVector, ray.getDirection());
+            const Real NDotD = Vec3::dot(normalVector, ray.getDirection());
             if (floatValueNearZero(NDotD)) {
                 return false;
             }
 
             //计算光线和四边形所在无限平面的交点参数t
-            double NDotP = 0.0;
+            Real NDotP = 0.0;
             for (int i = 0; i < 3; i++) {
                 NDotP += normalVector[i] * ray.getOrigin()[i];
             }
-            const double t = (planeD - NDotP) / NDotD;
+            const Real t = (planeD - NDotP) / NDotD;
             if (!range.inRange(t)) {
                 return false;
             }
@@ -65,41 +66,45 @@ namespace renderer {
             const Point3 intersection = ray.at(t);
             const Vec3 p = Point3::constructVector(q, intersection);
             const Vec3 normal = Vec3::cross(u, v);
-            const double denominator = normal.lengthSquare(); // |u x v|^2
+            const Real denominator = normal.lengthSquare(); // |u x v|^2
 
             if (floatValueNearZero(denominator)) {
                 return false; // u 和 v 平行，无法构成平行四边形
             }
 
-            const double alpha = Vec3::dot(Vec3::cross(p, v), normal) / denominator;
-            const double beta = Vec3::dot(Vec3::cross(u, p), normal) / denominator;
+            const Real alpha = Vec3::dot(Vec3::cross(p, v), normal) / denominator;
+            const Real beta = Vec3::dot(Vec3::cross(u, p), normal) / denominator;
 
             const Range coefficientRange(0.0, 1.0);
             if (!coefficientRange.inRange(alpha) || !coefficientRange.inRange(beta)) {
                 return false;
             }
 
-            //记录碰撞信息
-            hitInfo.t = t;
-            hitInfo.hitPoint = intersection;
-            hitInfo.material = material;
-            hitInfo.uvPair = std::pair<double, double>(alpha, beta);
-            hitInfo.hitFrontFace = Vec3::dot(ray.getDirection(), normalVector) < 0.0;
-            hitInfo.normalVector = hitInfo.hitFrontFace ? normalVector : -normalVector;
+            record.t = t;
+            record.object = this;
+            record.params = std::pair<Real, Real>(alpha, beta);
             return true;
         }
 
-        double pdfValue(const Point3 &origin, const Vec3 &direction) const override {
+        void finalize(const Ray & ray, HitRecord & record) const override {
+            record.hitPoint = ray.at(record.t);
+            record.material = material;
+            record.uvPair = record.params;
+            record.hitFrontFace = Vec3::dot(ray.getDirection(), normalVector) < 0.0;
+            record.normalVector = record.hitFrontFace ? normalVector : -normalVector;
+        }
+
+        Real pdfValue(const Point3 &origin, const Vec3 &direction) const override {
             HitRecord record;
             //检查方向有效性，确保从origin沿direction方向能够直接指向光源
-            if (!this->hit(Ray(origin, direction), Range(0.001, INFINITY), record)) {
+            if (!this->intersect(Ray(origin, direction), Range(0.001, INFINITY), record)) {
                 return 0.0;
             }
 
             //从origin到q（光源上随机点）的向量为 record.t * direction
-            const double distanceSquare = (record.t * direction).lengthSquare();
-            //向量点积公式：cos(theta) = a dot b / |a| |b|，其中|b| = 1
-            const double cosine = std::abs(Vec3::dot(direction, record.normalVector) / direction.length());
+            const Real distanceSquare = (record.t * direction).lengthSquare();
+            //向量点积公式：cos(theta) = a dot b / |a| |b|，其中|b| = 1，取绝对值后和法向量的朝向无关
+            const Real cosine = std::abs(Vec3::dot(direction, normalVector) / direction.length());
             return distanceSquare / (cosine * area);
         }
 
@@ -108,10 +113,16 @@ namespace renderer {
             return Point3::constructVector(origin, to);
         }
 
+        //仿射变换保持边向量表示的系数不变，变换q、u、v即可，纹理坐标不变
+        std::shared_ptr<AbstractHittable> bake(const AffineTransform & transform) const override {
+            return std::make_shared<Parallelogram>(material, transform.transformPoint(q),
+                                                   transform.transformVector(u), transform.transformVector(v));
+        }
+
         // ====== 静态操作函数 ======
 
-        //构造由6个长方形构成的长方体，以a和b为对角点
-        static std::shared_ptr<HittableCollection> constructBox(const std::shared_ptr<AbstractMaterial> & mat, const Point3 & a, const Point3 & b) {
+        //构造由6个长方形构成的长方体，以a和b为对角点。轴对齐长方体使用Box求交更快，此函数保留用于需要单独访问各个面的场景
+        static std::shared_ptr<HittableCollection> constructBox(ResourceHandle mat, const Point3 & a, const Point3 & b) {
             //找出a和b的大小关系
             Point3 min, max;
             for (int i = 0; i < 3; i++) {
@@ -152,7 +163,7 @@ namespace renderer {
 
         std::string toString() const override {
             char buffer[TOSTRING_BUFFER_SIZE];
-            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Parallelogram: %p, Q: %s, (U, V): (%s, %s)", this, q.toString().c_str(), u.toString().c_str(), v.toString().c_str());
+            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Parallelogram: %p, Q: %s, (U, V): (%s, %s)", this, renderer::toString(q).c_str(), renderer::toString(u).c_str(), renderer::toString(v).c_str());
             return {buffer};
         }
     };
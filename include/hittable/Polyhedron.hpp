@@ -3,6 +3,7 @@
 
 #include <hittable/Triangle.hpp>
 #include <box/AxisAlignedBoundingBox.hpp>
+#include <util/KernelDispatch.hpp>
 
 namespace renderer {
     /*
@@ -15,36 +16,51 @@ namespace renderer {
         std::vector<Triangle> triangles;
 
         //三个轴的范围
-        double bounds[6] {};
+        Real bounds[6] {};
+
+        //SoA布局的顶点和边向量，依次为第一个顶点、e1、e2的x、y、z分量，供批量求交计算核使用
+        std::array<std::vector<Real>, 9> triangleData;
 
     public:
         //使用三角形数组和三个轴向的范围构造多面体及其轴对齐包围盒
-        Polyhedron(const std::shared_ptr<AbstractMaterial> & material, const std::vector<Triangle> & triangles,
-                   const double bounds[6], const Vec3 & velocity = Vec3()) : triangles(triangles)
+        Polyhedron(ResourceHandle material, const std::vector<Triangle> & triangles,
+                   const Real bounds[6], const Vec3 & velocity = Vec3()) : triangles(triangles)
         {
-            auto box = std::make_shared<AxisAlignedBoundingBox>();
+            AxisAlignedBoundingBox box;
             for (size_t i = 0; i < 6; i += 2) {
-                (*box)[i / 2] = Range(bounds[i], bounds[i + 1]);
+                box[i / 2] = Range(bounds[i], bounds[i + 1]);
             }
-            this->boundingBox = box;
-            memcpy(this->bounds, bounds, 6 * sizeof(double));
-        }
-        ~Polyhedron() override = default;
+            setBounds(box);
+            memcpy(this->bounds, bounds, 6 * sizeof(Real));
 
-        bool hit(const Ray & ray, const Range & range, HitRecord & record) const override {
-            double closestT = range.getMax();
-            bool isHit = false;
-            HitRecord tempRecord;
-
-            //对每个三角形进行求交测试，写法同HittableCollection类
             for (const auto & triangle : triangles) {
-                if (triangle.hit(ray, Range(range.getMin(), closestT), tempRecord)) {
-                    isHit = true;
-                    closestT = tempRecord.t;
-                    record = tempRecord;
+                for (size_t i = 0; i < 3; i++) {
+                    triangleData[i].push_back(triangle.getApex(0)[i]);
+                    triangleData[i + 3].push_back(triangle.getEdge1()[i]);
+                    triangleData[i + 6].push_back(triangle.getEdge2()[i]);
                 }
             }
-            return isHit;
+        }
+        ~Polyhedron() override = default;
+
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            //使用批量计算核找到最近的三角形，计算核给出的重心坐标直接交给该三角形的finalize使用
+            const Real origin[3] = {ray.getOrigin()[0], ray.getOrigin()[1], ray.getOrigin()[2]};
+            const Real direction[3] = {ray.getDirection()[0], ray.getDirection()[1], ray.getDirection()[2]};
+            const Real * data[9];
+            for (size_t i = 0; i < 9; i++) {
+                data[i] = triangleData[i].data();
+            }
+            Real t, u, v;
+            const size_t index = KernelDispatch::kernels().triangleHit(data, triangles.size(), origin, direction,
+                                                                         range.getMin(), range.getMax(), t, u, v);
+            if (index == triangles.size()) {
+                return false;
+            }
+            record.t = t;
+            record.object = &triangles[index];
+            record.params = std::pair<Real, Real>(u, v);
+            return true;
         }
 
         // ====== 类封装函数 ======
@@ -0,0 +1,111 @@
+#ifndef RENDERERTEST_PROCEDURALNODE_HPP
+#define RENDERERTEST_PROCEDURALNODE_HPP
+
+#include <box/BVHTree.hpp>
+#include <hittable/AbstractHittable.hpp>
+#include <util/GeometryCache.hpp>
+
+namespace renderer {
+    /*
+     * 延迟生成的程序化物体：构造时只给出范围和生成函数，光线第一次进入范围时才调用生成函数并在内部构造BVH
+     *
+     * 展开的内容由多个节点共享的GeometryCacheT管理，总量超过容量时按LRU换出，之后再次被光线进入时重新生成
+     * 场景中可以放置任意多的节点，内存占用只取决于被光线访问的节点和缓存容量
+     * 多个线程同时进入同一个未展开的节点时只生成一次，其他线程等待
+     *
+     * 对生成函数的要求：
+     *   1. 结果是确定的：换出后重新生成必须得到相同的物体，随机内容应当使用由节点位置等确定的种子，不能使用全局的randomDouble
+     *   2. 物体不超出构造时给出的范围，超出的部分可能不会被击中
+     *   3. 物体从参数arena中分配，展开占用的内存按arena计算；使用make_shared分配的物体不计入缓存容量
+     *      图元只内联存储Bounds，不另外分配包围盒，BVH节点的包围盒在树的分配器中，因此两个分配器的容量就是展开的全部内存
+     *   4. 材质需要在渲染前登记到场景资源中（渲染期间资源表只读，登记会抛出异常），生成函数只使用已有的材质句柄
+     */
+    class ProceduralNode final : public AbstractHittable {
+    public:
+        typedef std::function<void(SceneArena & arena, std::vector<std::shared_ptr<AbstractHittable>> & objects)> Generator;
+
+        //展开的物体分配器的内存块大小，一次展开通常只有几十个物体
+        static constexpr size_t ARENA_BLOCK_SIZE = 4 * 1024;
+
+        //一次展开的结果，物体和BVH节点分别在展开的分配器和树的分配器中，换出后整体释放
+        struct Expansion {
+            SceneArena arena {ARENA_BLOCK_SIZE};
+            std::shared_ptr<BVHTree> tree;
+            size_t objectCount = 0;
+            size_t bytes = 0;
+
+            size_t memoryUsage() const { return bytes; }
+        };
+
+        typedef GeometryCacheT<Expansion> Cache;
+
+    private:
+        const AxisAlignedBoundingBox box;
+        const Generator generator;
+        const std::shared_ptr<Cache> cache;
+        const size_t index;
+        const Cache::Loader loader;
+
+        std::shared_ptr<Expansion> expand() const {
+            auto expansion = std::make_shared<Expansion>();
+            std::vector<std::shared_ptr<AbstractHittable>> objects;
+            generator(expansion->arena, objects);
+            expansion->tree = std::make_shared<BVHTree>(objects);
+            expansion->objectCount = objects.size();
+            expansion->bytes = sizeof(Expansion) + sizeof(BVHTree) + expansion->arena.capacity() + expansion->tree->memoryUsage();
+            return expansion;
+        }
+
+    public:
+        //cache可以由多个节点共享，容量为所有节点展开内容的总字节数
+        ProceduralNode(const Point3 & minimum, const Point3 & maximum, Generator generator, const std::shared_ptr<Cache> & cache) :
+            box(minimum, maximum), generator(std::move(generator)), cache(cache), index(cache->addChunk()),
+            loader([this](size_t) { return expand(); })
+        {
+            setBounds(box);
+        }
+        ~ProceduralNode() override = default;
+
+        ProceduralNode(const ProceduralNode &) = delete;
+        ProceduralNode & operator=(const ProceduralNode &) = delete;
+
+        /*
+         * 光线没有进入范围时不展开；展开的内容可能在finalize之前被其他线程换出，
+         * 因此和Transform相同，求交成功时立即完成碰撞信息的填写，记录的物体为节点本身，finalize不需要再做任何事
+         */
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            if (!box.hit(ray, range)) {
+                return false;
+            }
+            const auto expansion = cache->acquire(index, loader);
+            if (!expansion->tree->intersect(ray, range, record)) {
+                return false;
+            }
+            record.object->finalize(ray, record);
+            record.object = this;
+            return true;
+        }
+
+        //展开前不知道内容的代价，按包围盒加一个物体估计
+        double hitCost() const override {
+            return box.hitCost() + 1.5;
+        }
+
+        // ====== 类封装函数 ======
+
+        const std::shared_ptr<Cache> & getCache() const { return cache; }
+
+        //当前是否已展开并驻留
+        bool isExpanded() const { return cache->contains(index); }
+
+        bool equals(const AbstractObject &obj) const override { return this == &obj; }
+
+        std::string toString() const override {
+            char buffer[TOSTRING_BUFFER_SIZE];
+            snprintf(buffer, TOSTRING_BUFFER_SIZE, "ProceduralNode: %p, Box: %s", this, box.toString().c_str());
+            return {buffer};
+        }
+    };
+}
+
+#endif //RENDERERTEST_PROCEDURALNODE_HPP
@@ -0,0 +1,63 @@
+#ifndef RENDERERTEST_RAYRECORDER_HPP
+#define RENDERERTEST_RAYRECORDER_HPP
+
+#include <hittable/AbstractHittable.hpp>
+
+namespace renderer {
+    //记录的一条光线及其有效范围，tMax为光线实际碰撞到的最近交点（没有碰撞时为检查范围的最大值）
+    struct RecordedRay {
+        Ray ray;
+        Real tMin;
+        Real tMax;
+    };
+
+    /*
+     * 光线记录器：包装一个物体，将所有对其进行的求交查询转发给物体，同时记录光线和求交结果
+     * 用于在预渲染中收集真实的光线分布，交给BVHOptimizer优化加速结构
+     */
+    class RayRecorder final : public AbstractHittable {
+    private:
+        std::shared_ptr<AbstractHittable> object;
+        mutable std::vector<RecordedRay> rays;
+
+    public:
+        explicit RayRecorder(const std::shared_ptr<AbstractHittable> & object) : object(object) {
+            setBounds(object->getBounds());
+        }
+
+        ~RayRecorder() override = default;
+
+        //只转发求交，碰撞信息由被撞击的物体自己填写
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            const bool isHit = object->intersect(ray, range, record);
+            rays.push_back({ray, range.getMin(), isHit ? record.t : range.getMax()});
+            return isHit;
+        }
+
+        const std::vector<RecordedRay> & getRays() const { return rays; }
+
+        //包围盒和被包装的物体相同，不另外保存
+        std::shared_ptr<AbstractBoundingBox> getBoundingBox() const override {
+            return object->getBoundingBox();
+        }
+
+        bool isInFrustum(const Frustum & frustum) const override {
+            return object->isInFrustum(frustum);
+        }
+
+        // ====== 类封装函数 ======
+
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * recorder = dynamic_cast<const RayRecorder *>(&obj);
+            if (recorder == null) return false;
+            return object == recorder->object;
+        }
+
+        std::string toString() const override {
+            return "Ray Recorder: Recorded Ray Count = " + std::to_string(rays.size()) + ", Object = " + object->toString();
+        }
+    };
+}
+
+#endif //RENDERERTEST_RAYRECORDER_HPP
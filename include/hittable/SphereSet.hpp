@@ -0,0 +1,208 @@
+#ifndef RENDERERTEST_SPHERESET_HPP
+#define RENDERERTEST_SPHERESET_HPP
+
+#include <hittable/Sphere.hpp>
+#include <box/FlatBVH.hpp>
+#include <util/KernelDispatch.hpp>
+
+namespace renderer {
+    /*
+     * 球体集合的输入数据，球心和速度按分量连续存放
+     * 速度为空时所有球体静止，否则第i个球体在时间t的球心为centers[i] + t * velocities[i]（和运动Sphere相同，t在[0, 1]内）
+     * 材质下标为空时所有球体使用第一个材质
+     */
+    struct SphereBuffers {
+        std::vector<Real> centers;      //每个球体3个分量
+        std::vector<Real> radii;
+        std::vector<Real> velocities;   //每个球体3个分量
+        std::vector<Uint16> materials;  //每个球体在材质数组中的下标
+    };
+
+    /*
+     * 大量粒子组成的球体集合：不为每个球体创建物体、包围盒和材质句柄
+     * 球心、半径和速度按SoA布局存放，内部使用扁平数组存储的BVH，每个叶子最多包含LEAF_SIZE个球体
+     * 求交时一次调用批量求交计算核测试叶子中的所有球体，finalize时才计算法向量和纹理坐标
+     *
+     * 构造时按BVH叶子的顺序重排所有数组，叶子中的球体在数组中连续，计算核可以直接读取
+     * 静止球体每个约占4个标量和1/4个BVH节点，double版本一千万个球体约480MB，float版本约240MB
+     */
+    class SphereSet final : public AbstractHittable {
+    public:
+        //叶子节点最多包含的球体个数，是所有向量包宽度的整数倍（AVX-512的float除外）
+        static constexpr size_t LEAF_SIZE = 8;
+
+        typedef FlatBVH<LEAF_SIZE> BVH;
+        typedef BVH::Node Node;
+
+    private:
+        //按叶子顺序排列的球心x、y、z和半径
+        std::array<std::vector<Real>, 4> spheres;
+        //按叶子顺序排列的速度x、y、z，静止的集合为空
+        std::array<std::vector<Real>, 3> velocities;
+        std::vector<Uint16> materialIndices;
+        std::vector<ResourceHandle> materials;
+        std::vector<Node> nodes;
+
+        //第i个球体在整个运动过程中的包围盒
+        static Bounds sphereBounds(const SphereBuffers & buffers, size_t i) {
+            const Real radius = buffers.radii[i] > 0.0 ? buffers.radii[i] : 0.0;
+            Bounds bounds;
+            for (size_t axis = 0; axis < 3; axis++) {
+                const Real from = buffers.centers[3 * i + axis];
+                const Real to = buffers.velocities.empty() ? from : from + buffers.velocities[3 * i + axis];
+                bounds.minimum[axis] = std::min(from, to) - radius;
+                bounds.maximum[axis] = std::max(from, to) + radius;
+            }
+            return bounds;
+        }
+
+        Point3 centerAt(size_t i, Real time) const {
+            Point3 center(spheres[0][i], spheres[1][i], spheres[2][i]);
+            if (isMoving()) {
+                for (size_t axis = 0; axis < 3; axis++) {
+                    center[axis] += time * velocities[axis][i];
+                }
+            }
+            return center;
+        }
+
+    public:
+        //使用材质数组和球体数据构造集合，数组长度不匹配或材质下标越界时抛出异常
+        SphereSet(const std::vector<ResourceHandle> & materialList, const SphereBuffers & buffers) : materials(materialList) {
+            const size_t count = buffers.radii.size();
+            if (count == 0) {
+                throw std::runtime_error("Sphere set has no sphere!");
+            }
+            if (count > std::numeric_limits<Uint32>::max()) {
+                throw std::runtime_error("Sphere set has too many spheres!");
+            }
+            if (buffers.centers.size() != 3 * count || (!buffers.velocities.empty() && buffers.velocities.size() != 3 * count) ||
+                (!buffers.materials.empty() && buffers.materials.size() != count)) {
+                throw std::runtime_error("Sphere attribute count does not match sphere count!");
+            }
+            if (materialList.empty()) {
+                throw std::runtime_error("Sphere set has no material!");
+            }
+            for (const auto index : buffers.materials) {
+                if (index >= materialList.size()) {
+                    throw std::runtime_error("Sphere material index out of range!");
+                }
+            }
+            //构造BVH
+            std::vector<BVH::BuildEntry> entries(count);
+            for (size_t i = 0; i < count; i++) {
+                entries[i].bounds = sphereBounds(buffers, i);
+                entries[i].primitive = static_cast<Uint32>(i);
+            }
+            nodes = BVH::build(entries);
+
+            //按叶子顺序重排数据，和Sphere相同，负半径视为0
+            for (auto & array : spheres) {
+                array.resize(count);
+            }
+            if (!buffers.velocities.empty()) {
+                for (auto & array : velocities) {
+                    array.resize(count);
+                }
+            }
+            if (!buffers.materials.empty()) {
+                materialIndices.resize(count);
+            }
+            for (size_t i = 0; i < count; i++) {
+                const size_t source = entries[i].primitive;
+                for (size_t axis = 0; axis < 3; axis++) {
+                    spheres[axis][i] = buffers.centers[3 * source + axis];
+                    if (isMoving()) velocities[axis][i] = buffers.velocities[3 * source + axis];
+                }
+                spheres[3][i] = buffers.radii[source] > 0.0 ? buffers.radii[source] : 0.0;
+                if (!materialIndices.empty()) materialIndices[i] = buffers.materials[source];
+            }
+
+            const Bounds & bounds = nodes[0].bounds;
+            setBounds(AxisAlignedBoundingBox(bounds[0], bounds[1], bounds[2]));
+        }
+
+        //所有球体使用同一个材质
+        SphereSet(ResourceHandle material, const SphereBuffers & buffers) :
+            SphereSet(std::vector<ResourceHandle> {material}, buffers) {}
+
+        ~SphereSet() override = default;
+
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            const Real origin[3] = {ray.getOrigin()[0], ray.getOrigin()[1], ray.getOrigin()[2]};
+            const Real direction[3] = {ray.getDirection()[0], ray.getDirection()[1], ray.getDirection()[2]};
+            const KernelTable & kernels = KernelDispatch::kernels();
+
+            return BVH::intersect(nodes.data(), ray, range, [&](const Node & node, Real & closest) {
+                const size_t offset = node.offset;
+                const Real * data[4] = {spheres[0].data() + offset, spheres[1].data() + offset,
+                                        spheres[2].data() + offset, spheres[3].data() + offset};
+                //运动的球体先计算叶子中每个球体在光线时间的球心
+                Real moved[3][LEAF_SIZE];
+                if (isMoving()) {
+                    for (size_t axis = 0; axis < 3; axis++) {
+                        for (size_t lane = 0; lane < node.count; lane++) {
+                            moved[axis][lane] = data[axis][lane] + ray.getTime() * velocities[axis][offset + lane];
+                        }
+                        data[axis] = moved[axis];
+                    }
+                }
+                Real t;
+                const size_t lane = kernels.sphereHit(data, node.count, origin, direction, range.getMin(), closest, t);
+                if (lane == node.count) {
+                    return false;
+                }
+                closest = t;
+                record.t = t;
+                record.object = this;
+                record.primitive = static_cast<Uint32>(offset + lane);
+                return true;
+            });
+        }
+
+        //和Sphere::finalize相同
+        void finalize(const Ray & ray, HitRecord & record) const override {
+            const Uint32 i = record.primitive;
+            record.hitPoint = ray.at(record.t);
+            record.material = materials[materialIndices.empty() ? 0 : materialIndices[i]];
+
+            const Vec3 outwardNormal = Point3::constructVector(centerAt(i, ray.getTime()), record.hitPoint).unitVector();
+            record.hitFrontFace = Vec3::dot(ray.getDirection(), outwardNormal) < 0.0;
+            record.normalVector = record.hitFrontFace ? outwardNormal : -outwardNormal;
+            record.uvPair = Sphere::mapUVPair(Point3(outwardNormal));
+        }
+
+        //遍历内部BVH的开销随球体个数对数增长
+        double hitCost() const override {
+            return 1.5 + std::log2(static_cast<double>(sphereCount()));
+        }
+
+        // ====== 类封装函数 ======
+
+        size_t sphereCount() const { return spheres[3].size(); }
+        bool isMoving() const { return !velocities[0].empty(); }
+
+        //球体数据和内部BVH的字节数
+        size_t memoryUsage() const {
+            return sizeof(Real) * (isMoving() ? 7 : 4) * sphereCount() + sizeof(Uint16) * materialIndices.size() +
+                   sizeof(ResourceHandle) * materials.size() + sizeof(Node) * nodes.size();
+        }
+
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * set = dynamic_cast<const SphereSet *>(&obj);
+            if (set == null) return false;
+            return spheres == set->spheres && velocities == set->velocities && materialIndices == set->materialIndices &&
+                   materials == set->materials;
+        }
+
+        std::string toString() const override {
+            char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
+            snprintf(buffer, TOSTRING_BUFFER_SIZE, "%s SphereSet: Spheres = %zu, Materials = %zu, BVH nodes = %zu",
+                     isMoving() ? "Moving" : "Static", sphereCount(), materials.size(), nodes.size());
+            return {buffer};
+        }
+    };
+}
+
+#endif //RENDERERTEST_SPHERESET_HPP
@@ -0,0 +1,175 @@
+#ifndef RENDERERTEST_STREAMEDMESH_HPP
+#define RENDERERTEST_STREAMEDMESH_HPP
+
+#include <box/BVHTree.hpp>
+#include <util/GeometryCache.hpp>
+
+namespace renderer {
+    /*
+     * 外存网格：网格按空间划分为多个块存放在磁盘文件中，只有被光线访问的块才载入内存
+     *
+     * 文件布局（小端序）：文件头（Header），各块的网格文件（MeshFile格式，起点按MeshFile::SECTION_ALIGNMENT对齐），块表（ChunkEntry数组）
+     * 构造时只读取文件头和块表，每个块用一个代理物体表示，代理物体的包围盒来自块表，由内存中的BVHTree管理
+     * 光线进入代理物体的包围盒时通过GeometryCache获取块，未驻留的块从文件中读入，缓存超过容量时按LRU换出
+     * 场景总大小可以远超内存，内存占用只取决于缓存容量，访问的块超过容量时只是变慢（反复载入），不会耗尽内存
+     *
+     * 逐条求交（hit和intersect）遇到未驻留的块时阻塞载入
+     * 批量求交先只测试已驻留的块，遇到未驻留的块的光线被推迟并按块分组，之后逐个载入块并测试该块的所有推迟光线
+     * 每个块在一批中最多载入一次（完成求交记录时再获取一次），避免不同光线交替访问不同的块时缓存反复换入换出
+     *
+     * 求交记录中的物体为块的代理物体，finalize时重新从缓存获取块（通常仍驻留）
+     */
+    class StreamedMesh final : public AbstractHittable {
+    public:
+        static constexpr char MAGIC[4] = {'R', 'S', 'T', 'M'};
+        static constexpr Uint32 VERSION = 1;
+
+        struct Header {
+            char magic[4];
+            Uint32 version;
+            Uint64 chunkCount;
+            Uint64 tableOffset;     //块表的偏移量
+            Uint64 triangleCount;
+            double bounds[6];       //依次为x、y、z轴的最小值和最大值
+        };
+
+        struct ChunkEntry {
+            Uint64 offset;          //块的网格文件的偏移量
+            Uint64 size;            //块的网格文件的字节数
+            Uint64 triangleCount;
+            double bounds[6];
+        };
+
+        //逐块写入外存网格文件，每个块只需要在写入时位于内存中，close后文件才有效
+        class Writer {
+        private:
+            FILE * file;
+            std::string path;
+            Uint64 position;
+            Header header;
+            std::vector<ChunkEntry> table;
+
+            void write(const void * data, size_t size);
+
+        public:
+            explicit Writer(const std::string & path);
+            ~Writer();
+
+            Writer(const Writer &) = delete;
+            Writer & operator=(const Writer &) = delete;
+
+            //写入一个块，块内构造自己的BVH，buffers中的索引会被重排和补齐
+            void addChunk(MeshBuffers buffers);
+
+            //写入块表和文件头
+            void close();
+        };
+
+        //将网格按空间划分为每块不超过trianglesPerChunk个三角形的块并写入文件
+        static void write(const std::string & path, const MeshBuffers & buffers, size_t trianglesPerChunk);
+
+    private:
+        //块的代理物体
+        class Chunk final : public AbstractHittable {
+        private:
+            GeometryCache & cache;
+            const size_t index;
+            const double cost;
+
+        public:
+            Chunk(GeometryCache & cache, size_t index, const ChunkEntry & entry);
+            ~Chunk() override = default;
+
+            //使用已获取的块求交，击中时记录中的物体为代理物体
+            bool intersect(const TriangleMesh & mesh, const Ray & ray, const Range & range, HitRecord & record) const {
+                if (!mesh.intersect(ray, range, record)) {
+                    return false;
+                }
+                record.object = this;
+                return true;
+            }
+
+            bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override;
+
+            void finalize(const Ray & ray, HitRecord & record) const override {
+                cache.acquire(index)->finalize(ray, record);
+            }
+
+            double hitCost() const override { return cost; }
+
+            size_t getIndex() const { return index; }
+
+            bool equals(const AbstractObject &obj) const override { return this == &obj; }
+            std::string toString() const override;
+        };
+
+        //批量求交时推迟的光线，只在当前线程的批量求交过程中有效
+        struct Deferral {
+            Uint32 ray;                             //正在求交的光线下标
+            std::vector<std::vector<Uint32>> rays;  //每个块推迟的光线下标
+        };
+
+        std::string path;
+        ResourceHandle material;
+        std::shared_ptr<GeometryCache> cache;
+        std::vector<std::shared_ptr<Chunk>> chunks;
+        std::shared_ptr<BVHTree> tree;
+        size_t totalTriangleCount;
+
+        static Deferral *& currentDeferral() {
+            static thread_local Deferral * deferral = null;
+            return deferral;
+        }
+
+        //从文件中读入一个块
+        static std::shared_ptr<TriangleMesh> loadChunk(const std::string & path, const ChunkEntry & entry, ResourceHandle material);
+
+    public:
+        //cacheCapacity为最多驻留的块的字节数
+        StreamedMesh(ResourceHandle material, const std::string & path, size_t cacheCapacity);
+        ~StreamedMesh() override = default;
+
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            return tree->intersect(ray, range, record);
+        }
+
+        //finalize由记录中的块的代理物体完成，不会调用到这里
+        void finalize(const Ray & ray, HitRecord & record) const override {
+            record.object->finalize(ray, record);
+        }
+
+        /*
+         * 批量求交，records[i]和isHit[i]为rays[i]的结果，相当于逐条调用hit，击中的记录已经完成finalize
+         * 不同线程可以同时对同一个网格批量求交
+         */
+        void intersect(const std::vector<Ray> & rays, const Range & range, std::vector<HitRecord> & records, std::vector<bool> & isHit) const;
+
+        double hitCost() const override { return tree->hitCost(); }
+
+        void frustumEntries(const Frustum & frustum, std::vector<const AbstractHittable *> & entries) const override {
+            tree->frustumEntries(frustum, entries);
+        }
+
+        //包围盒和块的BVH相同
+        std::shared_ptr<AbstractBoundingBox> getBoundingBox() const override { return tree->getBoundingBox(); }
+        bool isInFrustum(const Frustum & frustum) const override { return tree->isInFrustum(frustum); }
+
+        // ====== 类封装函数 ======
+
+        size_t chunkCount() const { return chunks.size(); }
+        size_t triangleCount() const { return totalTriangleCount; }
+        GeometryCache::Statistics getCacheStatistics() const { return cache->getStatistics(); }
+
+        //同一个文件使用相同材质构造的网格相等
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * mesh = dynamic_cast<const StreamedMesh *>(&obj);
+            if (mesh == null) return false;
+            return path == mesh->path && material == mesh->material;
+        }
+
+        std::string toString() const override;
+    };
+}
+
+#endif //RENDERERTEST_STREAMEDMESH_HPP
@@ -1,20 +1,20 @@
 #ifndef RENDERERTEST_TRANSFORM_HPP
 #define RENDERERTEST_TRANSFORM_HPP
 
-#include <hittable/AbstractHittable.hpp>
+#include <hittable/AbstractBoxedHittable.hpp>
+#include <box/BoundingBoxSelector.hpp>
 
 namespace renderer {
     /*
      * 变换类，包含指向物体的指针，变换矩阵及其逆矩阵，以及变换后的包围盒
      */
-    class Transform final : public AbstractHittable {
+    class Transform final : public AbstractBoxedHittable {
     private:
         std::shared_ptr<AbstractHittable> object;
 
-        //4 x 4变换矩阵
-        Matrix transformMatrix;
-        Matrix transformInverse;
-        Matrix transformInverseTranspose; //逆矩阵的转置，用于变换法线
+        //仿射变换矩阵及其逆矩阵，法线使用transformMatrix中保存的逆转置变换
+        AffineTransform transformMatrix;
+        AffineTransform transformInverse;
 
         //变换后物体的包围盒
         //std::shared_ptr<AbstractBoundingBox> boundingBox;
@@ -25,58 +25,59 @@ namespace renderer {
         explicit Transform(const std::shared_ptr<AbstractHittable> & object,
             const std::array<double, 3> & rotate = {}, const std::array<double, 3> & shift = {}, const std::array<double, 3> & scale = {1.0, 1.0, 1.0}) :
             object(object),
-            transformMatrix(4, 4), transformInverse(4, 4), transformInverseTranspose(4, 4)
-        {
             //M = T * R * S，平移 * 旋转 * 缩放
-            const auto m1 = Matrix::constructShiftMatrix(shift);
-            const auto m2 = Matrix::constructRotateMatrix(rotate);
-            const auto m3 = Matrix::constructScaleMatrix(scale);
-            transformMatrix = m1 * m2 * m3;
-            transformInverse = transformMatrix.inverse();
-            transformInverseTranspose = transformInverse.transpose();
-
-            //变换包围盒
-            this->boundingBox = object->getBoundingBox()->transformBoundingBox(transformMatrix);
+            transformMatrix(AffineTransform::shift(shift) * AffineTransform::rotate(rotate) * AffineTransform::scale(scale)),
+            transformInverse(transformMatrix.inverse())
+        {
+
+            //变换包围盒，旋转后的物体可能使用有向包围盒或k-DOP
+            setBoundingBox(BoundingBoxSelector::transform(object->getBoundingBox(), transformMatrix, hitCost()));
         }
 
-        //默认调用Matrix类的析构函数
-        ~Transform() override = default;
+        //直接使用变换矩阵构造，场景优化器合并嵌套的变换时使用
+        Transform(const std::shared_ptr<AbstractHittable> & object, const AffineTransform & transformMatrix) :
+            object(object), transformMatrix(transformMatrix), transformInverse(transformMatrix.inverse())
+        {
+            setBoundingBox(BoundingBoxSelector::transform(object->getBoundingBox(), transformMatrix, hitCost()));
+        }
 
-        bool hit(const Ray &ray, const Range &range, HitRecord &record) const override {
-            /*
-             * 将世界空间光线变换到物体的局部空间：使用逆矩阵分别对ray的起点和方向向量进行变换
-             * 只有左矩阵的列数和右矩阵的行数相同的矩阵才能相乘，则将三维点变为1列4行的列向量
-             */
-            auto rayOrigin = Matrix::toMatrix(ray.getOrigin().toVector(), 1.0);
-            auto rayDirection = Matrix::toMatrix(ray.getDirection(), 0.0);
-            rayOrigin = transformInverse * rayOrigin;
-            rayDirection = transformInverse * rayDirection;
+        ~Transform() override = default;
 
-            //构造变换后的光线
-            const Ray transformed(rayOrigin.toPoint(), rayDirection.toPoint().toVector(), ray.getTime());
+        /*
+         * 局部空间中的碰撞信息需要使用变换后的光线计算，因此求交成功时立即在局部空间中完成碰撞信息的填写并变换回世界空间
+         * 此时record记录的物体为变换本身，finalize不需要再做任何事
+         */
+        bool intersect(const Ray &ray, const Range &range, HitRecord &record) const override {
+            //将世界空间光线变换到物体的局部空间：使用逆矩阵分别对ray的起点和方向向量进行变换
+            const Ray transformed(transformInverse.transformPoint(ray.getOrigin()),
+                                  transformInverse.transformVector(ray.getDirection()), ray.getTime());
 
             //在物体空间中对变换后的光线进行相交测试
-            if (!object->hit(transformed, range, record)) {
+            if (!object->intersect(transformed, range, record)) {
                 return false;
             } else {
-                //如果有碰撞，则将将局部空间的命中记录变换回世界空间，t值和uv坐标不需要变换
-                //变换碰撞点
-                auto point = Matrix::toMatrix(record.hitPoint.toVector(), 1.0);
-                point = transformMatrix * point;
-                record.hitPoint = point.toPoint();
-
-                //使用逆转置变换矩阵变换法向量
-                //向量不受平移影响，将w分量设置为0可完成此目的
-                auto normal = Matrix::toMatrix(record.normalVector, 0.0);
-                normal = transformInverseTranspose * normal;
-                record.normalVector = normal.toPoint().toVector().unitVector();
-                record.hitFrontFace = Vec3::dot(ray.getDirection(), record.normalVector) < 0.0;
+                //如果有碰撞，则在局部空间中填写命中记录，再将其变换回世界空间，t值和uv坐标不需要变换
+                record.object->finalize(transformed, record);
+                record.object = this;
+
+                //变换碰撞点，使用逆转置矩阵变换法向量
+                record.hitPoint = transformMatrix.transformPoint(record.hitPoint);
+                //(M^-T * n) · (M * d) = n · d，变换后的法向量仍然朝向光线一侧，局部空间中判断的正反面不变
+                record.normalVector = transformMatrix.transformNormal(record.normalVector).unitVector();
                 return true;
             }
         }
 
+        //变换光线、交点和法线共四次3 x 4矩阵乘法，约为轴对齐包围盒测试的4倍
+        double hitCost() const override {
+            return 4.0 + object->hitCost();
+        }
+
         // ====== 类封装函数 ======
 
+        const std::shared_ptr<AbstractHittable> & getObject() const { return object; }
+        const AffineTransform & getTransformMatrix() const { return transformMatrix; }
+
         bool equals(const AbstractObject &obj) const override {
             if (this == &obj) return true;
             const auto * trans = dynamic_cast<const Transform *>(&obj);
@@ -86,7 +87,7 @@ namespace renderer {
 
         std::string toString() const override {
             std::string ret("Transform: Object = ");
-            return ret + object->toString() + "Transform matrix = " + transformMatrix.toString();
+            return ret + object->toString() + "Transform matrix = " + renderer::toString(transformMatrix);
         }
     };
 }
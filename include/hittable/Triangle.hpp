@@ -2,6 +2,7 @@
 #define RENDERERTEST_TRIANGLE_HPP
 
 #include <hittable/AbstractHittable.hpp>
+#include <material/AbstractMaterial.hpp>
 
 namespace renderer {
     /*
@@ -19,11 +20,11 @@ namespace renderer {
         //预计算两个边向量
         Vec3 e1, e2;
 
-        std::shared_ptr<AbstractMaterial> material;
+        ResourceHandle material;
 
     public:
         //使用三个顶点构造三角形，面法向量垂直于三角形平面
-        Triangle(const std::shared_ptr<AbstractMaterial> & material, const Point3 & p1, const Point3 & p2, const Point3 & p3) : material(material) {
+        Triangle(ResourceHandle material, const Point3 & p1, const Point3 & p2, const Point3 & p3) : material(material) {
             apex[0] = p1; apex[1] = p2; apex[2] = p3;
             e1 = Point3::constructVector(p1, p2);
             e2 = Point3::constructVector(p1, p3);
@@ -41,11 +42,11 @@ namespace renderer {
                     std::max({p1[1], p2[1], p3[1]}),
                     std::max({p1[2], p2[2], p3[2]})
             );
-            this->boundingBox = std::make_shared<AxisAlignedBoundingBox>(minPoint, maxPoint);
+            setBounds(AxisAlignedBoundingBox(minPoint, maxPoint));
         }
 
         //使用三个顶点和独立的顶点法向量构造三角形
-        Triangle(const std::shared_ptr<AbstractMaterial> & material, const Point3 & p1, const Point3 & p2, const Point3 & p3,
+        Triangle(ResourceHandle material, const Point3 & p1, const Point3 & p2, const Point3 & p3,
                  const Vec3 & normal1, const Vec3 & normal2, const Vec3 & normal3) : material(material)
         {
             apex[0] = p1; apex[1] = p2; apex[2] = p3;
@@ -68,14 +69,14 @@ namespace renderer {
                     std::max({p1[1], p2[1], p3[1]}),
                     std::max({p1[2], p2[2], p3[2]})
             );
-            this->boundingBox = std::make_shared<AxisAlignedBoundingBox>(minPoint, maxPoint);
+            setBounds(AxisAlignedBoundingBox(minPoint, maxPoint));
         }
         ~Triangle() override = default;
 
-        bool hit(const Ray & ray, const Range & range, HitRecord & record) const override {
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
             const Vec3 h = ray.getDirection().cross(e2); //h = d x e2
             //系数行列式
-            const double detA = e1.dot(h); //detA = e1 * (d x e2)
+            const Real detA = e1.dot(h); //detA = e1 * (d x e2)
 
             //行列式为0，说明方程组无解或有无穷解（光线和三角形平行或有无数个交点）
             if (floatValueNearZero(detA)) {
@@ -86,7 +87,7 @@ namespace renderer {
 
             //计算未知数U并检查
             const Range coefficientRange(0.0, 1.0);
-            const double u = s.dot(h) / detA; // u = (s · h) / det
+            const Real u = s.dot(h) / detA; // u = (s · h) / det
             if (!coefficientRange.inRange(u)) {
                 return false;
             }
@@ -94,29 +95,51 @@ namespace renderer {
             const Vec3 q = s.cross(e1);  // q = s × e1
 
             //计算未知数V并检查
-            const double v = ray.getDirection().dot(q) / detA; // v = (D · q) / det
+            const Real v = ray.getDirection().dot(q) / detA; // v = (D · q) / det
             if (!coefficientRange.inRange(v) || u + v > 1.0) {
                 return false;
             }
 
-            //满足相交条件，计算碰撞参数
-            record.t = e2.dot(q) / detA; // t = (e2 · q) / det
-            if (!range.inRange(record.t)) {
+            //满足相交条件，记录t值和重心坐标
+            const Real t = e2.dot(q) / detA; // t = (e2 · q) / det
+            if (!range.inRange(t)) {
                 return false;
             }
+            record.t = t;
+            record.object = this;
+            record.params = std::pair<Real, Real>(u, v);
+            return true;
+        }
+
+        void finalize(const Ray & ray, HitRecord & record) const override {
+            const Real u = record.params.first;
+            const Real v = record.params.second;
             record.hitPoint = ray.at(record.t);
             record.material = material;
-            record.uvPair = std::pair<double, double>(u, v);
+            record.uvPair = record.params;
 
             //交点法向量为三个顶点法向量的插值平滑
             const Vec3 n = ((1.0 - u - v) * normalVector[0] + u * normalVector[1] + v * normalVector[2]).unitVector();
             record.hitFrontFace = Vec3::dot(ray.getDirection(), n) < 0.0;
             record.normalVector = record.hitFrontFace ? n : -n;
-            return true;
+        }
+
+        /*
+         * 仿射变换保持重心坐标不变，变换顶点和顶点法向量即可
+         * 顶点法向量变换后不单位化：插值结果和先插值再变换只差一个正的系数，单位化后和Transform得到的法向量相同
+         */
+        std::shared_ptr<AbstractHittable> bake(const AffineTransform & transform) const override {
+            return std::make_shared<Triangle>(material,
+                                              transform.transformPoint(apex[0]), transform.transformPoint(apex[1]), transform.transformPoint(apex[2]),
+                                              transform.transformNormal(normalVector[0]), transform.transformNormal(normalVector[1]), transform.transformNormal(normalVector[2]));
         }
 
         // ====== 类封装函数 ======
 
+        const Point3 & getApex(size_t index) const { return apex[index]; }
+        const Vec3 & getEdge1() const { return e1; }
+        const Vec3 & getEdge2() const { return e2; }
+
         bool equals(const AbstractObject &obj) const override {
             if (this == &obj) return true;
             const auto * t = dynamic_cast<const Triangle *>(&obj);
@@ -127,7 +150,7 @@ namespace renderer {
         std::string toString() const override {
             std::string ret("Triangle: ");
             for (const auto & i : apex) {
-                ret += "P1 = " + i.toString() + " ";
+                ret += "P1 = " + renderer::toString(i) + " ";
             }
             return ret;
         }
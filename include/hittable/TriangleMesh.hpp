@@ -0,0 +1,408 @@
+#ifndef RENDERERTEST_TRIANGLEMESH_HPP
+#define RENDERERTEST_TRIANGLEMESH_HPP
+
+#include <hittable/AbstractHittable.hpp>
+#include <material/AbstractMaterial.hpp>
+#include <box/AxisAlignedBoundingBox.hpp>
+#include <box/FlatBVH.hpp>
+#include <util/KernelDispatch.hpp>
+#include <util/VertexCompression.hpp>
+
+namespace renderer {
+    /*
+     * 索引三角形网格的顶点缓冲区
+     * 顶点、法向量和纹理坐标按分量连续存放，每个三角形在索引缓冲区中占3个顶点下标
+     * 法向量和纹理坐标可以为空，为空时分别使用面法向量和重心坐标
+     */
+    struct MeshBuffers {
+        std::vector<Real> vertices;     //每个顶点3个分量
+        std::vector<Real> normals;      //每个顶点3个分量
+        std::vector<Real> uvs;          //每个顶点2个分量
+        std::vector<Uint32> indices;    //每个三角形3个顶点下标
+    };
+
+    /*
+     * 索引三角形网格：所有三角形共享顶点缓冲区，整个网格只有一个材质句柄
+     * 网格内部使用扁平数组存储的BVH划分三角形，不为每个三角形创建物体和包围盒
+     * 每个三角形约占索引缓冲区中的12字节、打包叶子中的9个标量和1/4个BVH节点（叶子未填满时按LEAF_SIZE个位置计算）
+     * 顶点本身约为三角形个数的一半，全部使用Real时每个顶点占8个标量
+     *
+     * 构造时按BVH叶子的顺序重排索引缓冲区，每个叶子在索引缓冲区中占LEAF_SIZE个连续的位置，不足的位置用(0, 0, 0)补齐
+     * 每个叶子的三角形顶点另外按SoA布局打包（packets），求交时一次调用水密求交计算核测试整个叶子，补齐的位置顶点全为0，不会被击中
+     * 求交时只记录最近三角形的下标和重心坐标，finalize时再读取顶点数据插值法向量和纹理坐标
+     *
+     * 网格只通过View中的裸指针访问数据，数组可以由网格自己持有，也可以直接位于内存映射的网格文件中（见MeshFile）
+     * storage负责保持数组有效，网格不关心它的具体类型
+     *
+     * 顶点属性可以压缩存储（见VertexCompression和AttributeFormat），压缩的法向量和纹理坐标只在finalize中解码
+     * 压缩顶点坐标时不再保存顶点缓冲区，打包叶子改为相对网格范围的16位定点数（packedPackets），求交前逐个叶子解码到栈上
+     * 构造时先把顶点坐标对齐到量化网格，再构造BVH，因此节点包围盒和解码后的顶点完全一致；
+     * 共享的顶点解码为相同的值，相邻三角形之间仍然是水密的，但交点和原始网格相差不超过量化间隔的一半（网格范围的1/131070）
+     */
+    class TriangleMesh final : public AbstractHittable {
+    public:
+        //叶子节点最多包含的三角形个数，也是一个打包叶子的宽度，是所有向量包宽度的整数倍（AVX-512的float除外）
+        static constexpr size_t LEAF_SIZE = 8;
+
+        typedef FlatBVH<LEAF_SIZE> BVH;
+        //BVH节点，叶子节点的offset为第一个三角形在补齐后的索引缓冲区中的位置（LEAF_SIZE的整数倍）
+        typedef BVH::Node Node;
+
+        //顶点属性的存储格式
+        enum class AttributeFormat {
+            FULL,                   //全部使用Real
+            COMPRESSED,             //法向量使用32位八面体编码，纹理坐标使用16位定点数
+            COMPRESSED_POSITIONS    //在COMPRESSED的基础上，打包叶子中的顶点坐标使用相对网格范围的16位定点数，不保存顶点缓冲区
+        };
+
+        //网格数据的只读视图，没有法向量或纹理坐标时对应的指针为null
+        //每种属性的未压缩数组和压缩数组最多只有一个不为null，packets和packedPackets恰好有一个不为null
+        struct View {
+            const Real * vertices;              //压缩顶点坐标时为null
+            const Real * normals;
+            const Real * uvs;
+            const Uint32 * packedNormals;       //每个顶点1个八面体编码
+            const Uint16 * packedUVs;           //每个顶点2个16位定点数
+            VertexCompression::Quantization vertexQuantization[3];
+            VertexCompression::Quantization uvQuantization[2];
+            const Uint32 * indices;             //按BVH叶子顺序排列，每个叶子3 * LEAF_SIZE个下标
+            const Real * packets;               //每个叶子9 * LEAF_SIZE个标量，依次为三个顶点的x、y、z分量数组
+            const Uint16 * packedPackets;       //布局和packets相同的16位定点数，按vertexQuantization解码
+            const Node * nodes;
+            size_t vertexCount;
+            size_t triangleCount;       //不包括补齐的位置
+            size_t packetCount;         //即叶子个数
+            size_t nodeCount;
+        };
+
+    private:
+        //网格自己持有数据时使用的存储
+        struct OwnedStorage {
+            MeshBuffers buffers;
+            std::vector<Real> packets;
+            std::vector<Node> nodes;
+            std::vector<Uint16> packedPackets;
+            std::vector<Uint32> packedNormals;
+            std::vector<Uint16> packedUVs;
+        };
+
+        std::shared_ptr<const void> storage;
+        View view;
+        ResourceHandle material;
+
+        //打包叶子中第primitive个位置的三角形的第j个顶点
+        Point3 packetVertex(Uint32 primitive, size_t j) const {
+            const size_t lane = primitive % LEAF_SIZE;
+            const size_t first = 9 * static_cast<size_t>(primitive - lane) + 3 * j * LEAF_SIZE + lane;
+            if (view.packedPackets != null) {
+                const Uint16 * packet = view.packedPackets + first;
+                return Point3(VertexCompression::dequantize(packet[0], view.vertexQuantization[0]),
+                              VertexCompression::dequantize(packet[LEAF_SIZE], view.vertexQuantization[1]),
+                              VertexCompression::dequantize(packet[2 * LEAF_SIZE], view.vertexQuantization[2]));
+            }
+            const Real * packet = view.packets + first;
+            return Point3(packet[0], packet[LEAF_SIZE], packet[2 * LEAF_SIZE]);
+        }
+
+        Vec3 normal(Uint32 index) const {
+            if (view.packedNormals != null) {
+                return VertexCompression::decodeNormal(view.packedNormals[index]);
+            }
+            return Vec3(view.normals[3 * index], view.normals[3 * index + 1], view.normals[3 * index + 2]);
+        }
+
+        std::pair<Real, Real> uv(Uint32 index) const {
+            if (view.packedUVs != null) {
+                return std::pair<Real, Real>(VertexCompression::dequantize(view.packedUVs[2 * index], view.uvQuantization[0]),
+                                             VertexCompression::dequantize(view.packedUVs[2 * index + 1], view.uvQuantization[1]));
+            }
+            return std::pair<Real, Real>(view.uvs[2 * index], view.uvs[2 * index + 1]);
+        }
+
+        /*
+         * 将顶点坐标对齐到量化网格上，在构造BVH之前调用，保证节点包围盒由解码后的顶点计算
+         * 对齐后的坐标再次量化得到相同的定点数，解码的结果也和这里完全相同
+         */
+        static void snapVertices(std::vector<Real> & vertices, VertexCompression::Quantization * quantizations) {
+            for (size_t axis = 0; axis < 3; axis++) {
+                quantizations[axis] = VertexCompression::quantization(vertices, axis, 3);
+            }
+            for (size_t i = 0; i < vertices.size(); i++) {
+                const VertexCompression::Quantization & quantization = quantizations[i % 3];
+                vertices[i] = VertexCompression::dequantize(VertexCompression::quantize(vertices[i], quantization), quantization);
+            }
+        }
+
+        //压缩顶点属性，被压缩的原数组清空并释放；压缩顶点坐标时顶点已经由snapVertices对齐
+        static void compress(OwnedStorage & owned, View & view, AttributeFormat format) {
+            if (format == AttributeFormat::FULL) {
+                return;
+            }
+            MeshBuffers & buffers = owned.buffers;
+            if (!buffers.normals.empty()) {
+                owned.packedNormals.resize(buffers.normals.size() / 3);
+                for (size_t i = 0; i < owned.packedNormals.size(); i++) {
+                    owned.packedNormals[i] = VertexCompression::encodeNormal(buffers.normals[3 * i], buffers.normals[3 * i + 1], buffers.normals[3 * i + 2]);
+                }
+                std::vector<Real>().swap(buffers.normals);
+            }
+            if (!buffers.uvs.empty()) {
+                owned.packedUVs = VertexCompression::quantize(buffers.uvs, 2, view.uvQuantization);
+                std::vector<Real>().swap(buffers.uvs);
+            }
+            if (format == AttributeFormat::COMPRESSED_POSITIONS) {
+                //打包叶子中第i个标量属于第(i / LEAF_SIZE) % 3个坐标轴，补齐位置的三个顶点仍然相同，不会被击中
+                owned.packedPackets.resize(owned.packets.size());
+                for (size_t i = 0; i < owned.packets.size(); i++) {
+                    owned.packedPackets[i] = VertexCompression::quantize(owned.packets[i], view.vertexQuantization[(i / LEAF_SIZE) % 3]);
+                }
+                std::vector<Real>().swap(owned.packets);
+                std::vector<Real>().swap(buffers.vertices);
+            }
+        }
+
+        void initBoundingBox() {
+            const Bounds & bounds = view.nodes[0].bounds;
+            setBounds(AxisAlignedBoundingBox(bounds[0], bounds[1], bounds[2]));
+        }
+
+    public:
+        //使用顶点缓冲区构造网格，format为顶点属性的存储格式，索引越界或缓冲区长度不匹配时抛出异常
+        TriangleMesh(ResourceHandle material, MeshBuffers meshBuffers, AttributeFormat format = AttributeFormat::FULL) :
+            view(), material(material)
+        {
+            auto owned = std::make_shared<OwnedStorage>();
+            owned->buffers = std::move(meshBuffers);
+            if (format == AttributeFormat::COMPRESSED_POSITIONS) {
+                snapVertices(owned->buffers.vertices, view.vertexQuantization);
+            }
+            owned->nodes = buildBVH(owned->buffers, owned->packets);
+            view.vertexCount = owned->buffers.vertices.size() / 3;
+            view.packetCount = owned->packets.size() / (9 * LEAF_SIZE);
+            compress(*owned, view, format);
+
+            const MeshBuffers & buffers = owned->buffers;
+            view.vertices = buffers.vertices.empty() ? null : buffers.vertices.data();
+            view.normals = buffers.normals.empty() ? null : buffers.normals.data();
+            view.uvs = buffers.uvs.empty() ? null : buffers.uvs.data();
+            view.packedNormals = owned->packedNormals.empty() ? null : owned->packedNormals.data();
+            view.packedUVs = owned->packedUVs.empty() ? null : owned->packedUVs.data();
+            view.indices = buffers.indices.data();
+            view.packets = owned->packets.empty() ? null : owned->packets.data();
+            view.packedPackets = owned->packedPackets.empty() ? null : owned->packedPackets.data();
+            view.nodes = owned->nodes.data();
+            view.nodeCount = owned->nodes.size();
+            for (const auto & node : owned->nodes) {
+                view.triangleCount += node.count;
+            }
+            storage = std::move(owned);
+            initBoundingBox();
+        }
+
+        //使用外部数据构造网格，不拷贝数据，storage需要在网格的生命周期内保持view中的数组有效
+        TriangleMesh(ResourceHandle material, std::shared_ptr<const void> storage, const View & view) :
+            storage(std::move(storage)), view(view), material(material)
+        {
+            if ((view.packets == null) == (view.packedPackets == null) || view.indices == null || view.nodes == null ||
+                view.triangleCount == 0 || view.packetCount == 0 || view.nodeCount == 0) {
+                throw std::runtime_error("Invalid mesh view!");
+            }
+            initBoundingBox();
+        }
+
+        /*
+         * 检查顶点缓冲区并构造BVH，同时将索引缓冲区按叶子顺序重排并补齐，打包的叶子写入packets，返回BVH节点数组
+         * 索引越界或缓冲区长度不匹配时抛出异常
+         */
+        static std::vector<Node> buildBVH(MeshBuffers & buffers, std::vector<Real> & packets) {
+            const size_t vertexCount = buffers.vertices.size() / 3;
+            if (buffers.vertices.size() % 3 != 0 || buffers.indices.size() % 3 != 0) {
+                throw std::runtime_error("Mesh buffer size is not a multiple of 3!");
+            }
+            if (buffers.indices.empty()) {
+                throw std::runtime_error("Mesh has no triangle!");
+            }
+            if ((!buffers.normals.empty() && buffers.normals.size() != 3 * vertexCount) ||
+                (!buffers.uvs.empty() && buffers.uvs.size() != 2 * vertexCount)) {
+                throw std::runtime_error("Mesh attribute count does not match vertex count!");
+            }
+            for (const auto index : buffers.indices) {
+                if (index >= vertexCount) {
+                    throw std::runtime_error("Mesh vertex index out of range!");
+                }
+            }
+
+            //计算每个三角形的包围盒并构造BVH
+            const size_t triangleCount = buffers.indices.size() / 3;
+            std::vector<BVH::BuildEntry> entries(triangleCount);
+            for (size_t i = 0; i < triangleCount; i++) {
+                for (size_t j = 0; j < 3; j++) {
+                    entries[i].bounds.merge(&buffers.vertices[3 * buffers.indices[3 * i + j]]);
+                }
+                entries[i].primitive = static_cast<Uint32>(i);
+            }
+            std::vector<Node> nodes = BVH::build(entries);
+
+            //按叶子顺序重排索引缓冲区并打包叶子，节点中的三角形下标改为补齐后的下标
+            size_t packetCount = 0;
+            for (const auto & node : nodes) {
+                if (node.count > 0) packetCount++;
+            }
+            std::vector<Uint32> indices(3 * LEAF_SIZE * packetCount, 0);
+            packets.assign(9 * LEAF_SIZE * packetCount, 0.0);
+            size_t packet = 0;
+            for (auto & node : nodes) {
+                if (node.count == 0) continue;
+                Real * target = &packets[9 * LEAF_SIZE * packet];
+                for (size_t lane = 0; lane < node.count; lane++) {
+                    const Uint32 * source = &buffers.indices[3 * entries[node.offset + lane].primitive];
+                    memcpy(&indices[3 * (LEAF_SIZE * packet + lane)], source, 3 * sizeof(Uint32));
+                    for (size_t j = 0; j < 3; j++) {
+                        for (size_t axis = 0; axis < 3; axis++) {
+                            target[(3 * j + axis) * LEAF_SIZE + lane] = buffers.vertices[3 * source[j] + axis];
+                        }
+                    }
+                }
+                node.offset = static_cast<Uint32>(LEAF_SIZE * packet++);
+            }
+            if (indices.size() > std::numeric_limits<Uint32>::max()) {
+                throw std::runtime_error("Mesh has too many triangles!");
+            }
+            buffers.indices.swap(indices);
+            return nodes;
+        }
+
+        ~TriangleMesh() override = default;
+
+        bool intersect(const Ray & ray, const Range & range, HitRecord & record) const override {
+            //水密求交的光线剪切变换：kz为方向绝对值最大的轴，kz为负时交换kx和ky以保持三角形的环绕方向
+            const Vec3 & direction = ray.getDirection();
+            const Point3 & rayOrigin = ray.getOrigin();
+            size_t kz = std::abs(direction[0]) > std::abs(direction[1]) ? 0 : 1;
+            kz = std::abs(direction[2]) > std::abs(direction[kz]) ? 2 : kz;
+            size_t kx = (kz + 1) % 3, ky = (kx + 1) % 3;
+            if (direction[kz] < 0.0) std::swap(kx, ky);
+            const size_t axes[3] = {kx, ky, kz};
+            const Real origin[3] = {rayOrigin[kx], rayOrigin[ky], rayOrigin[kz]};
+            const Real shear[3] = {direction[kx] / direction[kz], direction[ky] / direction[kz], static_cast<Real>(1) / direction[kz]};
+            const KernelTable & kernels = KernelDispatch::kernels();
+
+            return BVH::intersect(view.nodes, ray, range, [&](const Node & node, Real & closest) {
+                //整个叶子（包括补齐的位置）交给计算核，LEAF_SIZE是向量包宽度的整数倍时不需要复制末尾
+                const Real * packet = view.packets + 9 * static_cast<size_t>(node.offset);
+                Real decoded[9 * LEAF_SIZE];
+                if (view.packedPackets != null) {
+                    const Uint16 * packed = view.packedPackets + 9 * static_cast<size_t>(node.offset);
+                    for (size_t i = 0; i < 9 * LEAF_SIZE; i++) {
+                        decoded[i] = VertexCompression::dequantize(packed[i], view.vertexQuantization[(i / LEAF_SIZE) % 3]);
+                    }
+                    packet = decoded;
+                }
+                const Real * triangles[9];
+                for (size_t j = 0; j < 3; j++) {
+                    for (size_t axis = 0; axis < 3; axis++) {
+                        triangles[3 * j + axis] = packet + (3 * j + axes[axis]) * LEAF_SIZE;
+                    }
+                }
+                Real t, u, v;
+                const size_t lane = kernels.watertightTriangleHit(triangles, LEAF_SIZE, origin, shear, range.getMin(), closest, t, u, v);
+                if (lane == LEAF_SIZE) {
+                    return false;
+                }
+                closest = t;
+                record.t = t;
+                record.object = this;
+                record.params = std::pair<Real, Real>(u, v);
+                record.primitive = node.offset + static_cast<Uint32>(lane);
+                return true;
+            });
+        }
+
+        void finalize(const Ray & ray, HitRecord & record) const override {
+            const Real u = record.params.first;
+            const Real v = record.params.second;
+            const Real w = 1.0 - u - v;
+            const Uint32 * index = &view.indices[3 * record.primitive];
+            record.hitPoint = ray.at(record.t);
+            record.material = material;
+
+            Vec3 n;
+            if (view.normals == null && view.packedNormals == null) {
+                const Point3 p0 = packetVertex(record.primitive, 0);
+                n = Vec3::cross(Point3::constructVector(p0, packetVertex(record.primitive, 1)), Point3::constructVector(p0, packetVertex(record.primitive, 2)));
+            } else {
+                n = normal(index[0]) * w + normal(index[1]) * u + normal(index[2]) * v;
+            }
+            n = n.unitVector();
+            record.hitFrontFace = Vec3::dot(ray.getDirection(), n) < 0.0;
+            record.normalVector = record.hitFrontFace ? n : -n;
+
+            if (view.uvs == null && view.packedUVs == null) {
+                record.uvPair = record.params;
+            } else {
+                const auto uv0 = uv(index[0]), uv1 = uv(index[1]), uv2 = uv(index[2]);
+                record.uvPair = std::pair<Real, Real>(w * uv0.first + u * uv1.first + v * uv2.first, w * uv0.second + u * uv1.second + v * uv2.second);
+            }
+        }
+
+        //遍历内部BVH的开销随三角形个数对数增长
+        double hitCost() const override {
+            return 1.5 + std::log2(static_cast<double>(triangleCount()));
+        }
+
+        // ====== 类封装函数 ======
+
+        size_t triangleCount() const { return view.triangleCount; }
+        size_t vertexCount() const { return view.vertexCount; }
+        const View & getView() const { return view; }
+
+        //每个顶点的属性字节数
+        size_t vertexSize() const {
+            return (view.vertices != null ? 3 * sizeof(Real) : 0) +
+                   (view.normals != null ? 3 * sizeof(Real) : view.packedNormals != null ? sizeof(Uint32) : 0) +
+                   (view.uvs != null ? 2 * sizeof(Real) : view.packedUVs != null ? 2 * sizeof(Uint16) : 0);
+        }
+
+        //网格和内部BVH的数据字节数（数据位于映射文件中时为映射的字节数）
+        size_t memoryUsage() const {
+            const size_t packetScalarSize = view.packedPackets != null ? sizeof(Uint16) : sizeof(Real);
+            return vertexSize() * view.vertexCount + (3 * sizeof(Uint32) + 9 * packetScalarSize) * LEAF_SIZE * view.packetCount +
+                   sizeof(Node) * view.nodeCount;
+        }
+
+        //数据相同的网格相等，和数据是否由网格自己持有无关；存储格式不同的网格不相等
+        bool equals(const AbstractObject &obj) const override {
+            if (this == &obj) return true;
+            const auto * mesh = dynamic_cast<const TriangleMesh *>(&obj);
+            if (mesh == null) return false;
+            const View & other = mesh->view;
+            if (material != mesh->material || view.vertexCount != other.vertexCount || view.triangleCount != other.triangleCount ||
+                view.packetCount != other.packetCount ||
+                (view.vertices == null) != (other.vertices == null) || (view.packedPackets == null) != (other.packedPackets == null) ||
+                (view.normals == null) != (other.normals == null) || (view.packedNormals == null) != (other.packedNormals == null) ||
+                (view.uvs == null) != (other.uvs == null) || (view.packedUVs == null) != (other.packedUVs == null)) {
+                return false;
+            }
+            const auto same = [](const void * p1, const void * p2, size_t size) { return p1 == p2 || memcmp(p1, p2, size) == 0; };
+            const auto sameArray = [&](const void * p1, const void * p2, size_t size) { return p1 == null || same(p1, p2, size * view.vertexCount); };
+            return sameArray(view.vertices, other.vertices, 3 * sizeof(Real)) &&
+                   sameArray(view.normals, other.normals, 3 * sizeof(Real)) &&
+                   sameArray(view.uvs, other.uvs, 2 * sizeof(Real)) &&
+                   sameArray(view.packedNormals, other.packedNormals, sizeof(Uint32)) &&
+                   sameArray(view.packedUVs, other.packedUVs, 2 * sizeof(Uint16)) &&
+                   (view.packedPackets == null || (same(view.vertexQuantization, other.vertexQuantization, sizeof(view.vertexQuantization)) &&
+                                                   same(view.packedPackets, other.packedPackets, 9 * sizeof(Uint16) * LEAF_SIZE * view.packetCount))) &&
+                   (view.packedUVs == null || same(view.uvQuantization, other.uvQuantization, sizeof(view.uvQuantization))) &&
+                   same(view.indices, other.indices, 3 * sizeof(Uint32) * LEAF_SIZE * view.packetCount);
+        }
+
+        std::string toString() const override {
+            char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
+            snprintf(buffer, TOSTRING_BUFFER_SIZE, "TriangleMesh: Vertices = %zu, Triangles = %zu, BVH nodes = %zu",
+                     vertexCount(), triangleCount(), view.nodeCount);
+            return {buffer};
+        }
+    };
+}
+
+#endif //RENDERERTEST_TRIANGLEMESH_HPP
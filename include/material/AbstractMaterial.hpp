@@ -5,12 +5,13 @@
 #include <hittable/AbstractHittable.hpp>
 #include <util/OrthonormalBase.hpp>
 #include <util/AbstractPDF.hpp>
+#include <util/MemoryArena.hpp>
 
 namespace renderer {
-    //散射记录
+    //散射记录，pdf由当前线程的MemoryArena分配，在当前路径结束前有效
     struct ScatterRecord {
         Color3 attenuation;
-        std::shared_ptr<AbstractPDF> pdf;
+        const AbstractPDF * pdf;
         bool isSkipPDF;
         Ray skipPDFRay;
     };
@@ -26,8 +27,11 @@ namespace renderer {
         virtual bool scatter(const Ray & in, const HitRecord & record, ScatterRecord & scatterRecord) const = 0;
 
         //散光概率密度函数，定义对各个入射方向进行采样的概率
-        virtual double scatterPDF(const Ray & in, const HitRecord & record, const Ray & out) const { return 1.0; }
+        virtual Real scatterPDF(const Ray & in, const HitRecord & record, const Ray & out) const { return 1.0; }
     };
+
+    //材质表，物体和碰撞记录通过句柄引用材质
+    typedef ResourceTable<AbstractMaterial> MaterialTable;
 }
 
 #endif //RENDERERTEST_ABSTRACTMATERIAL_HPP
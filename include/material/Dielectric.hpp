@@ -11,20 +11,20 @@ namespace renderer {
     class Dielectric final : public AbstractMaterial {
     private:
         Color3 albedo;
-        double refractiveIndex;
+        Real refractiveIndex;
 
         //使用Schlick近似计算反射率
-        static double reflectance(double cosine, double refractiveIndex) {
-            double r0 = (1.0 - refractiveIndex) / (1.0 + refractiveIndex);
+        static Real reflectance(Real cosine, Real refractiveIndex) {
+            Real r0 = (1.0 - refractiveIndex) / (1.0 + refractiveIndex);
             r0 = r0 * r0;
             return r0 + (1.0 - r0) * std::pow((1.0 - cosine), 5.0);
         }
 
         //计算折射光线，要求i和n都是单位向量，需要根据光线的入射方向决定相对折射率
         Vec3 refract(const Vec3 & i, const Vec3 & n, bool isFrontFace) const {
-            const double cosTheta = Vec3::dot(-i, n);
-            const double sinTheta = std::sqrt(1.0 - cosTheta * cosTheta);
-            const double rate = isFrontFace ? 1.0 / refractiveIndex : refractiveIndex * 1.0; //根据入射方向确定折射率
+            const Real cosTheta = Vec3::dot(-i, n);
+            const Real sinTheta = std::sqrt(1.0 - cosTheta * cosTheta);
+            const Real rate = isFrontFace ? 1.0 / refractiveIndex : refractiveIndex * 1.0; //根据入射方向确定折射率
 
             //确定是否发生全反射
             if (sinTheta * rate > 1.0 || reflectance(cosTheta, refractiveIndex) > randomDouble()) {
@@ -39,7 +39,7 @@ namespace renderer {
         }
 
     public:
-        explicit Dielectric(double refractiveIndex = 1.0) :
+        explicit Dielectric(Real refractiveIndex = 1.0) :
                 //材质不吸收光
                 albedo(Color3(1.0, 1.0, 1.0)), refractiveIndex(refractiveIndex) {}
         ~Dielectric() override = default;
@@ -70,7 +70,7 @@ namespace renderer {
 
         std::string toString() const override {
             char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
-            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Dielectric: Albedo = %s, Refractive Index = %.4lf", albedo.toString().c_str(), refractiveIndex);
+            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Dielectric: Albedo = %s, Refractive Index = %.4lf", renderer::toString(albedo).c_str(), refractiveIndex);
             return {buffer};
         }
     };
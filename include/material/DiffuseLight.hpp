@@ -35,7 +35,7 @@ namespace renderer {
 
         std::string toString() const override {
             std::string ret("Diffuse Light: ");
-            return ret + light.toString();
+            return ret + renderer::toString(light);
         }
     };
 }
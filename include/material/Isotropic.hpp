@@ -23,12 +23,12 @@ namespace renderer {
             attenuation = albedo;
             pdfValue = 1.0 / (4.0 * PI);*/
             scatterRecord.attenuation = albedo;
-            scatterRecord.pdf = std::make_shared<UniformPDF>();
+            scatterRecord.pdf = MemoryArena::local().create<UniformPDF>();
             scatterRecord.isSkipPDF = false;
             return true;
         }
 
-        double scatterPDF(const Ray &in, const HitRecord &record, const Ray &out) const override {
+        Real scatterPDF(const Ray &in, const HitRecord &record, const Ray &out) const override {
             return 1.0 / (4.0 * PI);
         }
 
@@ -43,7 +43,7 @@ namespace renderer {
 
         std::string toString() const override {
             std::string ret("Isotropic: Albedo = ");
-            return ret + albedo.toString();
+            return ret + renderer::toString(albedo);
         }
     };
 }
@@ -10,10 +10,10 @@ namespace renderer {
     class Metal final : public AbstractMaterial {
     private:
         Color3 albedo;
-        double fuzz;
+        Real fuzz;
 
     public:
-        explicit Metal(const Color3 & albedo = Color3(1.0, 1.0, 1.0), double fuzz = 0.0) :
+        explicit Metal(const Color3 & albedo = Color3(1.0, 1.0, 1.0), Real fuzz = 0.0) :
             albedo(albedo), fuzz(fuzz)
         {
             this->fuzz = Range(0.0, 1.0).clamp(fuzz);
@@ -57,7 +57,7 @@ namespace renderer {
 
         std::string toString() const override {
             char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
-            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Metal: Albedo = %s, Fuzz = %.4lf", albedo.toString().c_str(), fuzz);
+            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Metal: Albedo = %s, Fuzz = %.4lf", renderer::toString(albedo).c_str(), fuzz);
             return {buffer};
         }
     };
@@ -11,11 +11,14 @@ namespace renderer {
      */
     class Rough final : public AbstractMaterial {
     private:
-        std::shared_ptr<AbstractTexture> texture;
+        const TextureTable * textures;  //纹理所在的场景纹理表
+        ResourceHandle texture;
 
     public:
-        explicit Rough(const std::shared_ptr<AbstractTexture> & texture) : texture(texture) {}
-        explicit Rough(const Color3 & albedo = Color3()) : texture(std::make_shared<SolidColor>(albedo)) {}
+        Rough(const TextureTable & textures, ResourceHandle texture) : textures(&textures), texture(texture) {}
+
+        //纯色纹理登记在场景的纹理表中，和场景一起释放
+        Rough(TextureTable & textures, const Color3 & albedo) : textures(&textures), texture(textures.add(std::make_shared<SolidColor>(albedo))) {}
         ~Rough() override = default;
 
         //粗糙材质：漫反射
@@ -44,13 +47,13 @@ namespace renderer {
             //材质采样PDF：与全局无关，只关心入射光线散射到出射方向的概率密度
             pdfValue = scatterPDF(in, record, out);*/
 
-            scatterRecord.attenuation = texture->value(record.uvPair, record.hitPoint);
-            scatterRecord.pdf = std::make_shared<CosinePDF>(record.normalVector);
+            scatterRecord.attenuation = textures->get(texture)->value(record.uvPair, record.hitPoint);
+            scatterRecord.pdf = MemoryArena::local().create<CosinePDF>(record.normalVector);
             scatterRecord.isSkipPDF = false;
             return true;
         }
 
-        double scatterPDF(const Ray & in, const HitRecord & record, const Ray & out) const override {
+        Real scatterPDF(const Ray & in, const HitRecord & record, const Ray & out) const override {
             //此处必须对out.getDirection()取单位向量
             return std::max(0.0, Vec3::dot(record.normalVector, out.getDirection().unitVector()) / PI);
         }
@@ -61,12 +64,12 @@ namespace renderer {
             if (this == &obj) return true;
             const auto * rough = dynamic_cast<const Rough *>(&obj);
             if (rough == null) return false;
-            return texture == rough->texture;
+            return textures == rough->textures && texture == rough->texture;
         }
 
         std::string toString() const override {
             std::string ret("Rough: Albedo = ");
-            return ret + texture->toString();
+            return ret + textures->get(texture)->toString();
         }
     };
 }
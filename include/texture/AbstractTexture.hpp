@@ -3,6 +3,7 @@
 
 #include <basic/Point3.hpp>
 #include <basic/Color3.hpp>
+#include <util/ResourceTable.hpp>
 
 namespace renderer {
     /*
@@ -13,8 +14,11 @@ namespace renderer {
         ~AbstractTexture() override = default;
 
         //纹理映射函数，通过二维UV坐标获取对应位置颜色
-        virtual Color3 value(const std::pair<double, double> & uvPair, const Point3 & point) const = 0;
+        virtual Color3 value(const std::pair<Real, Real> & uvPair, const Point3 & point) const = 0;
     };
+
+    //纹理表，材质和组合纹理通过句柄引用纹理
+    typedef ResourceTable<AbstractTexture> TextureTable;
 }
 
 #endif //RENDERERTEST_ABSTRACTTEXTURE_HPP
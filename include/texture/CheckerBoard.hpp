@@ -9,28 +9,30 @@ namespace renderer {
      */
     class CheckerBoard final : public AbstractTexture {
     private:
-        double scale; //表面方格的缩放比例
-        std::shared_ptr<AbstractTexture> even;
-        std::shared_ptr<AbstractTexture> odd;
+        const TextureTable * textures;  //方格纹理所在的场景纹理表
+        Real scale; //表面方格的缩放比例
+        ResourceHandle even;
+        ResourceHandle odd;
 
     public:
-        CheckerBoard(const std::shared_ptr<AbstractTexture> &even,
-                     const std::shared_ptr<AbstractTexture> &odd, double scale) : scale(scale), even(even), odd(odd) {}
-
-        explicit CheckerBoard(const Color3 & evenColor = Color3(1.0, 1.0, 1.0), const Color3 & oddColor = Color3(), double scale = 1.0) {
-            this->even = std::make_shared<SolidColor>(evenColor);
-            this->odd = std::make_shared<SolidColor>(oddColor);
-            this->scale = scale;
+        CheckerBoard(const TextureTable & textures, ResourceHandle even, ResourceHandle odd, Real scale) :
+                     textures(&textures), scale(scale), even(even), odd(odd) {}
+
+        //纯色纹理登记在场景的纹理表中，和场景一起释放
+        explicit CheckerBoard(TextureTable & textures, const Color3 & evenColor = Color3(1.0, 1.0, 1.0), const Color3 & oddColor = Color3(), Real scale = 1.0) :
+                     textures(&textures), scale(scale) {
+            this->even = textures.add(std::make_shared<SolidColor>(evenColor));
+            this->odd = textures.add(std::make_shared<SolidColor>(oddColor));
         }
         ~CheckerBoard() override = default;
 
-        Color3 value(const std::pair<double, double> &uvPair, const Point3 &point) const override {
+        Color3 value(const std::pair<Real, Real> &uvPair, const Point3 &point) const override {
             //根据传入的点坐标返回even纹理或odd纹理
             int sum = 0;
             for (Uint32 i = 0; i < 3; i++) {
                 sum += static_cast<int>(point[i] / scale);
             }
-            return sum % 2 == 0 ? even->value(uvPair, point) : odd->value(uvPair, point);
+            return textures->get(sum % 2 == 0 ? even : odd)->value(uvPair, point);
         }
 
         // ====== 类封装函数 ======
@@ -39,16 +41,17 @@ namespace renderer {
             if (this == &obj) return true;
             const auto * checkBoard = dynamic_cast<const CheckerBoard *>(&obj);
             if (checkBoard == null) return false;
-            return scale == checkBoard->scale && even == checkBoard->even && odd == checkBoard->odd;
+            return textures == checkBoard->textures && scale == checkBoard->scale && even == checkBoard->even && odd == checkBoard->odd;
         }
 
         std::string toString() const override {
-            return "Checker Board Texture: Even: " + even->toString() + ", Odd: " + odd->toString() + ", Scale: " + std::to_string(scale);
+            return "Checker Board Texture: Even: " + textures->get(even)->toString() + ", Odd: " + textures->get(odd)->toString() +
+                   ", Scale: " + std::to_string(scale);
         }
 
-        double getScale() const { return scale; }
-        const std::shared_ptr<AbstractTexture> &getEven() const { return even; }
-        const std::shared_ptr<AbstractTexture> &getOdd() const { return odd; }
+        Real getScale() const { return scale; }
+        const std::shared_ptr<AbstractTexture> &getEven() const { return textures->getShared(even); }
+        const std::shared_ptr<AbstractTexture> &getOdd() const { return textures->getShared(odd); }
     };
 }
 
@@ -30,13 +30,13 @@ namespace renderer {
         ~Image() override = default;
 
         //返回图像对应位置的像素颜色
-        Color3 value(const std::pair<double, double> & uvPair, const Point3 & point) const override {
+        Color3 value(const std::pair<Real, Real> & uvPair, const Point3 & point) const override {
             if (surface == null) {
                 return Color3(0.0, 1.0, 1.0);
             }
 
-            const double u = Range(0.0, 1.0).clamp(uvPair.first);
-            const double v = 1.0 - Range(0.0, 1.0).clamp(uvPair.second);
+            const Real u = Range(0.0, 1.0).clamp(uvPair.first);
+            const Real v = 1.0 - Range(0.0, 1.0).clamp(uvPair.second);
             const auto x = static_cast<Uint32>(u * (surface->w - 1));
             const auto y = static_cast<Uint32>(v * (surface->h - 1));
 
@@ -15,16 +15,16 @@ namespace renderer {
 
         //当前纹理选定的噪声函数
         PerlinNoiseType type;
-        double scale;
+        Real scale;
 
     public:
         //scale越大，条纹越密集
-        explicit PerlinNoise(double scale = 1.0, const PerlinNoiseType type = PerlinNoiseType::SMOOTHSTEP_INTERPOLATION)
+        explicit PerlinNoise(Real scale = 1.0, const PerlinNoiseType type = PerlinNoiseType::SMOOTHSTEP_INTERPOLATION)
             : generator(PerlinGenerator()), scale(scale), type(type) {}
         ~PerlinNoise() override = default;
 
         //根据选定的类型调用对应的生成函数
-        Color3 value(const std::pair<double, double> &uvPair, const Point3 &point) const override {
+        Color3 value(const std::pair<Real, Real> &uvPair, const Point3 &point) const override {
             const Point3 scaledPoint(scale * point[0], scale * point[1], scale * point[2]);
 
             switch (type) {
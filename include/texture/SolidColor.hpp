@@ -15,7 +15,7 @@ namespace renderer {
         explicit SolidColor(const Color3 & albedo = Color3()) : albedo(albedo) {}
         ~SolidColor() override = default;
 
-        Color3 value(const std::pair<double, double> &uvPair, const Point3 &point) const override {
+        Color3 value(const std::pair<Real, Real> &uvPair, const Point3 &point) const override {
             return albedo;
         }
 
@@ -30,7 +30,7 @@ namespace renderer {
 
         std::string toString() const override {
             std::string ret("SolidColor Texture: Albedo = ");
-            return ret + albedo.toString();
+            return ret + renderer::toString(albedo);
         }
 
         const Color3 & getAlbedo() const { return albedo; }
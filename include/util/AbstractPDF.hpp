@@ -15,7 +15,7 @@ namespace renderer {
         virtual Vec3 generate() const = 0;
 
         //根据传入的向量返回对应的PDF函数值
-        virtual double value(const Vec3 & vec) const = 0;
+        virtual Real value(const Vec3 & vec) const = 0;
     };
 }
 
@@ -0,0 +1,291 @@
+#ifndef RENDERERTEST_AFFINETRANSFORM_HPP
+#define RENDERERTEST_AFFINETRANSFORM_HPP
+
+#include <basic/Point3.hpp>
+
+#if defined(__SSE2__) || (defined(_MSC_VER) && defined(_M_X64))
+#define RENDERER_AFFINE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace renderer {
+    /*
+     * 3 x 4仿射变换矩阵，最后一行固定为(0, 0, 0, 1)，不再存储
+     *     | m00 m01 m02 tx |
+     *     | m10 m11 m12 ty |
+     *     | m20 m21 m22 tz |
+     *
+     * 值类型，全部数据在栈上，用于Transform物体和包围盒变换，替代堆上分配的Matrix
+     * 按列存储，每列补齐为4个分量：变换点/向量为各列的线性组合，SSE2下每列为一个（float）或两个（double）寄存器
+     * 同时保存线性部分逆矩阵的转置，用于法向量变换
+     */
+    class AffineTransform final {
+    private:
+        //columns[0..2]为线性部分的三列，columns[3]为平移
+        alignas(16) Real columns[4][4];
+
+        //线性部分逆矩阵的转置的三列，即逆矩阵的三行
+        alignas(16) Real normalColumns[3][4];
+
+        //计算线性部分的逆矩阵（伴随矩阵除以行列式），返回行列式
+        Real linearInverse(Real inverse[3][3]) const {
+            const auto m = [this](int r, int c) { return columns[c][r]; };
+            inverse[0][0] = m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+            inverse[0][1] = m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2);
+            inverse[0][2] = m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1);
+            inverse[1][0] = m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2);
+            inverse[1][1] = m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0);
+            inverse[1][2] = m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2);
+            inverse[2][0] = m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0);
+            inverse[2][1] = m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1);
+            inverse[2][2] = m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+
+            const Real det = m(0, 0) * inverse[0][0] + m(0, 1) * inverse[1][0] + m(0, 2) * inverse[2][0];
+            //奇异矩阵保留伴随矩阵，法向量变换后会重新单位化，方向仍然正确
+            const Real factor = det == 0.0 ? 1.0 : 1.0 / det;
+            for (int r = 0; r < 3; r++) {
+                for (int c = 0; c < 3; c++) {
+                    inverse[r][c] *= factor;
+                }
+            }
+            return det;
+        }
+
+        //修改线性部分后重新计算法向量变换矩阵
+        void updateNormalColumns() {
+            Real inverse[3][3];
+            linearInverse(inverse);
+            for (int c = 0; c < 3; c++) {
+                for (int r = 0; r < 3; r++) {
+                    normalColumns[c][r] = inverse[c][r];
+                }
+                normalColumns[c][3] = 0.0;
+            }
+        }
+
+        //按列组合：out = c[0] * x + c[1] * y + c[2] * z (+ c[3])，c为连续存放的列，每列4个分量
+#ifdef RENDERER_AFFINE_SSE2
+        template <bool ADD_LAST>
+        static void combine(const float * c, const float (&v)[3], float (&out)[4]) {
+            __m128 r = _mm_mul_ps(_mm_load_ps(c), _mm_set1_ps(v[0]));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(c + 4), _mm_set1_ps(v[1])));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(c + 8), _mm_set1_ps(v[2])));
+            if (ADD_LAST) r = _mm_add_ps(r, _mm_load_ps(c + 12));
+            _mm_storeu_ps(out, r);
+        }
+
+        template <bool ADD_LAST>
+        static void combine(const double * c, const double (&v)[3], double (&out)[4]) {
+            const __m128d x = _mm_set1_pd(v[0]), y = _mm_set1_pd(v[1]), z = _mm_set1_pd(v[2]);
+            __m128d low = _mm_mul_pd(_mm_load_pd(c), x);
+            __m128d high = _mm_mul_pd(_mm_load_pd(c + 2), x);
+            low = _mm_add_pd(low, _mm_mul_pd(_mm_load_pd(c + 4), y));
+            high = _mm_add_pd(high, _mm_mul_pd(_mm_load_pd(c + 6), y));
+            low = _mm_add_pd(low, _mm_mul_pd(_mm_load_pd(c + 8), z));
+            high = _mm_add_pd(high, _mm_mul_pd(_mm_load_pd(c + 10), z));
+            if (ADD_LAST) {
+                low = _mm_add_pd(low, _mm_load_pd(c + 12));
+                high = _mm_add_pd(high, _mm_load_pd(c + 14));
+            }
+            _mm_storeu_pd(out, low);
+            _mm_storeu_pd(out + 2, high);
+        }
+#else
+        template <bool ADD_LAST>
+        static void combine(const Real * c, const Real (&v)[3], Real (&out)[4]) {
+            for (int i = 0; i < 4; i++) {
+                out[i] = c[i] * v[0] + c[4 + i] * v[1] + c[8 + i] * v[2] + (ADD_LAST ? c[12 + i] : 0.0);
+            }
+        }
+#endif
+
+    public:
+        //构造单位变换
+        AffineTransform() {
+            for (int c = 0; c < 4; c++) {
+                for (int r = 0; r < 4; r++) {
+                    columns[c][r] = c == r && c < 3 ? 1.0 : 0.0;
+                }
+            }
+            updateNormalColumns();
+        }
+
+        //使用按行排列的3 x 4矩阵构造
+        explicit AffineTransform(const std::array<double, 12> & rowMajor) {
+            for (int c = 0; c < 4; c++) {
+                for (int r = 0; r < 3; r++) {
+                    columns[c][r] = static_cast<Real>(rowMajor[r * 4 + c]);
+                }
+                columns[c][3] = 0.0;
+            }
+            updateNormalColumns();
+        }
+
+        // ====== 对象操作函数 ======
+
+        //获取第row行第col列的元素，下标从0开始，第3列为平移
+        Real at(size_t row, size_t col) const { return columns[col][row]; }
+
+        Point3 transformPoint(const Point3 & point) const {
+            const Real v[3] = {point[0], point[1], point[2]};
+            Real out[4];
+            combine<true>(&columns[0][0], v, out);
+            return Point3(out[0], out[1], out[2]);
+        }
+
+        //向量不受平移影响
+        Vec3 transformVector(const Vec3 & vector) const {
+            const Real v[3] = {vector[0], vector[1], vector[2]};
+            Real out[4];
+            combine<false>(&columns[0][0], v, out);
+            return Vec3(out[0], out[1], out[2]);
+        }
+
+        //使用线性部分逆矩阵的转置变换法向量，结果不是单位向量
+        Vec3 transformNormal(const Vec3 & normal) const {
+            const Real v[3] = {normal[0], normal[1], normal[2]};
+            Real out[4];
+            combine<false>(&normalColumns[0][0], v, out);
+            return Vec3(out[0], out[1], out[2]);
+        }
+
+        //矩阵乘法，结果先应用right再应用当前变换
+        AffineTransform operator*(const AffineTransform & right) const {
+            AffineTransform ret;
+            for (int c = 0; c < 4; c++) {
+                const Real v[3] = {right.columns[c][0], right.columns[c][1], right.columns[c][2]};
+                Real out[4];
+                if (c < 3) {
+                    combine<false>(&columns[0][0], v, out);
+                } else {
+                    combine<true>(&columns[0][0], v, out);
+                }
+                for (int r = 0; r < 3; r++) {
+                    ret.columns[c][r] = out[r];
+                }
+                ret.columns[c][3] = 0.0;
+            }
+            ret.updateNormalColumns();
+            return ret;
+        }
+
+        //闭式求逆：线性部分取逆矩阵，平移为-L^-1 * t
+        AffineTransform inverse() const {
+            Real linear[3][3];
+            if (linearInverse(linear) == 0.0) {
+                throw std::runtime_error("Matrix is singular and has no inverse!");
+            }
+
+            AffineTransform ret;
+            for (int c = 0; c < 3; c++) {
+                for (int r = 0; r < 3; r++) {
+                    ret.columns[c][r] = linear[r][c];
+                }
+            }
+            for (int r = 0; r < 3; r++) {
+                ret.columns[3][r] = -(linear[r][0] * columns[3][0] + linear[r][1] * columns[3][1] + linear[r][2] * columns[3][2]);
+            }
+            ret.updateNormalColumns();
+            return ret;
+        }
+
+        //线性部分的行列式，小于0时变换包含镜像，会翻转三角形和四边形的绕序
+        Real determinant() const {
+            Real inverse[3][3];
+            return linearInverse(inverse);
+        }
+
+        //线性部分是否只沿坐标轴正向缩放（不含旋转、错切和镜像），是时scale输出三个轴的缩放系数
+        bool isAxisScale(Real scale[3]) const {
+            for (int c = 0; c < 3; c++) {
+                for (int r = 0; r < 3; r++) {
+                    if (r != c && !floatValueNearZero(columns[c][r])) return false;
+                }
+                if (columns[c][c] <= 0.0) return false;
+                scale[c] = columns[c][c];
+            }
+            return true;
+        }
+
+        // ====== 静态操作函数 ======
+
+        //构造三维平移变换
+        static AffineTransform shift(const std::array<double, 3> & shift) {
+            return AffineTransform({
+                    1.0, 0.0, 0.0, shift[0],
+                    0.0, 1.0, 0.0, shift[1],
+                    0.0, 0.0, 1.0, shift[2]
+            });
+        }
+
+        //构造三维缩放变换
+        static AffineTransform scale(const std::array<double, 3> & scale) {
+            return AffineTransform({
+                    scale[0], 0.0, 0.0, 0.0,
+                    0.0, scale[1], 0.0, 0.0,
+                    0.0, 0.0, scale[2], 0.0
+            });
+        }
+
+        //构造绕坐标轴旋转的变换（角度制），0，1，2表示x，y，z轴
+        static AffineTransform rotate(double degree, int axis) {
+            const double theta = degreeToRadian(degree);
+            const double c = std::cos(theta), s = std::sin(theta);
+            switch (axis) {
+                case 0:
+                    return AffineTransform({
+                            1.0, 0.0, 0.0, 0.0,
+                            0.0, c, -s, 0.0,
+                            0.0, s, c, 0.0
+                    });
+                case 1:
+                    return AffineTransform({
+                            c, 0.0, s, 0.0,
+                            0.0, 1.0, 0.0, 0.0,
+                            -s, 0.0, c, 0.0
+                    });
+                case 2:
+                    return AffineTransform({
+                            c, -s, 0.0, 0.0,
+                            s, c, 0.0, 0.0,
+                            0.0, 0.0, 1.0, 0.0
+                    });
+                default:
+                    throw std::runtime_error("Invalid axis index!");
+            }
+        }
+
+        //依次绕x、y、z轴旋转，矩阵为Rx * Ry * Rz
+        static AffineTransform rotate(const std::array<double, 3> & rotate) {
+            return AffineTransform::rotate(rotate[0], 0) * AffineTransform::rotate(rotate[1], 1) * AffineTransform::rotate(rotate[2], 2);
+        }
+    };
+
+    // ====== 非成员函数 ======
+
+    inline bool equals(const AffineTransform & t1, const AffineTransform & t2) {
+        for (size_t r = 0; r < 3; r++) {
+            for (size_t c = 0; c < 4; c++) {
+                if (!floatValueEquals(t1.at(r, c), t2.at(r, c))) return false;
+            }
+        }
+        return true;
+    }
+
+    inline bool operator==(const AffineTransform & t1, const AffineTransform & t2) { return equals(t1, t2); }
+    inline bool operator!=(const AffineTransform & t1, const AffineTransform & t2) { return !equals(t1, t2); }
+
+    inline std::string toString(const AffineTransform & obj) {
+        std::string ret("AffineTransform: ");
+        char buffer[AbstractObject::TOSTRING_BUFFER_SIZE];
+        for (size_t r = 0; r < 3; r++) {
+            snprintf(buffer, AbstractObject::TOSTRING_BUFFER_SIZE, "\n\t| %.4lf %.4lf %.4lf %.4lf |",
+                     static_cast<double>(obj.at(r, 0)), static_cast<double>(obj.at(r, 1)),
+                     static_cast<double>(obj.at(r, 2)), static_cast<double>(obj.at(r, 3)));
+            ret += buffer;
+        }
+        return ret;
+    }
+}
+
+#endif //RENDERERTEST_AFFINETRANSFORM_HPP
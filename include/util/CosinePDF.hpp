@@ -23,7 +23,7 @@ namespace renderer {
             return base.transform(Vec3::randomCosineVector(2, true));
         }
 
-        double value(const Vec3 &vec) const override {
+        Real value(const Vec3 &vec) const override {
             //保证概率密度不为负
             return std::max(0.0, Vec3::dot(vec.unitVector(), base[2]) / PI);
         }
@@ -37,7 +37,7 @@ namespace renderer {
 
         std::string toString() const override {
             std::string ret("Cosine PDF: Base = ");
-            return ret + base.toString();
+            return ret + renderer::toString(base);
         }
     };
 }
@@ -2,6 +2,7 @@
 #define RENDERERTEST_DENOISER_HPP
 
 #include <basic/Color3.hpp>
+#include <util/KernelDispatch.hpp>
 #include <OpenImageDenoise/oidn.hpp>
 
 namespace renderer {
@@ -74,6 +75,13 @@ namespace renderer {
             //写入颜色
             const auto * denoisedColorPtr = static_cast<const float*>(colorBuffer.getData());
 
+            //每个分量8位的32位像素格式，使用计算核批量进行伽马校正并写入，其他格式逐像素调用SDL_MapRGB
+            if (format->BytesPerPixel == 4 && format->Rloss == 0 && format->Gloss == 0 && format->Bloss == 0) {
+                const PixelLayout layout {format->Rshift, format->Gshift, format->Bshift, format->Amask};
+                KernelDispatch::kernels().toneMap(denoisedColorPtr, (size_t)windowWidth * windowHeight, layout, pixels);
+                return;
+            }
+
             for (int i = 0; i < windowHeight; i++) {
                 for (int j = 0; j < windowWidth; j++) {
                     const size_t pixel_idx = (i * windowWidth + j) * 3;
@@ -0,0 +1,178 @@
+#ifndef RENDERERTEST_GEOMETRYCACHE_HPP
+#define RENDERERTEST_GEOMETRYCACHE_HPP
+
+#include <hittable/TriangleMesh.hpp>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <list>
+#include <mutex>
+
+namespace renderer {
+    /*
+     * 固定容量的几何块缓存，按最近最少使用（LRU）的顺序换出
+     *
+     * 块按编号由loader载入（从磁盘读入或程序生成），容量按块的memoryUsage计算。载入新块后换出最久未使用的块，直到总量不超过容量
+     * 块的类型T需要提供memoryUsage，块可以在构造时给出总数，也可以之后逐个添加（addChunk）
+     * 单个块超过容量时仍然载入，只保留这一个块
+     * 换出只是释放缓存持有的引用，正在使用该块的线程持有shared_ptr，块在使用结束后才被销毁
+     *
+     * 线程安全：载入在锁外进行，多个线程同时请求同一个未驻留的块时只载入一次，其他线程等待载入完成
+     */
+    template <typename T>
+    class GeometryCacheT {
+    public:
+        typedef std::function<std::shared_ptr<T>(size_t chunk)> Loader;
+
+        struct Statistics {
+            size_t hitCount = 0;        //请求时块已驻留的次数
+            size_t loadCount = 0;       //载入块的次数
+            size_t evictionCount = 0;   //换出块的次数
+            size_t loadedBytes = 0;     //累计载入的字节数
+            size_t residentBytes = 0;   //当前驻留的字节数
+            size_t peakBytes = 0;       //驻留字节数的最大值
+        };
+
+    private:
+        struct Entry {
+            std::shared_ptr<T> mesh;
+            size_t bytes = 0;
+            bool isLoading = false;
+            std::list<size_t>::iterator position;   //在lru中的位置，只在驻留时有效
+        };
+
+        const size_t capacity;
+        const Loader loader;
+
+        mutable std::mutex mutex;
+        std::condition_variable loaded;
+        std::deque<Entry> entries;  //添加块时已有元素的引用保持有效
+        std::list<size_t> lru;      //驻留的块，最近使用的在前
+        Statistics statistics;
+
+        //将驻留的块移到最近使用的位置，需要持有锁
+        void touch(Entry & entry) {
+            lru.splice(lru.begin(), lru, entry.position);
+        }
+
+        //换出最久未使用的块直到不超过容量，最近使用的块（刚载入的块）总是保留，需要持有锁
+        void evict() {
+            while (statistics.residentBytes > capacity && lru.size() > 1) {
+                Entry & entry = entries[lru.back()];
+                lru.erase(entry.position);
+                entry.mesh.reset();
+                statistics.residentBytes -= entry.bytes;
+                statistics.evictionCount++;
+            }
+        }
+
+    public:
+        //capacity为最多驻留的字节数，chunkCount为块的总数
+        GeometryCacheT(size_t capacity, size_t chunkCount, Loader loader) : capacity(capacity), loader(std::move(loader)), entries(chunkCount) {}
+
+        //块由addChunk逐个添加，获取时提供各自的载入函数
+        explicit GeometryCacheT(size_t capacity) : GeometryCacheT(capacity, 0, null) {}
+
+        GeometryCacheT(const GeometryCacheT &) = delete;
+        GeometryCacheT & operator=(const GeometryCacheT &) = delete;
+
+        // ====== 对象操作函数 ======
+
+        //添加一个未驻留的块，返回其编号
+        size_t addChunk() {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.emplace_back();
+            return entries.size() - 1;
+        }
+
+        //获取块，未驻留时使用构造时的loader载入（阻塞），载入失败时抛出loader的异常
+        std::shared_ptr<T> acquire(size_t chunk) {
+            return acquire(chunk, loader);
+        }
+
+        //获取块，未驻留时使用load载入
+        std::shared_ptr<T> acquire(size_t chunk, const Loader & load) {
+            std::unique_lock<std::mutex> lock(mutex);
+            Entry & entry = entries.at(chunk);
+            while (entry.isLoading) {
+                loaded.wait(lock);
+            }
+            if (entry.mesh) {
+                statistics.hitCount++;
+                touch(entry);
+                return entry.mesh;
+            }
+
+            entry.isLoading = true;
+            lock.unlock();
+            std::shared_ptr<T> mesh;
+            try {
+                mesh = load(chunk);
+            } catch (...) {
+                lock.lock();
+                entry.isLoading = false;
+                loaded.notify_all();
+                throw;
+            }
+            lock.lock();
+
+            entry.isLoading = false;
+            entry.mesh = mesh;
+            entry.bytes = mesh->memoryUsage();
+            lru.push_front(chunk);
+            entry.position = lru.begin();
+            statistics.loadCount++;
+            statistics.loadedBytes += entry.bytes;
+            statistics.residentBytes += entry.bytes;
+            statistics.peakBytes = std::max(statistics.peakBytes, statistics.residentBytes);
+            evict();
+            loaded.notify_all();
+            return mesh;
+        }
+
+        //获取已驻留的块，未驻留或正在载入时返回null，不会阻塞
+        std::shared_ptr<T> find(size_t chunk) {
+            std::lock_guard<std::mutex> lock(mutex);
+            Entry & entry = entries.at(chunk);
+            if (!entry.mesh) {
+                return null;
+            }
+            statistics.hitCount++;
+            touch(entry);
+            return entry.mesh;
+        }
+
+        //块是否驻留，不计入统计，也不改变换出顺序
+        bool contains(size_t chunk) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries.at(chunk).mesh != null;
+        }
+
+        //释放所有驻留的块
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const size_t chunk : lru) {
+                entries[chunk].mesh.reset();
+            }
+            lru.clear();
+            statistics.residentBytes = 0;
+        }
+
+        // ====== 类封装函数 ======
+
+        size_t getCapacity() const { return capacity; }
+        size_t chunkCount() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries.size();
+        }
+
+        Statistics getStatistics() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return statistics;
+        }
+    };
+
+    using GeometryCache = GeometryCacheT<TriangleMesh>;
+}
+
+#endif //RENDERERTEST_GEOMETRYCACHE_HPP
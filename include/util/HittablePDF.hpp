@@ -7,15 +7,15 @@
 namespace renderer {
     /*
      * 直接向物体采样的PDF
-     * origin为光线的起点（当前碰撞点）
+     * origin为光线的起点（当前碰撞点），物体由调用者持有
      */
     class HittablePDF : public AbstractPDF {
     private:
-        std::shared_ptr<AbstractHittable> object;
+        const AbstractHittable * object;
         Point3 origin;
 
     public:
-        HittablePDF(const std::shared_ptr<AbstractHittable> &object, const Point3 &origin) :
+        HittablePDF(const AbstractHittable * object, const Point3 &origin) :
             object(object), origin(origin) {}
 
         ~HittablePDF() override = default;
@@ -25,7 +25,7 @@ namespace renderer {
             return object->randomVector(origin);
         }
 
-        double value(const Vec3 &vec) const override {
+        Real value(const Vec3 &vec) const override {
             return object->pdfValue(origin, vec.unitVector());
         }
 
@@ -38,7 +38,7 @@ namespace renderer {
 
         std::string toString() const override {
             std::string ret("Hittable PDF: Object = ");
-            return ret + object->toString() + std::string(", Origin = ") + origin.toString();
+            return ret + object->toString() + std::string(", Origin = ") + renderer::toString(origin);
         }
     };
 }
@@ -0,0 +1,102 @@
+#ifndef RENDERERTEST_KERNELDISPATCH_HPP
+#define RENDERERTEST_KERNELDISPATCH_HPP
+
+#include <Real.hpp>
+#include <SDL2/SDL_stdinc.h>
+#include <mylibrary/lib_global.hpp>
+#include <cstddef>
+
+namespace renderer {
+    /*
+     * 热点计算核的运行时分派
+     *
+     * 同一个可执行文件需要运行在只支持SSE4.2、支持AVX2和支持AVX-512的机器上
+     * 每个指令集的实现位于单独的源文件中（KernelsSSE42.cpp、KernelsAVX2.cpp、KernelsAVX512.cpp），只有这些文件使用对应的编译选项
+     * 程序第一次调用kernels()时使用SDL检测CPU特性，选择支持的最高指令集，之后始终使用同一张函数表
+     *
+     * 批量求交的输入为SoA布局：每个分量一个连续数组，一条SIMD指令处理多个物体的同一个分量
+     *
+     * 此头文件会被指令集源文件包含，只能依赖Real.hpp、SDL的基础类型定义和宏定义
+     */
+
+    //可选的指令集，按能力从低到高排列
+    enum class InstructionSet {
+        SCALAR, SSE42, AVX2, AVX512
+    };
+
+    //柏林噪声的查找表，randomVector为POINT_COUNT个连续存放的三维梯度向量
+    struct PerlinTables {
+        const int * perlinX;
+        const int * perlinY;
+        const int * perlinZ;
+        const Real * randomVector;
+    };
+
+    //32位像素格式中三个8位颜色分量的偏移量，alphaMask为不透明时的alpha位
+    struct PixelLayout {
+        Uint32 rShift, gShift, bShift;
+        Uint32 alphaMask;
+    };
+
+    //一个指令集的全部计算核
+    struct KernelTable {
+        InstructionSet instructionSet;
+        const char * name;
+
+        /*
+         * 一条光线和count个轴对齐包围盒的slab测试
+         * bounds依次为x、y、z的最小值数组和x、y、z的最大值数组，inverseDirection为光线方向的倒数
+         * tNear[i]为光线在[tMin, tMax]内进入第i个包围盒的t值，没有击中时为INFINITY
+         */
+        void (*aabbHit)(const Real * const bounds[6], size_t count, const Real origin[3], const Real inverseDirection[3],
+                        Real tMin, Real tMax, Real * tNear);
+
+        /*
+         * 一条光线和count个静止球体求交，spheres依次为球心x、y、z数组和半径数组
+         * 返回(tMin, tMax)内最近交点所属的下标并将交点写入t，没有交点时返回count
+         */
+        size_t (*sphereHit)(const Real * const spheres[4], size_t count, const Real origin[3], const Real direction[3],
+                            Real tMin, Real tMax, Real & t);
+
+        /*
+         * 一条光线和count个三角形求交（Möller–Trumbore），triangles依次为第一个顶点、边e1、边e2的x、y、z数组
+         * 返回(tMin, tMax)内最近交点所属的下标并写入t和重心坐标(u, v)，没有交点时返回count
+         */
+        size_t (*triangleHit)(const Real * const triangles[9], size_t count, const Real origin[3], const Real direction[3],
+                              Real tMin, Real tMax, Real & t, Real & u, Real & v);
+
+        /*
+         * 一条光线和count个三角形的水密求交，triangles依次为三个顶点的三个分量数组，用于网格叶子中打包的三角形
+         * 光线方向绝对值最大的分量为kz，kx、ky为另外两个分量（kz为负时交换），三角形和origin的分量都按kx、ky、kz的顺序排列
+         * shear为(d[kx] / d[kz], d[ky] / d[kz], 1 / d[kz])，返回值和输出与triangleHit相同，u、v为第二、第三个顶点的权重
+         */
+        size_t (*watertightTriangleHit)(const Real * const triangles[9], size_t count, const Real origin[3], const Real shear[3],
+                                        Real tMin, Real tMax, Real & t, Real & u, Real & v);
+
+        //在count个点上计算梯度柏林噪声，和PerlinGenerator::vectorLatticePoint相同
+        void (*perlinVectorNoise)(const PerlinTables & tables, const Real * x, const Real * y, const Real * z, size_t count, Real * result);
+
+        //将count个线性RGB颜色（连续存放的float）进行伽马2.0校正，裁剪到[0, 255]后写入32位像素
+        void (*toneMap)(const float * color, size_t count, const PixelLayout & layout, Uint32 * pixels);
+    };
+
+    //各指令集的函数表，定义在对应的源文件中。编译器或目标平台不支持时返回null
+    const KernelTable * scalarKernels();
+    const KernelTable * sse42Kernels();
+    const KernelTable * avx2Kernels();
+    const KernelTable * avx512Kernels();
+
+    class KernelDispatch {
+    public:
+        /*
+         * 当前机器使用的函数表，第一次调用时完成检测
+         * 设置环境变量RENDERER_ISA（scalar、sse42、avx2、avx512）可以限制使用的最高指令集，用于对比测试
+         */
+        static const KernelTable & kernels();
+
+        //CPU和操作系统支持的最高指令集
+        static InstructionSet detect();
+    };
+}
+
+#endif //RENDERERTEST_KERNELDISPATCH_HPP
@@ -0,0 +1,121 @@
+#ifndef RENDERERTEST_MAPPEDFILE_HPP
+#define RENDERERTEST_MAPPEDFILE_HPP
+
+#include <Global.hpp>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace renderer {
+    /*
+     * 只读内存映射文件：将整个文件映射到进程地址空间，由操作系统按需换入页面
+     * 解析大文件时不需要先把文件读入缓冲区，多个线程可以直接读取映射内存的不同区域
+     * 文件打开或映射失败时抛出异常，空文件的data为null
+     * isSequential表示是否顺序读取文件，顺序读取时提示操作系统积极预读，否则（如直接使用映射中的BVH）使用默认策略
+     */
+    class MappedFile final {
+    private:
+        const unsigned char * pointer;
+        size_t length;
+
+#ifdef _WIN32
+        HANDLE file;
+        HANDLE mapping;
+#endif
+
+        void release() {
+#ifdef _WIN32
+            if (pointer != null) UnmapViewOfFile(pointer);
+            if (mapping != null) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+            mapping = null;
+#else
+            if (pointer != null) munmap(const_cast<unsigned char *>(pointer), length);
+#endif
+            pointer = null;
+            length = 0;
+        }
+
+    public:
+        explicit MappedFile(const std::string & path, bool isSequential = true) : pointer(null), length(0) {
+#ifdef _WIN32
+            mapping = null;
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, null, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL | (isSequential ? FILE_FLAG_SEQUENTIAL_SCAN : 0), null);
+            if (file == INVALID_HANDLE_VALUE) {
+                throw std::runtime_error("Failed to open file: " + path);
+            }
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize)) {
+                release();
+                throw std::runtime_error("Failed to get file size: " + path);
+            }
+            length = static_cast<size_t>(fileSize.QuadPart);
+            if (length == 0) {
+                return;
+            }
+            mapping = CreateFileMappingA(file, null, PAGE_READONLY, 0, 0, null);
+            if (mapping != null) {
+                pointer = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+            if (pointer == null) {
+                release();
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+#else
+            const int descriptor = open(path.c_str(), O_RDONLY);
+            if (descriptor < 0) {
+                throw std::runtime_error("Failed to open file: " + path);
+            }
+            struct stat status {};
+            if (fstat(descriptor, &status) != 0) {
+                close(descriptor);
+                throw std::runtime_error("Failed to get file size: " + path);
+            }
+            length = static_cast<size_t>(status.st_size);
+            if (length == 0) {
+                close(descriptor);
+                return;
+            }
+            void * address = mmap(null, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            //映射建立后文件描述符可以立即关闭
+            close(descriptor);
+            if (address == MAP_FAILED) {
+                length = 0;
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            if (isSequential) {
+                madvise(address, length, MADV_SEQUENTIAL);
+            }
+            pointer = static_cast<const unsigned char *>(address);
+#endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        ~MappedFile() { release(); }
+
+        // ====== 类封装函数 ======
+
+        const unsigned char * data() const { return pointer; }
+        const char * begin() const { return reinterpret_cast<const char *>(pointer); }
+        const char * end() const { return reinterpret_cast<const char *>(pointer) + length; }
+        size_t size() const { return length; }
+    };
+}
+
+#endif //RENDERERTEST_MAPPEDFILE_HPP
@@ -0,0 +1,118 @@
+#ifndef RENDERERTEST_MEMORYARENA_HPP
+#define RENDERERTEST_MEMORYARENA_HPP
+
+#include <Global.hpp>
+#include <cstddef>
+#include <type_traits>
+
+namespace renderer {
+    /*
+     * 线性分配器：从预先申请的内存块中顺序分配，reset时整体回收
+     * 用于每次反弹产生的临时对象（PDF、PDF列表等），每条路径开始前reset一次
+     * 内存块在reset后保留复用，稳定后渲染循环中不再有堆分配
+     *
+     * 不能逐个释放对象；非平凡析构的对象在reset时按创建的逆序析构
+     */
+    class MemoryArena {
+    private:
+        struct Block {
+            std::unique_ptr<unsigned char[]> memory;
+            size_t size;
+        };
+
+        struct Destructor {
+            void * object;
+            void (*destroy)(void *);
+        };
+
+        std::vector<Block> blocks;
+        size_t blockSize;   //新申请的内存块的大小
+        size_t blockIndex;  //当前分配所在的内存块
+        size_t offset;      //当前内存块中已分配的字节数
+
+        std::vector<Destructor> destructors;
+
+        template <typename T>
+        static void destroyObject(void * object) {
+            static_cast<T *>(object)->~T();
+        }
+
+    public:
+        //默认内存块大小，超过内存块大小的单次分配使用独立的内存块
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        explicit MemoryArena(size_t blockSize = BLOCK_SIZE) : blockSize(blockSize), blockIndex(0), offset(0) {}
+
+        MemoryArena(const MemoryArena &) = delete;
+        MemoryArena & operator=(const MemoryArena &) = delete;
+
+        ~MemoryArena() { reset(); }
+
+        //分配size字节，地址按alignment对齐
+        void * allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            while (blockIndex < blocks.size()) {
+                Block & block = blocks[blockIndex];
+                const auto base = reinterpret_cast<uintptr_t>(block.memory.get());
+                const size_t aligned = ((base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+                if (aligned + size <= block.size) {
+                    offset = aligned + size;
+                    return block.memory.get() + aligned;
+                }
+                //当前内存块剩余空间不足，尝试下一个已有的内存块
+                blockIndex++;
+                offset = 0;
+            }
+
+            //所有内存块都已用完，申请新的内存块，预留对齐所需的空间
+            const size_t newSize = std::max(blockSize, size + alignment);
+            blocks.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[newSize]), newSize});
+            blockIndex = blocks.size() - 1;
+            offset = 0;
+            return allocate(size, alignment);
+        }
+
+        //在分配器中构造对象，对象的生命周期到下一次reset为止
+        template <typename T, typename ... Args>
+        T * create(Args && ... args) {
+            T * object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            if (!std::is_trivially_destructible<T>::value) {
+                destructors.push_back({object, &destroyObject<T>});
+            }
+            return object;
+        }
+
+        //分配count个元素的数组，元素类型需要可平凡构造和析构，内容未初始化
+        template <typename T>
+        T * allocateArray(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "Array element must be trivially destructible");
+            return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        //析构所有对象并回收全部内存，内存块保留供之后的分配复用
+        void reset() {
+            for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+                it->destroy(it->object);
+            }
+            destructors.clear();
+            blockIndex = 0;
+            offset = 0;
+        }
+
+        //已申请的内存总字节数
+        size_t capacity() const {
+            size_t sum = 0;
+            for (const auto & block : blocks) {
+                sum += block.size;
+            }
+            return sum;
+        }
+
+        //当前线程的分配器，每个渲染线程各自使用，不需要同步
+        static MemoryArena & local() {
+            static thread_local MemoryArena arena;
+            return arena;
+        }
+    };
+}
+
+#endif //RENDERERTEST_MEMORYARENA_HPP
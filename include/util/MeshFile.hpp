@@ -0,0 +1,83 @@
+#ifndef RENDERERTEST_MESHFILE_HPP
+#define RENDERERTEST_MESHFILE_HPP
+
+#include <hittable/TriangleMesh.hpp>
+
+namespace renderer {
+    /*
+     * 可直接内存映射的二进制网格文件
+     *
+     * 文件中的数组和TriangleMesh使用的内存布局完全相同，包括按叶子顺序排列的索引缓冲区、打包的叶子和BVH节点
+     * 加载时只映射文件并让网格的视图指向映射内存，不解析、不拷贝、不构造BVH，启动时间主要是缺页中断
+     *
+     * 文件布局（小端序）：
+     *   文件头（Header）
+     *   顶点、法向量、纹理坐标、索引、打包的叶子、BVH节点六个数组，每个数组的起点按SECTION_ALIGNMENT字节对齐，没有的数组偏移量为0
+     *
+     * 文件中记录写入时的标量类型、节点大小和叶子宽度，和当前程序不一致时退化为转换数据并重新构造BVH
+     * 加载时只检查文件头和各数组的范围，不逐项检查下标，文件应当由本类的write或convert生成
+     */
+    class MeshFile {
+    public:
+        static constexpr char MAGIC[4] = {'R', 'M', 'S', 'H'};
+        static constexpr Uint32 VERSION = 3;
+        static constexpr size_t SECTION_ALIGNMENT = 64;
+        static constexpr Uint32 MAX_LEAF_SIZE = 64;
+
+        //各数组在offsets中的下标
+        enum Section {
+            VERTICES, NORMALS, UVS, INDICES, PACKETS, NODES, SECTION_COUNT
+        };
+
+        struct Header {
+            char magic[4];
+            Uint32 version;
+            Uint32 scalarSize;      //顶点数据和节点包围盒的标量字节数，4或8
+            Uint32 nodeSize;        //一个BVH节点的字节数
+            Uint32 leafSize;        //一个叶子在索引缓冲区中占的三角形位置个数
+            Uint32 reserved;
+            Uint64 vertexCount;
+            Uint64 triangleCount;   //不包括叶子中补齐的位置
+            Uint64 packetCount;
+            Uint64 nodeCount;
+            double bounds[6];       //依次为x、y、z轴的最小值和最大值
+            Uint64 offsets[SECTION_COUNT];
+        };
+
+        //构造BVH并写入文件，buffers中的索引会被重排和补齐
+        static void write(const std::string & path, MeshBuffers buffers);
+
+        //和write相同，但写入内存，用于将网格文件嵌入其他文件（见StreamedMesh）
+        static std::vector<unsigned char> encode(MeshBuffers buffers);
+
+        //将offset向上对齐到SECTION_ALIGNMENT的整数倍
+        static Uint64 alignOffset(Uint64 offset) {
+            return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        }
+
+        //文件中的数据为小端序，大端序的主机上需要转换
+        static bool isLittleEndianHost() {
+            const uint16_t value = 1;
+            unsigned char byte;
+            memcpy(&byte, &value, 1);
+            return byte == 1;
+        }
+
+        //将OBJ或PLY文件转换为二进制网格文件
+        static void convert(const std::string & source, const std::string & target);
+
+        //映射文件并直接使用映射中的数据构造网格，bounds输出文件中记录的范围
+        static std::shared_ptr<TriangleMesh> load(const std::string & path, ResourceHandle material, Real bounds[6] = null);
+
+        //使用内存中的网格文件构造网格，不拷贝数据，storage需要在网格的生命周期内保持data有效，data需要按8字节对齐
+        static std::shared_ptr<TriangleMesh> load(std::shared_ptr<const void> storage, const unsigned char * data, size_t size,
+                                                  ResourceHandle material, Real bounds[6] = null);
+
+    private:
+        //path只用于错误信息
+        static std::shared_ptr<TriangleMesh> load(std::shared_ptr<const void> storage, const unsigned char * data, size_t size, const std::string & path,
+                                                  ResourceHandle material, Real bounds[6]);
+    };
+}
+
+#endif //RENDERERTEST_MESHFILE_HPP
@@ -0,0 +1,28 @@
+#ifndef RENDERERTEST_MESHLOADER_HPP
+#define RENDERERTEST_MESHLOADER_HPP
+
+#include <hittable/TriangleMesh.hpp>
+
+namespace renderer {
+    /*
+     * 网格文件加载器，支持OBJ和二进制PLY格式
+     * 文件通过内存映射读取，按块分给多个线程并行解析，直接生成TriangleMesh使用的索引缓冲区，不创建逐个三角形的物体
+     * 解析顶点的同时计算所有顶点在x、y、z轴上的范围，通过bounds参数返回（依次为x、y、z轴的最小值和最大值）
+     *
+     * 多边形面使用扇形划分为三角形
+     * 只有所有面的所有顶点都带有法向量（纹理坐标）时才输出法向量（纹理坐标），否则对应的缓冲区为空
+     * 文件格式错误或顶点下标越界时抛出异常
+     */
+    class MeshLoader {
+    public:
+        //根据文件扩展名（.obj或.ply，不区分大小写）选择格式
+        static MeshBuffers load(const std::string & path, Real bounds[6] = null);
+
+        static MeshBuffers loadOBJ(const std::string & path, Real bounds[6] = null);
+
+        //只支持binary_little_endian和binary_big_endian格式
+        static MeshBuffers loadPLY(const std::string & path, Real bounds[6] = null);
+    };
+}
+
+#endif //RENDERERTEST_MESHLOADER_HPP
@@ -0,0 +1,43 @@
+#ifndef RENDERERTEST_MESHOPTIMIZER_HPP
+#define RENDERERTEST_MESHOPTIMIZER_HPP
+
+#include <hittable/TriangleMesh.hpp>
+
+namespace renderer {
+    /*
+     * 索引网格的预处理，在构造BVH之前调用，依次执行：
+     *   1. 焊接：位置距离不超过tolerance、法向量和纹理坐标的各分量相差不超过ATTRIBUTE_TOLERANCE的顶点合并为一个
+     *      法向量或纹理坐标不同的顶点（硬边、纹理接缝）不会被合并，焊接后的顶点使用同组中第一个顶点的数据
+     *   2. 删除退化三角形（有重复顶点，或两条边夹角的正弦值小于机器精度）和重复三角形（顶点集合相同，不区分环绕方向，保留第一个）
+     *      退化三角形不会被击中，但仍占用BVH叶子中的位置
+     *   3. 按三角形中心的Morton码（Z序曲线）重排三角形，再按三角形中第一次被引用的顺序重排顶点，删除未被引用的顶点
+     *      空间上相邻的三角形和顶点在缓冲区中也相邻，构造BVH和finalize读取顶点时缓存更有效
+     *
+     * 处理后的网格和原网格的区别只有被合并的顶点位置移动了不超过tolerance的距离
+     * 缓冲区长度不匹配或下标越界时抛出异常
+     */
+    class MeshOptimizer {
+    public:
+        //焊接时法向量和纹理坐标每个分量允许的误差
+        static constexpr Real ATTRIBUTE_TOLERANCE = 1e-4;
+
+        //预处理的统计信息
+        struct Statistics {
+            size_t inputVertexCount = 0;
+            size_t inputTriangleCount = 0;
+            size_t vertexCount = 0;         //处理后的顶点数
+            size_t triangleCount = 0;       //处理后的三角形数
+            size_t weldedCount = 0;         //被焊接到其他顶点上的顶点数
+            size_t unusedCount = 0;         //删除三角形后不再被引用的顶点数
+            size_t degenerateCount = 0;     //删除的退化三角形数
+            size_t duplicateCount = 0;      //删除的重复三角形数
+            size_t inputBytes = 0;          //处理前顶点缓冲区和索引缓冲区的字节数
+            size_t bytes = 0;               //处理后顶点缓冲区和索引缓冲区的字节数
+        };
+
+        //就地处理网格缓冲区，tolerance不大于0时只合并位置完全相同的顶点，处理结束后输出节省的内存
+        static Statistics optimize(MeshBuffers & buffers, Real tolerance = 0.0);
+    };
+}
+
+#endif //RENDERERTEST_MESHOPTIMIZER_HPP
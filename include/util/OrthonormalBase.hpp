@@ -9,8 +9,9 @@ namespace renderer {
      * 正交基的每个坐标轴向量都是单位向量
      *
      * elements中的每个向量本身为世界坐标表示
+     * 和Vec3一样为值类型，比较和转换为字符串使用非成员函数
      */
-    class OrthonormalBase : public AbstractTuple<Vec3> {
+    class OrthonormalBase final : public AbstractTuple<Vec3> {
     public:
         //根据向量构造正交基，不要求传入单位向量，可以指定传入的向量作为局部坐标系的轴的下标
         OrthonormalBase(const Vec3 & vec, int axis) : AbstractTuple<Vec3>(Vec3(), Vec3(), Vec3())
@@ -46,8 +47,6 @@ namespace renderer {
         OrthonormalBase(const Vec3 & x = Vec3(1.0, 0.0, 0.0), const Vec3 & y = Vec3(0.0, 1.0, 0.0), const Vec3 & z = Vec3(0.0, 0.0, 1.0)) :
                 AbstractTuple<Vec3>(x.unitVector(), y.unitVector(), z.unitVector()) {}
 
-        ~OrthonormalBase() override = default;
-
         //将局部空间中的向量origin变换到世界空间
         Vec3 transform(const Vec3 & origin) const {
             Vec3 ret;
@@ -65,27 +64,27 @@ namespace renderer {
                         Vec3::dot(worldVec, elements[1]),
                         Vec3::dot(worldVec, elements[2]));
         }
+    };
 
-        // ====== 类封装函数 ======
+    // ====== 非成员函数 ======
 
-        bool equals(const AbstractObject &obj) const override {
-            if (this == &obj) return true;
-            const auto * o = dynamic_cast<const OrthonormalBase *>(&obj);
-            if (o == null) return false;
-            return elements[0] == o->elements[0] && elements[1] == o->elements[1] && elements[2] == o->elements[2];
-        }
+    inline bool equals(const OrthonormalBase & b1, const OrthonormalBase & b2) {
+        return b1[0] == b2[0] && b1[1] == b2[1] && b1[2] == b2[2];
+    }
 
-        std::string toString() const override {
-            std::string ret("OrthonormalBase: ");
-            for (size_t i = 0; i < 3; i++) {
-                ret += "\n\t";
-                ret += static_cast<char>('x' + i);
-                ret += ": ";
-                ret += elements[i].toString();
-            }
-            return ret;
+    inline bool operator==(const OrthonormalBase & b1, const OrthonormalBase & b2) { return equals(b1, b2); }
+    inline bool operator!=(const OrthonormalBase & b1, const OrthonormalBase & b2) { return !equals(b1, b2); }
+
+    inline std::string toString(const OrthonormalBase & obj) {
+        std::string ret("OrthonormalBase: ");
+        for (size_t i = 0; i < 3; i++) {
+            ret += "\n\t";
+            ret += static_cast<char>('x' + i);
+            ret += ": ";
+            ret += toString(obj[i]);
         }
-    };
+        return ret;
+    }
 }
 
 #endif //RENDERERTEST_ORTHONORMALBASE_HPP
@@ -19,7 +19,7 @@ namespace renderer {
         static constexpr int POINT_COUNT = 256;
 
         //noise方法返回此数组中的元素，主要随机过程在于决定下标
-        double randomNumber[POINT_COUNT];
+        Real randomNumber[POINT_COUNT];
         Vec3 randomVector[POINT_COUNT]; //用于RANDOM_VECTOR方法
 
         //置换数组，每个数组里面都储存了从0到255的所有整数，但顺序随机打乱。作为“哈希表”，用于将输入的坐标映射到一个随机但确定的索引上
@@ -30,7 +30,7 @@ namespace renderer {
 
     public:
         PerlinGenerator() {
-            for (double & i : randomNumber) {
+            for (Real & i : randomNumber) {
                 i = randomDouble();
             }
             for (auto & i : randomVector) {
@@ -44,18 +44,18 @@ namespace renderer {
 
         //无平滑的基础噪声
         //无论一个点落在哪个整数立方体区域内，都返回同一个值，导致块状外观
-        double perlinNoiseNoSmooth(const Point3 & point) const;
+        Real perlinNoiseNoSmooth(const Point3 & point) const;
 
         //线性插值平滑
         //考虑该点所在的整数坐标立方体的所有8个顶点，根据该点在这个立方体内的相对位置
         //将这8个顶点各自的噪声值平滑地混合（插值）在一起得到最终的噪声值
-        double perlinNoiseLinearSmooth(const Point3 & point) const;
+        Real perlinNoiseLinearSmooth(const Point3 & point) const;
 
         //线性差值升级
-        double hermitianSmoothImprove(const Point3 & point) const;
+        Real hermitianSmoothImprove(const Point3 & point) const;
 
         /*
-         * 晶格点（整数坐标点）上储存的不再是一个简单的随机数值 (double)，而是一个随机的梯度向量 (Vec3)
+         * 晶格点（整数坐标点）上储存的不再是一个简单的随机数值 (Real)，而是一个随机的梯度向量 (Vec3)
          * weightVector是一个距离向量，它从当前计算的立方体顶点 (l, m, n) 指向立方体内部的点 (u, v, w)
          * 将乘法计算修改为计算距离向量和该顶点的梯度向量之间的点积，通过点积运算引入了方向性
          * 此处计算的是在点 (u, v, w) 的位置，受到来自顶点 (l, m, n) 的梯度“推动”的强度
@@ -64,7 +64,7 @@ namespace renderer {
          *
          * 使用梯度和距离向量的点积可以确保噪声值在每个整数晶格点上都精确为 0，因为在顶点上，距离向量的长度为零，导致点积为零。这进一步增强了噪声的平滑度和连续性
          */
-        double vectorLatticePoint(const Point3 & point) const;
+        Real vectorLatticePoint(const Point3 & point) const;
 
         /*
          * 通过叠加多个不同频率和振幅的柏林噪声，来生成一种更复杂、更具细节的噪声，通常被称为湍流 (Turbulence) 或分形噪声 (Fractal Noise)
@@ -80,7 +80,7 @@ namespace renderer {
          * 最后取绝对值：标准的柏林噪声值范围通常在 [-1, 1] 之间，在最后返回累加结果的绝对值 std::abs()，会把所有负值“翻转”成正值
          * 这会在噪声值为零的地方产生尖锐的“山谷”或“裂缝”，从而形成一种类似大理石纹理或湍流的视觉效果
          */
-        double turbulenceNoise(const Point3 & point) const;
+        Real turbulenceNoise(const Point3 & point) const;
 
         // ====== 类封装函数 ======
 
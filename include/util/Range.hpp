@@ -2,6 +2,7 @@
 #define RENDERERTEST_RANGE_HPP
 
 #include <AbstractObject.hpp>
+#include <type_traits>
 
 namespace renderer {
     /*
@@ -16,25 +17,26 @@ namespace renderer {
      *
      * EMPTY：空区间
      * UNIVERSE：全实数域
+     *
+     * 和三元组一样为热路径上的值类型，不继承AbstractObject，比较和转换为字符串使用非成员函数
      */
-    class Range final : public AbstractObject {
+    template <typename T>
+    class RangeT final {
     private:
-        double min;
-        double max;
+        T min;
+        T max;
 
     public:
         //默认构造空区间
-        explicit Range(double min = 0.0, double max = 0.0) : min(min), max(max) {}
+        explicit constexpr RangeT(T min = 0.0, T max = 0.0) : min(min), max(max) {}
 
         //构造两个区间的并集
-        Range(const Range & r1, const Range & r2) :
+        constexpr RangeT(const RangeT & r1, const RangeT & r2) :
             min(r1.min < r2.min ? r1.min : r2.min), max(r1.max > r2.max ? r1.max : r2.max) {}
 
-        ~Range() override = default;
-
         // ====== 对象操作函数 ======
 
-        bool inRange(double value, bool isLeftClose = true, bool isRightClose = true) const {
+        bool inRange(T value, bool isLeftClose = true, bool isRightClose = true) const {
             const bool equalsToMin = floatValueEquals(value, min);
             const bool equalsToMax = floatValueEquals(value, max);
 
@@ -44,7 +46,7 @@ namespace renderer {
             return true;
         }
 
-        Range & offset(double offsetValue) {
+        constexpr RangeT & offset(T offsetValue) {
             min += offsetValue;
             max += offsetValue;
             return *this;
@@ -54,11 +56,11 @@ namespace renderer {
             return min < max || floatValueEquals(min, max);
         }
 
-        double length() const {
+        constexpr T length() const {
             return max - min;
         }
 
-        double clamp(double value) const {
+        constexpr T clamp(T value) const {
             if (value > max) {
                 return max;
             } else if (value < min) {
@@ -69,7 +71,7 @@ namespace renderer {
         }
 
         //将当前区间左右端点各扩展length长度
-        Range & expand(double length) {
+        constexpr RangeT & expand(T length) {
             if (length > 0) { //负长度不扩展
                 min -= length;
                 max += length;
@@ -79,24 +81,42 @@ namespace renderer {
 
         // ====== 类封装函数 =======
 
-        bool equals(const AbstractObject & obj) const override {
-            if (this == &obj) return true;
-            const auto * range = dynamic_cast<const Range *>(&obj);
-            if (range == null) return false;
-            return min == range->min && max == range->max;
-        }
+        constexpr T getMin() const { return min; }
+        constexpr void setMin(const T _min) { this->min = _min; }
+        constexpr T getMax() const { return max; }
+        constexpr void setMax(const T _max) { this->max = _max; }
+    };
 
-        std::string toString() const override {
-            char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
-            snprintf(buffer, TOSTRING_BUFFER_SIZE, "Range: [%.4lf, %.4lf]", min, max);
-            return {buffer};
-        }
+    //渲染管线使用的区间类型，精度由Real决定
+    using Range = RangeT<Real>;
+    using Ranged = RangeT<double>;
 
-        double getMin() const { return min; }
-        void setMin(const double _min) { this->min = _min; }
-        double getMax() const { return max; }
-        void setMax(const double _max) { this->max = _max; }
-    };
+    static_assert(std::is_trivially_copyable<Range>::value && std::is_standard_layout<Range>::value, "Range must be a plain value type");
+
+    // ====== 非成员函数 ======
+
+    template <typename T>
+    constexpr bool equals(const RangeT<T> & r1, const RangeT<T> & r2) {
+        return r1.getMin() == r2.getMin() && r1.getMax() == r2.getMax();
+    }
+
+    template <typename T>
+    constexpr bool operator==(const RangeT<T> & r1, const RangeT<T> & r2) { return equals(r1, r2); }
+
+    template <typename T>
+    constexpr bool operator!=(const RangeT<T> & r1, const RangeT<T> & r2) { return !equals(r1, r2); }
+
+    template <typename T>
+    inline std::string toString(const RangeT<T> & obj) {
+        char buffer[AbstractObject::TOSTRING_BUFFER_SIZE] = { 0 };
+        snprintf(buffer, AbstractObject::TOSTRING_BUFFER_SIZE, "Range: [%.4lf, %.4lf]", obj.getMin(), obj.getMax());
+        return {buffer};
+    }
+
+    template <typename T>
+    inline std::ostream & operator<<(std::ostream & os, const RangeT<T> & obj) {
+        return os << toString(obj);
+    }
 }
 
 #endif //RENDERERTEST_RANGE_HPP
@@ -0,0 +1,90 @@
+#ifndef RENDERERTEST_RESOURCETABLE_HPP
+#define RENDERERTEST_RESOURCETABLE_HPP
+
+#include <Global.hpp>
+#include <mutex>
+#include <unordered_map>
+
+namespace renderer {
+    //资源句柄，为资源在资源表中的下标
+    typedef Uint32 ResourceHandle;
+
+    /*
+     * 资源表：集中持有材质、纹理等被多个物体共享的资源，物体和碰撞记录中只保存32位句柄
+     * 求交和着色通过句柄取得裸指针，不再复制shared_ptr，光线遍历路径上没有引用计数的原子操作
+     *
+     * 资源表由场景持有（SceneResources），资源的生命周期和场景相同，场景销毁时释放所有资源
+     * 同一个资源只登记一次，相同的指针得到相同的句柄，因此句柄相等等价于资源指针相等
+     * 登记只在构造场景时进行，使用互斥锁保护；渲染期间资源表被设为只读，此时登记会抛出异常，查询不加锁
+     */
+    template <typename T>
+    class ResourceTable final {
+    private:
+        std::vector<std::shared_ptr<T>> resources;
+        std::unordered_map<const T *, ResourceHandle> handles;
+        std::mutex mutex;
+        bool readOnly = false;
+
+    public:
+        ResourceTable() = default;
+        ~ResourceTable() = default;
+
+        ResourceTable(const ResourceTable &) = delete;
+        ResourceTable & operator=(const ResourceTable &) = delete;
+
+        // ====== 对象操作函数 ======
+
+        //登记资源并返回其句柄，已登记的资源直接返回原句柄
+        ResourceHandle add(const std::shared_ptr<T> & resource) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (readOnly) {
+                throw std::runtime_error("Resource table is read-only during rendering");
+            }
+            if (resource == null) {
+                throw std::runtime_error("Resource is null");
+            }
+            const auto iterator = handles.find(resource.get());
+            if (iterator != handles.end()) {
+                return iterator->second;
+            }
+            if (resources.size() >= std::numeric_limits<ResourceHandle>::max()) {
+                throw std::runtime_error("Resource table is full");
+            }
+            const auto handle = static_cast<ResourceHandle>(resources.size());
+            resources.push_back(resource);
+            handles.emplace(resource.get(), handle);
+            return handle;
+        }
+
+        const T * get(ResourceHandle handle) const {
+            return resources[handle].get();
+        }
+
+        const std::shared_ptr<T> & getShared(ResourceHandle handle) const {
+            return resources[handle];
+        }
+
+        //释放所有资源，调用前需要保证已经没有物体使用之前得到的句柄
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (readOnly) {
+                throw std::runtime_error("Resource table is read-only during rendering");
+            }
+            resources.clear();
+            handles.clear();
+        }
+
+        // ====== 类封装函数 ======
+
+        size_t size() const { return resources.size(); }
+
+        //由Camera在渲染开始和结束时设置，渲染线程启动前设置，之后只读取
+        void setReadOnly(bool readOnly) {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->readOnly = readOnly;
+        }
+        bool isReadOnly() const { return readOnly; }
+    };
+}
+
+#endif //RENDERERTEST_RESOURCETABLE_HPP
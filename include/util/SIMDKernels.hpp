@@ -0,0 +1,457 @@
+#ifndef RENDERERTEST_SIMDKERNELS_HPP
+#define RENDERERTEST_SIMDKERNELS_HPP
+
+#include <util/KernelDispatch.hpp>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace renderer {
+    /*
+     * 计算核的通用实现，只被KernelDispatch.cpp和各指令集源文件包含
+     *
+     * 算法按“向量包”类型P编写，P一次处理WIDTH个分量，需要提供：
+     *   Scalar、Vector、Mask类型和WIDTH常量
+     *   load、store、broadcast：加载、写回和广播
+     *   add、sub、mul、div、min、max、sqrt、floor：逐分量运算
+     *   less、lessEqual、both、bits、select：比较、掩码求与、掩码转换为位、按掩码选择（m ? a : b）
+     *   storeInt：截断为32位整数并写回，只有处理float的向量包需要
+     * 各指令集源文件定义自己的向量包并实例化，标量实现的向量包宽度为1
+     *
+     * 所有函数位于匿名命名空间中，每个源文件得到独立的函数实体，链接器不会把AVX指令的版本用在不支持的机器上
+     * 出于同样的原因，这里不能调用其他头文件中的内联函数
+     */
+    namespace {
+        template <typename T>
+        constexpr T KERNEL_INFINITY = std::numeric_limits<T>::infinity();
+
+        //数组末尾不足一个向量包的部分，复制到补零的临时数组中处理，避免越界读取
+        template <typename T, size_t WIDTH, size_t COUNT>
+        struct PaddedTail {
+            T data[COUNT][WIDTH];
+            const T * pointer[COUNT];
+
+            PaddedTail(const T * const source[COUNT], size_t begin, size_t end) : data() {
+                for (size_t k = 0; k < COUNT; k++) {
+                    for (size_t lane = 0; begin + lane < end; lane++) {
+                        data[k][lane] = source[k][begin + lane];
+                    }
+                    pointer[k] = data[k];
+                }
+            }
+        };
+
+        // ====== 轴对齐包围盒 ======
+
+        template <typename P>
+        inline void aabbHitPack(const Real * const bounds[6], size_t i, const typename P::Vector origin[3],
+                                const typename P::Vector inverseDirection[3], typename P::Vector tMin, typename P::Vector tMax, Real * tNear) {
+            using V = typename P::Vector;
+            const V zero = P::broadcast(0);
+            V enter = tMin, exit = tMax;
+            for (size_t axis = 0; axis < 3; axis++) {
+                //和AxisAlignedBoundingBox::hit相同，按方向的符号选择进入和离开的边界
+                //min/max在存在NaN时返回第二个参数，光线平行于当前轴且起点在边界上时保持原值
+                const auto isNegative = P::less(inverseDirection[axis], zero);
+                const V lower = P::load(bounds[axis] + i), upper = P::load(bounds[axis + 3] + i);
+                const V near = P::mul(P::sub(P::select(isNegative, upper, lower), origin[axis]), inverseDirection[axis]);
+                const V far = P::mul(P::sub(P::select(isNegative, lower, upper), origin[axis]), inverseDirection[axis]);
+                enter = P::max(near, enter);
+                exit = P::min(far, exit);
+            }
+            P::store(tNear + i, P::select(P::lessEqual(enter, exit), enter, P::broadcast(KERNEL_INFINITY<Real>)));
+        }
+
+        template <typename P>
+        void aabbHit(const Real * const bounds[6], size_t count, const Real origin[3], const Real inverseDirection[3],
+                     Real tMin, Real tMax, Real * tNear) {
+            using V = typename P::Vector;
+            const V o[3] = {P::broadcast(origin[0]), P::broadcast(origin[1]), P::broadcast(origin[2])};
+            const V inv[3] = {P::broadcast(inverseDirection[0]), P::broadcast(inverseDirection[1]), P::broadcast(inverseDirection[2])};
+            const V minT = P::broadcast(tMin), maxT = P::broadcast(tMax);
+
+            size_t i = 0;
+            for (; i + P::WIDTH <= count; i += P::WIDTH) {
+                aabbHitPack<P>(bounds, i, o, inv, minT, maxT, tNear);
+            }
+            if (i < count) {
+                const PaddedTail<Real, P::WIDTH, 6> tail(bounds, i, count);
+                Real result[P::WIDTH];
+                aabbHitPack<P>(tail.pointer, 0, o, inv, minT, maxT, result);
+                for (size_t lane = 0; i + lane < count; lane++) {
+                    tNear[i + lane] = result[lane];
+                }
+            }
+        }
+
+        // ====== 球体 ======
+
+        //返回命中的分量掩码，t中未命中的分量为INFINITY
+        template <typename P>
+        inline unsigned sphereHitPack(const Real * const spheres[4], size_t i, const typename P::Vector origin[3],
+                                      const typename P::Vector direction[3], typename P::Vector a, typename P::Vector inverseA, typename P::Vector tMin,
+                                      typename P::Vector tMax, Real * t) {
+            using V = typename P::Vector;
+            //oc从光线起点指向球心，h = d · oc，判别式为 h^2 - a * (oc · oc - r^2)
+            const V ocx = P::sub(P::load(spheres[0] + i), origin[0]);
+            const V ocy = P::sub(P::load(spheres[1] + i), origin[1]);
+            const V ocz = P::sub(P::load(spheres[2] + i), origin[2]);
+            const V radius = P::load(spheres[3] + i);
+
+            const V h = P::add(P::add(P::mul(direction[0], ocx), P::mul(direction[1], ocy)), P::mul(direction[2], ocz));
+            const V c = P::sub(P::add(P::add(P::mul(ocx, ocx), P::mul(ocy, ocy)), P::mul(ocz, ocz)), P::mul(radius, radius));
+            const V delta = P::sub(P::mul(h, h), P::mul(a, c));
+
+            const V zero = P::broadcast(0);
+            const V root = P::sqrt(P::max(delta, zero));
+            const V root1 = P::mul(P::sub(h, root), inverseA);
+            const V root2 = P::mul(P::add(h, root), inverseA);
+
+            //优先选择较近的根
+            const auto isRoot1 = P::both(P::less(tMin, root1), P::less(root1, tMax));
+            const auto isRoot2 = P::both(P::less(tMin, root2), P::less(root2, tMax));
+            const V infinity = P::broadcast(KERNEL_INFINITY<Real>);
+            const V result = P::select(isRoot1, root1, P::select(isRoot2, root2, infinity));
+
+            const auto isHit = P::both(P::lessEqual(zero, delta), P::less(result, infinity));
+            P::store(t, result);
+            return P::bits(isHit);
+        }
+
+        template <typename P>
+        size_t sphereHit(const Real * const spheres[4], size_t count, const Real origin[3], const Real direction[3],
+                         Real tMin, Real tMax, Real & t) {
+            using V = typename P::Vector;
+            const V o[3] = {P::broadcast(origin[0]), P::broadcast(origin[1]), P::broadcast(origin[2])};
+            const V d[3] = {P::broadcast(direction[0]), P::broadcast(direction[1]), P::broadcast(direction[2])};
+            const Real lengthSquare = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2];
+            const V a = P::broadcast(lengthSquare), inverseA = P::broadcast(1 / lengthSquare);
+            const V minT = P::broadcast(tMin);
+
+            size_t ret = count;
+            Real closest = tMax;
+            Real result[P::WIDTH];
+
+            //每处理一个向量包后用最近的交点缩小范围
+            const auto update = [&](unsigned mask, size_t begin) {
+                for (size_t lane = 0; mask != 0; lane++, mask >>= 1) {
+                    if ((mask & 1) && result[lane] < closest) {
+                        closest = result[lane];
+                        ret = begin + lane;
+                    }
+                }
+            };
+
+            size_t i = 0;
+            for (; i + P::WIDTH <= count; i += P::WIDTH) {
+                update(sphereHitPack<P>(spheres, i, o, d, a, inverseA, minT, P::broadcast(closest), result), i);
+            }
+            if (i < count) {
+                const PaddedTail<Real, P::WIDTH, 4> tail(spheres, i, count);
+                const unsigned valid = (1u << (count - i)) - 1;
+                update(sphereHitPack<P>(tail.pointer, 0, o, d, a, inverseA, minT, P::broadcast(closest), result) & valid, i);
+            }
+
+            if (ret != count) {
+                t = closest;
+            }
+            return ret;
+        }
+
+        // ====== 三角形 ======
+
+        template <typename P>
+        inline unsigned triangleHitPack(const Real * const triangles[9], size_t i, const typename P::Vector origin[3],
+                                        const typename P::Vector direction[3], typename P::Vector tMin, typename P::Vector tMax,
+                                        Real * t, Real * u, Real * v) {
+            using V = typename P::Vector;
+            const V v0[3] = {P::load(triangles[0] + i), P::load(triangles[1] + i), P::load(triangles[2] + i)};
+            const V e1[3] = {P::load(triangles[3] + i), P::load(triangles[4] + i), P::load(triangles[5] + i)};
+            const V e2[3] = {P::load(triangles[6] + i), P::load(triangles[7] + i), P::load(triangles[8] + i)};
+
+            //h = d × e2，detA = e1 · h
+            const V h[3] = {
+                    P::sub(P::mul(direction[1], e2[2]), P::mul(direction[2], e2[1])),
+                    P::sub(P::mul(direction[2], e2[0]), P::mul(direction[0], e2[2])),
+                    P::sub(P::mul(direction[0], e2[1]), P::mul(direction[1], e2[0]))
+            };
+            const V det = P::add(P::add(P::mul(e1[0], h[0]), P::mul(e1[1], h[1])), P::mul(e1[2], h[2]));
+
+            //s = O - v0，u = (s · h) / detA，三次除法合并为一次求倒数
+            const V inverseDet = P::div(P::broadcast(1), det);
+            const V s[3] = {P::sub(origin[0], v0[0]), P::sub(origin[1], v0[1]), P::sub(origin[2], v0[2])};
+            const V resultU = P::mul(P::add(P::add(P::mul(s[0], h[0]), P::mul(s[1], h[1])), P::mul(s[2], h[2])), inverseDet);
+
+            //q = s × e1，v = (d · q) / detA，t = (e2 · q) / detA
+            const V q[3] = {
+                    P::sub(P::mul(s[1], e1[2]), P::mul(s[2], e1[1])),
+                    P::sub(P::mul(s[2], e1[0]), P::mul(s[0], e1[2])),
+                    P::sub(P::mul(s[0], e1[1]), P::mul(s[1], e1[0]))
+            };
+            const V resultV = P::mul(P::add(P::add(P::mul(direction[0], q[0]), P::mul(direction[1], q[1])), P::mul(direction[2], q[2])), inverseDet);
+            const V resultT = P::mul(P::add(P::add(P::mul(e2[0], q[0]), P::mul(e2[1], q[1])), P::mul(e2[2], q[2])), inverseDet);
+
+            //和Triangle::hit使用相同的阈值：行列式接近0时光线和三角形平行，u、v允许超出[0, 1]不超过阈值
+            const Real threshold = static_cast<Real>(1e-5);
+            const V zero = P::broadcast(0), one = P::broadcast(1);
+            const V epsilon = P::broadcast(threshold), lower = P::broadcast(-threshold), upper = P::broadcast(1 + threshold);
+            const auto isValid = P::less(epsilon, P::max(det, P::sub(zero, det)));
+            const auto isInsideU = P::both(P::lessEqual(lower, resultU), P::lessEqual(resultU, upper));
+            const auto isInsideV = P::both(P::lessEqual(lower, resultV), P::lessEqual(P::add(resultU, resultV), one));
+            const auto isInRange = P::both(P::less(tMin, resultT), P::less(resultT, tMax));
+
+            P::store(t, resultT);
+            P::store(u, resultU);
+            P::store(v, resultV);
+            return P::bits(P::both(P::both(isValid, isInRange), P::both(isInsideU, isInsideV)));
+        }
+
+        template <typename P>
+        size_t triangleHit(const Real * const triangles[9], size_t count, const Real origin[3], const Real direction[3],
+                           Real tMin, Real tMax, Real & t, Real & u, Real & v) {
+            using V = typename P::Vector;
+            const V o[3] = {P::broadcast(origin[0]), P::broadcast(origin[1]), P::broadcast(origin[2])};
+            const V d[3] = {P::broadcast(direction[0]), P::broadcast(direction[1]), P::broadcast(direction[2])};
+            const V minT = P::broadcast(tMin);
+
+            size_t ret = count;
+            Real closest = tMax, closestU = 0, closestV = 0;
+            Real resultT[P::WIDTH], resultU[P::WIDTH], resultV[P::WIDTH];
+
+            const auto update = [&](unsigned mask, size_t begin) {
+                for (size_t lane = 0; mask != 0; lane++, mask >>= 1) {
+                    if ((mask & 1) && resultT[lane] < closest) {
+                        closest = resultT[lane];
+                        closestU = resultU[lane];
+                        closestV = resultV[lane];
+                        ret = begin + lane;
+                    }
+                }
+            };
+
+            size_t i = 0;
+            for (; i + P::WIDTH <= count; i += P::WIDTH) {
+                update(triangleHitPack<P>(triangles, i, o, d, minT, P::broadcast(closest), resultT, resultU, resultV), i);
+            }
+            if (i < count) {
+                const PaddedTail<Real, P::WIDTH, 9> tail(triangles, i, count);
+                const unsigned valid = (1u << (count - i)) - 1;
+                update(triangleHitPack<P>(tail.pointer, 0, o, d, minT, P::broadcast(closest), resultT, resultU, resultV) & valid, i);
+            }
+
+            if (ret != count) {
+                t = closest;
+                u = closestU;
+                v = closestV;
+            }
+            return ret;
+        }
+
+        /*
+         * 水密三角形求交（Woop、Benthin、Wald 2013）
+         * 顶点先平移到光线起点，再剪切变换到光线方向为+z轴的坐标系，三条边函数只依赖两个顶点的xy坐标
+         * 相邻三角形的公共边计算出完全相同（符号相反）的边函数，光线不会从公共边或公共顶点的缝隙中穿过
+         */
+        template <typename P>
+        inline unsigned watertightTriangleHitPack(const Real * const triangles[9], size_t i, const typename P::Vector origin[3],
+                                                  const typename P::Vector shear[3], typename P::Vector tMin, typename P::Vector tMax,
+                                                  Real * t, Real * u, Real * v) {
+            using V = typename P::Vector;
+            V x[3], y[3], z[3];
+            for (size_t k = 0; k < 3; k++) {
+                const V a = P::sub(P::load(triangles[3 * k] + i), origin[0]);
+                const V b = P::sub(P::load(triangles[3 * k + 1] + i), origin[1]);
+                z[k] = P::sub(P::load(triangles[3 * k + 2] + i), origin[2]);
+                x[k] = P::sub(a, P::mul(shear[0], z[k]));
+                y[k] = P::sub(b, P::mul(shear[1], z[k]));
+            }
+
+            //三条边函数，分别是对面顶点的未归一化重心坐标
+            const V edge0 = P::sub(P::mul(x[2], y[1]), P::mul(y[2], x[1]));
+            const V edge1 = P::sub(P::mul(x[0], y[2]), P::mul(y[0], x[2]));
+            const V edge2 = P::sub(P::mul(x[1], y[0]), P::mul(y[1], x[0]));
+            const V det = P::add(P::add(edge0, edge1), edge2);
+            const V scaledT = P::mul(P::add(P::add(P::mul(edge0, z[0]), P::mul(edge1, z[1])), P::mul(edge2, z[2])), shear[2]);
+
+            const V inverseDet = P::div(P::broadcast(1), det);
+            const V resultT = P::mul(scaledT, inverseDet);
+
+            //三条边函数同号（允许为0）时光线穿过三角形，det为0的三角形退化为线段或点（包括补零的空位）
+            const V zero = P::broadcast(0);
+            const auto isNonNegative = P::both(P::both(P::lessEqual(zero, edge0), P::lessEqual(zero, edge1)), P::lessEqual(zero, edge2));
+            const auto isNonPositive = P::both(P::both(P::lessEqual(edge0, zero), P::lessEqual(edge1, zero)), P::lessEqual(edge2, zero));
+            const auto isValid = P::less(zero, P::max(det, P::sub(zero, det)));
+            const auto isInRange = P::both(P::less(tMin, resultT), P::less(resultT, tMax));
+
+            P::store(t, resultT);
+            P::store(u, P::mul(edge1, inverseDet));
+            P::store(v, P::mul(edge2, inverseDet));
+            return (P::bits(isNonNegative) | P::bits(isNonPositive)) & P::bits(P::both(isValid, isInRange));
+        }
+
+        template <typename P>
+        size_t watertightTriangleHit(const Real * const triangles[9], size_t count, const Real origin[3], const Real shear[3],
+                                     Real tMin, Real tMax, Real & t, Real & u, Real & v) {
+            using V = typename P::Vector;
+            const V o[3] = {P::broadcast(origin[0]), P::broadcast(origin[1]), P::broadcast(origin[2])};
+            const V s[3] = {P::broadcast(shear[0]), P::broadcast(shear[1]), P::broadcast(shear[2])};
+            const V minT = P::broadcast(tMin);
+
+            size_t ret = count;
+            Real closest = tMax, closestU = 0, closestV = 0;
+            Real resultT[P::WIDTH], resultU[P::WIDTH], resultV[P::WIDTH];
+
+            const auto update = [&](unsigned mask, size_t begin) {
+                for (size_t lane = 0; mask != 0; lane++, mask >>= 1) {
+                    if ((mask & 1) && resultT[lane] < closest) {
+                        closest = resultT[lane];
+                        closestU = resultU[lane];
+                        closestV = resultV[lane];
+                        ret = begin + lane;
+                    }
+                }
+            };
+
+            size_t i = 0;
+            for (; i + P::WIDTH <= count; i += P::WIDTH) {
+                update(watertightTriangleHitPack<P>(triangles, i, o, s, minT, P::broadcast(closest), resultT, resultU, resultV), i);
+            }
+            if (i < count) {
+                const PaddedTail<Real, P::WIDTH, 9> tail(triangles, i, count);
+                const unsigned valid = (1u << (count - i)) - 1;
+                update(watertightTriangleHitPack<P>(tail.pointer, 0, o, s, minT, P::broadcast(closest), resultT, resultU, resultV) & valid, i);
+            }
+
+            if (ret != count) {
+                t = closest;
+                u = closestU;
+                v = closestV;
+            }
+            return ret;
+        }
+
+
+        // ====== 柏林噪声 ======
+
+        //和PerlinGenerator::vectorLatticePoint相同：插值权重和距离向量都使用平滑后的小数部分
+        template <typename P>
+        inline void perlinVectorNoisePack(const PerlinTables & tables, const Real * const point[3], size_t i, Real * result) {
+            using V = typename P::Vector;
+            const V one = P::broadcast(1), two = P::broadcast(2), three = P::broadcast(3);
+
+            int lattice[3][P::WIDTH];
+            V fraction[3];
+            for (size_t axis = 0; axis < 3; axis++) {
+                const V p = P::load(point[axis] + i);
+                const V integer = P::floor(p);
+                const V f = P::sub(p, integer);
+                fraction[axis] = P::mul(P::mul(f, f), P::sub(three, P::mul(two, f)));
+
+                Real stored[P::WIDTH];
+                P::store(stored, integer);
+                for (size_t lane = 0; lane < P::WIDTH; lane++) {
+                    lattice[axis][lane] = static_cast<int>(stored[lane]);
+                }
+            }
+
+            V accum = P::broadcast(0);
+            for (int l = 0; l < 2; l++) {
+                for (int m = 0; m < 2; m++) {
+                    for (int n = 0; n < 2; n++) {
+                        //置换表查找没有对应的向量指令，逐分量取出顶点的梯度向量
+                        Real gradient[3][P::WIDTH];
+                        for (size_t lane = 0; lane < P::WIDTH; lane++) {
+                            const int index = tables.perlinX[(lattice[0][lane] + l) & 255] ^
+                                              tables.perlinY[(lattice[1][lane] + m) & 255] ^
+                                              tables.perlinZ[(lattice[2][lane] + n) & 255];
+                            for (size_t axis = 0; axis < 3; axis++) {
+                                gradient[axis][lane] = tables.randomVector[3 * index + axis];
+                            }
+                        }
+
+                        const V dx = P::sub(fraction[0], P::broadcast(static_cast<Real>(l)));
+                        const V dy = P::sub(fraction[1], P::broadcast(static_cast<Real>(m)));
+                        const V dz = P::sub(fraction[2], P::broadcast(static_cast<Real>(n)));
+                        const V dot = P::add(P::add(P::mul(dx, P::load(gradient[0])), P::mul(dy, P::load(gradient[1]))), P::mul(dz, P::load(gradient[2])));
+
+                        const V wx = l ? fraction[0] : P::sub(one, fraction[0]);
+                        const V wy = m ? fraction[1] : P::sub(one, fraction[1]);
+                        const V wz = n ? fraction[2] : P::sub(one, fraction[2]);
+                        accum = P::add(accum, P::mul(P::mul(P::mul(wx, wy), wz), dot));
+                    }
+                }
+            }
+            P::store(result + i, accum);
+        }
+
+        template <typename P>
+        void perlinVectorNoise(const PerlinTables & tables, const Real * x, const Real * y, const Real * z, size_t count, Real * result) {
+            const Real * const point[3] = {x, y, z};
+            size_t i = 0;
+            for (; i + P::WIDTH <= count; i += P::WIDTH) {
+                perlinVectorNoisePack<P>(tables, point, i, result);
+            }
+            if (i < count) {
+                const PaddedTail<Real, P::WIDTH, 3> tail(point, i, count);
+                Real tailResult[P::WIDTH];
+                perlinVectorNoisePack<P>(tables, tail.pointer, 0, tailResult);
+                for (size_t lane = 0; i + lane < count; lane++) {
+                    result[i + lane] = tailResult[lane];
+                }
+            }
+        }
+
+        // ====== 色调映射 ======
+
+        //每次处理16个像素的48个分量，48是所有向量包宽度的整数倍
+        constexpr size_t TONE_MAP_BLOCK = 16;
+
+        //和Color3::writeColor相同：伽马2.0校正后裁剪到[0.0, 0.999]，映射到[0, 255]
+        template <typename P>
+        inline void toneMapBlock(const float * color, int32_t * channel) {
+            using V = typename P::Vector;
+            const V zero = P::broadcast(0.0f), upper = P::broadcast(0.999f), scale = P::broadcast(256.0f);
+            for (size_t i = 0; i < 3 * TONE_MAP_BLOCK; i += P::WIDTH) {
+                const V c = P::min(P::sqrt(P::max(P::load(color + i), zero)), upper);
+                P::storeInt(channel + i, P::mul(c, scale));
+            }
+        }
+
+        template <typename P>
+        void toneMap(const float * color, size_t count, const PixelLayout & layout, Uint32 * pixels) {
+            static_assert(std::is_same<typename P::Scalar, float>::value, "Tone mapping works on float colors");
+            int32_t channel[3 * TONE_MAP_BLOCK];
+
+            const auto write = [&](size_t begin, size_t pixelCount) {
+                for (size_t k = 0; k < pixelCount; k++) {
+                    pixels[begin + k] = (static_cast<Uint32>(channel[3 * k]) << layout.rShift) |
+                                        (static_cast<Uint32>(channel[3 * k + 1]) << layout.gShift) |
+                                        (static_cast<Uint32>(channel[3 * k + 2]) << layout.bShift) | layout.alphaMask;
+                }
+            };
+
+            size_t i = 0;
+            for (; i + TONE_MAP_BLOCK <= count; i += TONE_MAP_BLOCK) {
+                toneMapBlock<P>(color + 3 * i, channel);
+                write(i, TONE_MAP_BLOCK);
+            }
+            if (i < count) {
+                const float * source[1] = {color + 3 * i};
+                const PaddedTail<float, 3 * TONE_MAP_BLOCK, 1> tail(source, 0, 3 * (count - i));
+                toneMapBlock<P>(tail.pointer[0], channel);
+                write(i, count - i);
+            }
+        }
+
+        //使用向量包P实例化所有计算核，toneMap固定使用float向量包F
+        template <typename P, typename F>
+        constexpr KernelTable makeKernelTable(InstructionSet instructionSet, const char * name) {
+            return KernelTable {
+                    instructionSet, name,
+                    aabbHit<P>, sphereHit<P>, triangleHit<P>, watertightTriangleHit<P>, perlinVectorNoise<P>, toneMap<F>
+            };
+        }
+    }
+}
+
+#endif //RENDERERTEST_SIMDKERNELS_HPP
@@ -0,0 +1,96 @@
+#ifndef RENDERERTEST_SCENEARENA_HPP
+#define RENDERERTEST_SCENEARENA_HPP
+
+#include <util/MemoryArena.hpp>
+#include <mutex>
+
+namespace renderer {
+    /*
+     * 场景分配器：物体、BVH节点和包围盒等和场景生命周期相同的对象从连续的内存块中顺序分配
+     *
+     * 对象仍由shared_ptr管理，使用allocate_shared将对象和引用计数放在分配器的内存块中，外部接口不变
+     * 引用计数归零时只析构对象，不逐个释放内存；所有对象和分配器本身都销毁后，内存块整体释放
+     * 每个对象的控制块持有内存块的引用，对象可以比分配器活得更久，不会访问已释放的内存
+     *
+     * 同类对象连续构造时在内存中相邻，遍历时缓存和预取更有效；分配只在构造场景时进行，使用互斥锁保护
+     * 被提前释放的对象占用的内存直到场景销毁才回收，不适合反复创建和丢弃的临时对象（使用MemoryArena）
+     */
+    class SceneArena final {
+    private:
+        struct Storage {
+            std::mutex mutex;
+            MemoryArena arena;
+
+            explicit Storage(size_t blockSize) : arena(blockSize) {}
+        };
+
+        std::shared_ptr<Storage> storage;
+
+    public:
+        //供allocate_shared使用的分配器，释放为空操作
+        template <typename T>
+        class Allocator {
+        private:
+            template <typename U>
+            friend class Allocator;
+
+            std::shared_ptr<Storage> storage;
+
+        public:
+            typedef T value_type;
+
+            explicit Allocator(const std::shared_ptr<Storage> & storage) : storage(storage) {}
+
+            template <typename U>
+            Allocator(const Allocator<U> & allocator) : storage(allocator.storage) {}
+
+            T * allocate(size_t count) {
+                std::lock_guard<std::mutex> lock(storage->mutex);
+                return static_cast<T *>(storage->arena.allocate(sizeof(T) * count, alignof(T)));
+            }
+
+            void deallocate(T *, size_t) {}
+
+            template <typename U>
+            bool operator==(const Allocator<U> & allocator) const { return storage == allocator.storage; }
+
+            template <typename U>
+            bool operator!=(const Allocator<U> & allocator) const { return storage != allocator.storage; }
+        };
+
+        //只容纳少量对象的场景（如小的BVH）使用较小的内存块，避免每个分配器至少占用一个默认大小的内存块
+        explicit SceneArena(size_t blockSize = MemoryArena::BLOCK_SIZE) : storage(std::make_shared<Storage>(blockSize)) {}
+
+        SceneArena(const SceneArena &) = delete;
+        SceneArena & operator=(const SceneArena &) = delete;
+
+        // ====== 对象操作函数 ======
+
+        //在分配器中构造对象
+        template <typename T, typename ... Args>
+        std::shared_ptr<T> make(Args && ... args) {
+            return std::allocate_shared<T>(Allocator<T>(storage), std::forward<Args>(args)...);
+        }
+
+        // ====== 静态操作函数 ======
+
+        //arena为null时使用make_shared，供可选使用场景分配器的构造过程调用
+        template <typename T, typename ... Args>
+        static std::shared_ptr<T> create(SceneArena * arena, Args && ... args) {
+            if (arena == null) {
+                return std::make_shared<T>(std::forward<Args>(args)...);
+            }
+            return arena->make<T>(std::forward<Args>(args)...);
+        }
+
+        // ====== 类封装函数 ======
+
+        //已申请的内存总字节数
+        size_t capacity() const {
+            std::lock_guard<std::mutex> lock(storage->mutex);
+            return storage->arena.capacity();
+        }
+    };
+}
+
+#endif //RENDERERTEST_SCENEARENA_HPP
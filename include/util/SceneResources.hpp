@@ -0,0 +1,49 @@
+#ifndef RENDERERTEST_SCENERESOURCES_HPP
+#define RENDERERTEST_SCENERESOURCES_HPP
+
+#include <material/AbstractMaterial.hpp>
+#include <texture/AbstractTexture.hpp>
+
+namespace renderer {
+    /*
+     * 场景资源：一个场景的材质表和纹理表，和场景的物体一起创建，场景销毁时释放其中所有资源
+     * 物体构造时传入材质句柄，渲染时相机通过同一个场景资源解析碰撞记录中的句柄
+     * 同一个场景的所有物体（包括BVH、优化后的集合和延迟生成的物体）必须使用同一个场景资源中的句柄
+     */
+    class SceneResources final {
+    public:
+        //材质通过句柄引用纹理，纹理表在材质表之后析构
+        TextureTable textures;
+        MaterialTable materials;
+
+        /*
+         * 渲染期间将资源表设为只读，作用域结束时恢复
+         * 渲染期间运行的代码（如ProceduralNode的生成函数）只能引用已登记的资源，登记新资源会抛出异常
+         */
+        class ReadOnlyScope final {
+        private:
+            SceneResources & resources;
+
+        public:
+            explicit ReadOnlyScope(SceneResources & resources) : resources(resources) {
+                resources.materials.setReadOnly(true);
+                resources.textures.setReadOnly(true);
+            }
+            ~ReadOnlyScope() {
+                resources.materials.setReadOnly(false);
+                resources.textures.setReadOnly(false);
+            }
+
+            ReadOnlyScope(const ReadOnlyScope &) = delete;
+            ReadOnlyScope & operator=(const ReadOnlyScope &) = delete;
+        };
+
+        SceneResources() = default;
+        ~SceneResources() = default;
+
+        SceneResources(const SceneResources &) = delete;
+        SceneResources & operator=(const SceneResources &) = delete;
+    };
+}
+
+#endif //RENDERERTEST_SCENERESOURCES_HPP
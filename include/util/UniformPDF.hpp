@@ -16,7 +16,7 @@ namespace renderer {
             return Vec3::randomSpaceVector(1.0);
         }
 
-        double value(const Vec3 &vec) const override {
+        Real value(const Vec3 &vec) const override {
             //单位球的面积为4π
             return 1.0 / (4.0 * PI);
         }
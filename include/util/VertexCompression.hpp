@@ -0,0 +1,111 @@
+#ifndef RENDERERTEST_VERTEXCOMPRESSION_HPP
+#define RENDERERTEST_VERTEXCOMPRESSION_HPP
+
+#include <basic/Vec3.hpp>
+
+namespace renderer {
+    /*
+     * 顶点属性的压缩编码，只在finalize中解码
+     *
+     * 法向量：八面体编码（Cigolle 2014），单位球面投影到八面体再展开为[-1, 1]的正方形，两个分量各用16位有符号定点数，共32位
+     *   最大角度误差约0.005度，远小于插值法向量本身的误差
+     * 标量（纹理坐标、顶点坐标）：相对数组的范围量化为16位无符号定点数，解码为offset + q * scale
+     *   不使用半精度浮点数：纹理坐标接近1时半精度的间隔约为5e-4，4K纹理上约2个纹素；定点数的间隔为范围的1/65535
+     */
+    class VertexCompression {
+    public:
+        //16位定点数的最大值
+        static constexpr Uint16 MAX_LEVEL = 65535;
+
+        //量化参数，解码值为offset + q * scale
+        struct Quantization {
+            Real offset;
+            Real scale;
+        };
+
+        // ====== 法向量 ======
+
+        //编码法向量，不要求是单位向量，零向量编码为(0, 0, 1)
+        static Uint32 encodeNormal(Real x, Real y, Real z) {
+            const Real length = std::abs(x) + std::abs(y) + std::abs(z);
+            if (length == 0.0) {
+                return packNormal(0.0, 0.0);
+            }
+            x /= length;
+            y /= length;
+            if (z < 0.0) {
+                //下半球沿对角线翻折到正方形的四个角
+                const Real foldedX = (1.0 - std::abs(y)) * signNotZero(x);
+                const Real foldedY = (1.0 - std::abs(x)) * signNotZero(y);
+                x = foldedX;
+                y = foldedY;
+            }
+            return packNormal(x, y);
+        }
+
+        //解码为非单位向量，调用者插值后再单位化
+        static Vec3 decodeNormal(Uint32 code) {
+            Real x = static_cast<Sint16>(code & 0xFFFFu) / 32767.0;
+            Real y = static_cast<Sint16>(code >> 16) / 32767.0;
+            const Real z = 1.0 - std::abs(x) - std::abs(y);
+            const Real t = std::max<Real>(-z, 0.0);
+            x += x >= 0.0 ? -t : t;
+            y += y >= 0.0 ? -t : t;
+            return Vec3(x, y, z);
+        }
+
+        // ====== 标量 ======
+
+        //计算values中每隔stride个的分量（从first开始）的量化参数
+        static Quantization quantization(const std::vector<Real> & values, size_t first, size_t stride) {
+            Real min = std::numeric_limits<Real>::max(), max = std::numeric_limits<Real>::lowest();
+            for (size_t i = first; i < values.size(); i += stride) {
+                min = std::min(min, values[i]);
+                max = std::max(max, values[i]);
+            }
+            if (min > max) {
+                return {0.0, 0.0};
+            }
+            return {min, static_cast<Real>((max - min) / MAX_LEVEL)};
+        }
+
+        static Uint16 quantize(Real value, const Quantization & quantization) {
+            if (quantization.scale <= 0.0) {
+                return 0;
+            }
+            const Real level = std::round((value - quantization.offset) / quantization.scale);
+            return static_cast<Uint16>(std::min<Real>(std::max<Real>(level, 0.0), static_cast<Real>(MAX_LEVEL)));
+        }
+
+        static Real dequantize(Uint16 code, const Quantization & quantization) {
+            return quantization.offset + code * quantization.scale;
+        }
+
+        //将每个元素有stride个分量的数组按分量量化，quantizations输出每个分量的量化参数
+        static std::vector<Uint16> quantize(const std::vector<Real> & values, size_t stride, Quantization * quantizations) {
+            for (size_t i = 0; i < stride; i++) {
+                quantizations[i] = quantization(values, i, stride);
+            }
+            std::vector<Uint16> ret(values.size());
+            for (size_t i = 0; i < values.size(); i++) {
+                ret[i] = quantize(values[i], quantizations[i % stride]);
+            }
+            return ret;
+        }
+
+    private:
+        static Real signNotZero(Real value) {
+            return value >= 0.0 ? 1.0 : -1.0;
+        }
+
+        static Uint32 packNormal(Real x, Real y) {
+            const auto component = [](Real value) {
+                const auto level = static_cast<Sint16>(std::round(std::min<Real>(std::max<Real>(value, -1.0), 1.0) * 32767.0));
+                return static_cast<Uint32>(static_cast<Uint16>(level));
+            };
+            return component(x) | (component(y) << 16);
+        }
+    };
+}
+
+#endif //RENDERERTEST_VERTEXCOMPRESSION_HPP
@@ -1,13 +1,71 @@
 #include <Camera.hpp>
 #include <util/HittablePDF.hpp>
 #include <util/MixturePDF.hpp>
+#include <util/KernelDispatch.hpp>
 
 using namespace std;
 
 namespace renderer {
+    //视锥预处理得到的入口物体，以及入口物体包围盒在三个坐标轴上的投影区间（SoA布局，供计算核批量测试）
+    struct FrustumEntries {
+        vector<const AbstractHittable *> objects;
+        array<vector<Real>, 6> bounds;
+        vector<Real> tNear;
+
+        //重新收集入口物体，保留上一次收集时分配的空间
+        void collect(const HittableCollection & collection, const Frustum & frustum) {
+            objects.clear();
+            for (auto & bound : bounds) {
+                bound.clear();
+            }
+            collection.frustumEntries(frustum, objects);
+            for (const auto obj : objects) {
+                const Bounds & objectBounds = obj->getBounds();
+                for (size_t i = 0; i < 3; i++) {
+                    bounds[i].push_back(objectBounds.minimum[i]);
+                    bounds[i + 3].push_back(objectBounds.maximum[i]);
+                }
+            }
+            tNear.resize(objects.size());
+        }
+    };
+
+    //依次测试视锥预处理得到的入口物体，找出最近的交点
+    bool hitEntries(FrustumEntries & entries, const Ray & ray, const Range & range, HitRecord & record) {
+        //首先批量测试所有入口物体的轴对齐包围盒，没有击中或进入点比已找到的交点更远的物体不需要求交
+        const Point3 & origin = ray.getOrigin();
+        const Vec3 & inverse = ray.getInverseDirection();
+        const Real rayOrigin[3] = {origin[0], origin[1], origin[2]};
+        const Real inverseDirection[3] = {inverse[0], inverse[1], inverse[2]};
+        const Real * bounds[6];
+        for (size_t i = 0; i < 6; i++) {
+            bounds[i] = entries.bounds[i].data();
+        }
+        KernelDispatch::kernels().aabbHit(bounds, entries.objects.size(), rayOrigin, inverseDirection,
+                                          range.getMin(), range.getMax(), entries.tNear.data());
+
+        bool isHit = false;
+        Real maxT = range.getMax();
+        for (size_t i = 0; i < entries.objects.size(); i++) {
+            if (entries.tNear[i] > maxT) continue;
+            if (entries.objects[i]->intersect(ray, Range(range.getMin(), maxT), record)) {
+                isHit = true;
+                maxT = record.t;
+            }
+        }
+
+        //只为最近的交点填写碰撞信息
+        if (isHit) {
+            record.object->finalize(ray, record);
+        }
+        return isHit;
+    }
+
     //递归获取指定光线的最终颜色
-    Color3 rayColor(Camera & cam, const HittableCollection & collection, const Ray & ray, Uint32 currentIterateDepth,
-                    const vector<shared_ptr<AbstractHittable>> * pdfObjectList, size_t sampleIndex) {
+    //primaryEntries不为空时，当前光线为视锥内的主光线，从入口物体开始遍历场景
+    Color3 rayColor(Camera & cam, const HittableCollection & collection, const SceneResources & resources, const Ray & ray, Uint32 currentIterateDepth,
+                    const vector<shared_ptr<AbstractHittable>> * pdfObjectList, size_t sampleIndex,
+                    FrustumEntries * primaryEntries = null) {
         if (currentIterateDepth >= cam.rayTraceDepth) {
             return Color3(); //达到最大递归深度，当前递归层次的颜色不再做出贡献
         }
@@ -15,21 +73,23 @@ namespace renderer {
         ScatterRecord scatterRecord;
 
         //range最小值略微大于0，避免由于浮点数误差使得光线和物体碰撞点未精确落在物体表面上导致的错误
-        if (collection.hit(ray, Range(0.001, INFINITY), record)) {
+        const Range range(0.001, INFINITY);
+        if (primaryEntries != null ? hitEntries(*primaryEntries, ray, range, record) : collection.hit(ray, range, record)) {
             Ray out;
-            double pdfValue;
+            Real pdfValue;
 
             /*
              * 尝试对record的材质属性进行向下转型，判断是否为发光材质
              * 不能直接通过material.scatter的返回值判断：Metal等非发光材质不一定返回true
              */
-            const auto lightMaterial = std::dynamic_pointer_cast<AbstractLight>(record.material);
-            if (lightMaterial) {
+            const AbstractMaterial * material = resources.materials.get(record.material);
+            const auto * lightMaterial = dynamic_cast<const AbstractLight *>(material);
+            if (lightMaterial != null) {
                 //emitted实现光源背面剔除
                 return lightMaterial->emitted(ray, record);
             } else {
                 //如果非发光材质的scatter函数返回false，说明由于计算问题，当前光线无效
-                if (!record.material->scatter(ray, record, scatterRecord)) {
+                if (!material->scatter(ray, record, scatterRecord)) {
                     return Color3();
                 } else {
                     //TODO 多条阴影光线
@@ -54,7 +114,7 @@ namespace renderer {
 
                     //构造从碰撞点到光源上随机点的向量
                     const Vec3 toLight = Point3::constructVector(record.hitPoint, onLight);
-                    const double distanceSquare = toLight.lengthSquare();
+                    const Real distanceSquare = toLight.lengthSquare();
                     const Vec3 toLightUnitize = toLight.unitVector();
 
                     //保证参数有效
@@ -63,29 +123,27 @@ namespace renderer {
                         return Color3();
                     }
 
-                    const double lightArea = (343.0 - 213.0) * (332.0 - 227.0);
+                    const Real lightArea = (343.0 - 213.0) * (332.0 - 227.0);
                     //theta为光源平面法向量和点到光源上点向量的夹角，要取绝对值保证面积不为负
                     pdfValue = distanceSquare / (abs(Vec3::dot(toLightUnitize, Vec3(0, -1, 0))) * lightArea);
                     out = Ray(record.hitPoint, toLightUnitize, ray.getTime());*/
 
                     if (scatterRecord.isSkipPDF) {
                         //不计算PDF
-                        return scatterRecord.attenuation * rayColor(cam, collection, scatterRecord.skipPDFRay, currentIterateDepth + 1, pdfObjectList, sampleIndex);
+                        return scatterRecord.attenuation * rayColor(cam, collection, resources, scatterRecord.skipPDFRay, currentIterateDepth + 1, pdfObjectList, sampleIndex);
                     }
 
-                    //将要采样的物体和当前材质的PDF添加到列表
-                    vector<shared_ptr<AbstractPDF>> pdfList;
-                    if (pdfObjectList != null) {
-                        pdfList.reserve(pdfObjectList->size());
-                        for (const auto & item : *pdfObjectList) {
-                            const auto ptr = make_shared<HittablePDF>(item, record.hitPoint);
-                            pdfList.push_back(ptr);
-                        }
+                    //将要采样的物体和当前材质的PDF添加到列表，列表和PDF均从当前线程的分配器中分配，路径结束后统一回收
+                    MemoryArena & arena = MemoryArena::local();
+                    const size_t objectCount = pdfObjectList != null ? pdfObjectList->size() : 0;
+                    const auto ** pdfList = arena.allocateArray<const AbstractPDF *>(objectCount + 1);
+                    for (size_t i = 0; i < objectCount; i++) {
+                        pdfList[i] = arena.create<HittablePDF>((*pdfObjectList)[i].get(), record.hitPoint);
                     }
-                    pdfList.push_back(scatterRecord.pdf);
+                    pdfList[objectCount] = scatterRecord.pdf;
 
                     //构造混合PDF
-                    MixturePDF pdf(pdfList);
+                    MixturePDF pdf(pdfList, objectCount + 1);
                     out = Ray(record.hitPoint, pdf.generate(), ray.getTime());
                     pdfValue = pdf.value(out.getDirection());
 
@@ -94,8 +152,8 @@ namespace renderer {
                         return Color3();
                     }
 
-                    const double scatterPDF = record.material->scatterPDF(ray, record, out);
-                    const Color3 nextColor = rayColor(cam, collection, out, currentIterateDepth + 1, pdfObjectList, sampleIndex);
+                    const Real scatterPDF = material->scatterPDF(ray, record, out);
+                    const Color3 nextColor = rayColor(cam, collection, resources, out, currentIterateDepth + 1, pdfObjectList, sampleIndex);
 
                     if (!cam.isRecordList[sampleIndex]) {
                         cam.albedoList[sampleIndex] = scatterRecord.attenuation;
@@ -132,104 +190,129 @@ namespace renderer {
         }
     }
 
-    void Camera::render(SDL_Window * window, Uint32 * pixels, const SDL_PixelFormat * format,
-                        const HittableCollection & collection, const std::vector<std::shared_ptr<AbstractHittable>> * pdfObjectList)
+    void Camera::render(SDL_Window * window, Uint32 * pixels, const SDL_PixelFormat * format, const HittableCollection & collection,
+                        SceneResources & resources, const std::vector<std::shared_ptr<AbstractHittable>> * pdfObjectList)
     {
+        //渲染期间资源表只读，着色时查询资源表不加锁
+        const SceneResources::ReadOnlyScope readOnlyScope(resources);
         Uint32 lastRate = 0;
         SDL_Log("Render Start...");
 
-        //逐个获取像素颜色，写入到屏幕的对应位置
-        for (Uint32 i = 0; i < windowHeight; i++) {
-            for (Uint32 j = 0; j < windowWidth; j++) {
-                SDL_Event event;
-                while (SDL_PollEvent(&event)) {
-                    if (event.type == SDL_QUIT) { exit(1); }
-                }
-
-                //当前像素最终颜色
-                Color3 color;
-                Color3 albedo;
-                Vec3 normal;
+        //每条路径的临时对象从当前线程的分配器中分配，路径结束后回收
+        MemoryArena & arena = MemoryArena::local();
+        FrustumEntries entries;
 
-                fill(isRecordList.begin(), isRecordList.end(), false);
-
-                //亚像素采样抗锯齿
-                /*for (Uint32 k = 0; k < sampleCount; k++) {
-                    //当前像素对应位置
-                    const Point3 samplePoint =
-                            pixelOrigin + (i + randomDouble(-sampleRange, sampleRange)) * viewPortPixelDy + (j + randomDouble(-sampleRange, sampleRange)) * viewPortPixelDx;
-
-                    //单次离焦采样：在离焦半径内随机选取一个点，以这个点发射光线
-                    Point3 rayOrigin = cameraCenter;
-                    if (focusDiskRadius > 0.0) {
-                        const Vec3 defocusVector = Vec3::randomPlaneVector(focusDiskRadius);
-                        //使用视口方向向量定位采样点
-                        rayOrigin = cameraCenter + defocusVector[0] * cameraU + defocusVector[1] * cameraV;
-                    }
-
-                    //在快门开启时段内随机找一个时刻发射光线并追踪
-                    const Vec3 rayDirection = Point3::constructVector(rayOrigin, samplePoint).unitVector();
-                    const Ray ray(rayOrigin, rayDirection, randomDouble(shutterRange.getMin(), shutterRange.getMax()));
-                    color += rayColor(*this, collection, ray, 0);
-                }*/
+        //按块获取像素颜色，写入到屏幕的对应位置
+        for (Uint32 tileI = 0; tileI < windowHeight; tileI += TILE_SIZE) {
+            const Uint32 endI = min(tileI + TILE_SIZE, windowHeight);
+            for (Uint32 tileJ = 0; tileJ < windowWidth; tileJ += TILE_SIZE) {
+                const Uint32 endJ = min(tileJ + TILE_SIZE, windowWidth);
 
                 /*
-                 * 亚像素采样抗锯齿：改进版采样方法
-                 * 将亚像素采样区域划分为网格，在每个小网格中随机选点发射光线，双重循环次数均为采样数的开方
-                 *     则每一个小区域都有且仅有一个采样点
-                 * 分层采样通过让采样点更加均匀地分散在采样区域内，降低了采样的方差
-                 *
-                 * 在相同的采样总数下，分层采样得到的图像噪点更少，图像收敛到最终清晰状态的速度更快
-                 * 随机采样噪点连续大块，分层采样的噪点均匀细小，更加不明显
+                 * 针孔相机的主光线都从相机中心出发，块内所有主光线位于同一个视锥内
+                 * 每个块只对场景进行一次视锥预处理，剔除视锥外的节点，主光线从入口节点开始遍历，跳过树的上层
+                 * 离焦采样的光线起点不同，不使用视锥剔除
                  */
+                FrustumEntries * primaryEntries = null;
+                if (focusDiskRadius <= 0.0) {
+                    entries.collect(collection, tileFrustum(tileI, endI, tileJ, endJ));
+                    primaryEntries = &entries;
+                }
 
-                for (size_t sampleI = 0; sampleI < sqrtSampleCount; sampleI++) {
-                    for (size_t sampleJ = 0; sampleJ < sqrtSampleCount; sampleJ++) {
-                        const double offsetX = ((sampleJ + randomDouble()) * reciprocalSqrtSampleCount) - 0.5;
-                        const double offsetY = ((sampleI + randomDouble()) * reciprocalSqrtSampleCount) - 0.5;
-                        const Point3 samplePoint =
-                                pixelOrigin + ((j + offsetX) * viewPortPixelDx) + ((i + offsetY) * viewPortPixelDy);
-
-                        //单次离焦采样
-                        Point3 rayOrigin = cameraCenter;
-                        if (focusDiskRadius > 0.0) {
-                            const Vec3 defocusVector = Vec3::randomPlaneVector(focusDiskRadius);
-                            rayOrigin = cameraCenter + defocusVector[0] * cameraU + defocusVector[1] * cameraV;
+                for (Uint32 i = tileI; i < endI; i++) {
+                    for (Uint32 j = tileJ; j < endJ; j++) {
+                        SDL_Event event;
+                        while (SDL_PollEvent(&event)) {
+                            if (event.type == SDL_QUIT) { exit(1); }
                         }
 
-                        //发射光线
-                        const Vec3 rayDirection = Point3::constructVector(rayOrigin, samplePoint).unitVector();
-                        const Ray ray(rayOrigin, rayDirection, randomDouble(shutterRange.getMin(), shutterRange.getMax()));
+                        //当前像素最终颜色
+                        Color3 color;
+                        Color3 albedo;
+                        Vec3 normal;
+
+                        fill(isRecordList.begin(), isRecordList.end(), false);
+
+                        //亚像素采样抗锯齿
+                        /*for (Uint32 k = 0; k < sampleCount; k++) {
+                            //当前像素对应位置
+                            const Point3 samplePoint =
+                                    pixelOrigin + (i + randomDouble(-sampleRange, sampleRange)) * viewPortPixelDy + (j + randomDouble(-sampleRange, sampleRange)) * viewPortPixelDx;
+
+                            //单次离焦采样：在离焦半径内随机选取一个点，以这个点发射光线
+                            Point3 rayOrigin = cameraCenter;
+                            if (focusDiskRadius > 0.0) {
+                                const Vec3 defocusVector = Vec3::randomPlaneVector(focusDiskRadius);
+                                //使用视口方向向量定位采样点
+                                rayOrigin = cameraCenter + defocusVector[0] * cameraU + defocusVector[1] * cameraV;
+                            }
+
+                            //在快门开启时段内随机找一个时刻发射光线并追踪
+                            const Vec3 rayDirection = Point3::constructVector(rayOrigin, samplePoint).unitVector();
+                            const Ray ray(rayOrigin, rayDirection, randomDouble(shutterRange.getMin(), shutterRange.getMax()));
+                            color += rayColor(*this, collection, resources, ray, 0);
+                        }*/
 
-                        const size_t sampleIndex = sampleI * sqrtSampleCount + sampleJ;
-                        color += rayColor(*this, collection, ray, 0, pdfObjectList, sampleIndex);
+                        /*
+                         * 亚像素采样抗锯齿：改进版采样方法
+                         * 将亚像素采样区域划分为网格，在每个小网格中随机选点发射光线，双重循环次数均为采样数的开方
+                         *     则每一个小区域都有且仅有一个采样点
+                         * 分层采样通过让采样点更加均匀地分散在采样区域内，降低了采样的方差
+                         *
+                         * 在相同的采样总数下，分层采样得到的图像噪点更少，图像收敛到最终清晰状态的速度更快
+                         * 随机采样噪点连续大块，分层采样的噪点均匀细小，更加不明显
+                         */
 
-                        //累加当前采样点的降噪数据
-                        albedo += albedoList[sampleIndex];
-                        normal += normalList[sampleIndex];
-                    }
-                }
+                        for (size_t sampleI = 0; sampleI < sqrtSampleCount; sampleI++) {
+                            for (size_t sampleJ = 0; sampleJ < sqrtSampleCount; sampleJ++) {
+                                const Real offsetX = ((sampleJ + randomDouble()) * reciprocalSqrtSampleCount) - 0.5;
+                                const Real offsetY = ((sampleI + randomDouble()) * reciprocalSqrtSampleCount) - 0.5;
+                                const Point3 samplePoint =
+                                        pixelOrigin + ((j + offsetX) * viewPortPixelDx) + ((i + offsetY) * viewPortPixelDy);
+
+                                //单次离焦采样
+                                Point3 rayOrigin = cameraCenter;
+                                if (focusDiskRadius > 0.0) {
+                                    const Vec3 defocusVector = Vec3::randomPlaneVector(focusDiskRadius);
+                                    rayOrigin = cameraCenter + defocusVector[0] * cameraU + defocusVector[1] * cameraV;
+                                }
+
+                                //发射光线
+                                const Vec3 rayDirection = Point3::constructVector(rayOrigin, samplePoint).unitVector();
+                                const Ray ray(rayOrigin, rayDirection, randomDouble(shutterRange.getMin(), shutterRange.getMax()));
+
+                                const size_t sampleIndex = sampleI * sqrtSampleCount + sampleJ;
+                                color += rayColor(*this, collection, resources, ray, 0, pdfObjectList, sampleIndex, primaryEntries);
+                                arena.reset();
+
+                                //累加当前采样点的降噪数据
+                                albedo += albedoList[sampleIndex];
+                                normal += normalList[sampleIndex];
+                            }
+                        }
 
-                //将降噪数据写入全局缓冲区
-                albedo *= reciprocalSqrtSampleCount * reciprocalSqrtSampleCount;
-                normal.unitize();
+                        //将降噪数据写入全局缓冲区
+                        albedo *= reciprocalSqrtSampleCount * reciprocalSqrtSampleCount;
+                        normal.unitize();
 
-                const size_t pixelIndex = (i * windowWidth + j) * 3;
-                for (int k = 0; k < 3; k++) {
-                    denoiser.colorPtr[pixelIndex + k] = static_cast<float>(color[k] * reciprocalSqrtSampleCount * reciprocalSqrtSampleCount);
-                    denoiser.albedoPtr[pixelIndex + k] = static_cast<float>(albedo[k]);
-                    denoiser.normalPtr[pixelIndex + k] = static_cast<float>(normal[k]);
-                }
+                        const size_t pixelIndex = (i * windowWidth + j) * 3;
+                        for (int k = 0; k < 3; k++) {
+                            denoiser.colorPtr[pixelIndex + k] = static_cast<float>(color[k] * reciprocalSqrtSampleCount * reciprocalSqrtSampleCount);
+                            denoiser.albedoPtr[pixelIndex + k] = static_cast<float>(albedo[k]);
+                            denoiser.normalPtr[pixelIndex + k] = static_cast<float>(normal[k]);
+                        }
 
-                //取颜色平均值
-                color /= sampleCount;
+                        //取颜色平均值
+                        color /= sampleCount;
 
-                //将当前像素的颜色写入到屏幕中（降噪前图像）
-                color.writeColor(pixels + (i * windowWidth + j), format);
+                        //将当前像素的颜色写入到屏幕中（降噪前图像）
+                        color.writeColor(pixels + (i * windowWidth + j), format);
+                    }
+                }
             }
 
             //每渲染1个百分比打印一次进度
-            const auto rate = static_cast<Uint32>(i * 100 / windowHeight);
+            const auto rate = static_cast<Uint32>(endI * 100 / windowHeight);
             if (rate / 1 != lastRate) {
                 lastRate = rate / 1;
                 SDL_Log("Rendered %u%%", rate);
@@ -241,16 +324,59 @@ namespace renderer {
         denoiser.denoiseAndWrite(pixels, format);
     }
 
-    Camera::Camera(Uint32 windowWidth, Uint32 windowHeight, const Color3 & backgroundColor, const Point3 &center, const Point3 &target, double fov, double focusDiskRadius,
-                   const Range &shutterRange, Uint32 sampleCount, double sampleRange, Uint32 rayTraceDepth) :
+    Frustum Camera::tileFrustum(Uint32 startRow, Uint32 endRow, Uint32 startColumn, Uint32 endColumn) const {
+        //像素内的采样点偏移在[-0.5, 0.5]之间，视锥需要包含块边缘像素的整个范围
+        const auto corner = [this](Uint32 row, Uint32 column) {
+            return pixelOrigin + ((column - 0.5) * viewPortPixelDx) + ((row - 0.5) * viewPortPixelDy);
+        };
+        return Frustum(cameraCenter, {corner(startRow, startColumn), corner(startRow, endColumn),
+                                      corner(endRow, endColumn), corner(endRow, startColumn)});
+    }
+
+    std::vector<RecordedRay> Camera::recordRays(const std::shared_ptr<AbstractHittable> & object, SceneResources & resources,
+                                                const std::vector<std::shared_ptr<AbstractHittable>> * pdfObjectList, Uint32 pixelStride)
+    {
+        const SceneResources::ReadOnlyScope readOnlyScope(resources);
+
+        //使用记录器包装物体，rayColor中所有对场景的求交都经过记录器
+        const auto recorder = make_shared<RayRecorder>(object);
+        HittableCollection world;
+        world.add(recorder);
+
+        for (Uint32 i = pixelStride / 2; i < windowHeight; i += pixelStride) {
+            for (Uint32 j = pixelStride / 2; j < windowWidth; j += pixelStride) {
+                const Point3 samplePoint = pixelOrigin + ((j + randomDouble() - 0.5) * viewPortPixelDx) + ((i + randomDouble() - 0.5) * viewPortPixelDy);
+
+                Point3 rayOrigin = cameraCenter;
+                if (focusDiskRadius > 0.0) {
+                    const Vec3 defocusVector = Vec3::randomPlaneVector(focusDiskRadius);
+                    rayOrigin = cameraCenter + defocusVector[0] * cameraU + defocusVector[1] * cameraV;
+                }
+
+                const Vec3 rayDirection = Point3::constructVector(rayOrigin, samplePoint).unitVector();
+                const Ray ray(rayOrigin, rayDirection, randomDouble(shutterRange.getMin(), shutterRange.getMax()));
+
+                //只使用第一个降噪数据缓冲区，预渲染的颜色不使用
+                fill(isRecordList.begin(), isRecordList.end(), false);
+                rayColor(*this, world, resources, ray, 0, pdfObjectList, 0);
+                MemoryArena::local().reset();
+            }
+        }
+
+        SDL_Log("Recorded %zu Rays", recorder->getRays().size());
+        return recorder->getRays();
+    }
+
+    Camera::Camera(Uint32 windowWidth, Uint32 windowHeight, const Color3 & backgroundColor, const Point3 &center, const Point3 &target, Real fov, Real focusDiskRadius,
+                   const Range &shutterRange, Uint32 sampleCount, Real sampleRange, Uint32 rayTraceDepth) :
             windowWidth(windowWidth), windowHeight(windowHeight), backgroundColor(backgroundColor),
             cameraCenter(center), cameraTarget(target), horizontalFOV(fov), focusDiskRadius(focusDiskRadius),
             shutterRange(shutterRange), sampleCount(sampleCount), sampleRange(sampleRange), rayTraceDepth(rayTraceDepth),
             focusDistance(Point3::distance(cameraCenter, cameraTarget)), denoiser(Denoiser(windowWidth, windowHeight))
     {
-        const double thetaFOV = degreeToRadian(horizontalFOV);
-        const double vWidth = 2.0 * tan(thetaFOV / 2.0) * focusDistance;
-        const double vHeight = vWidth / (windowWidth * 1.0 / windowHeight);
+        const Real thetaFOV = degreeToRadian(horizontalFOV);
+        const Real vWidth = 2.0 * tan(thetaFOV / 2.0) * focusDistance;
+        const Real vHeight = vWidth / (windowWidth * 1.0 / windowHeight);
 
         this->viewPortWidth = vWidth;
         this->viewPortHeight = vHeight;
@@ -276,7 +402,7 @@ namespace renderer {
 
         //预计算倒数，加速除法
         this->sqrtSampleCount = static_cast<size_t>(sqrt(sampleCount));
-        this->reciprocalSqrtSampleCount = 1.0 / static_cast<double>(sqrtSampleCount);
+        this->reciprocalSqrtSampleCount = 1.0 / static_cast<Real>(sqrtSampleCount);
 
         this->normalList = vector<Vec3>(sqrtSampleCount * sqrtSampleCount, Vec3());
         this->albedoList = vector<Color3>(sqrtSampleCount * sqrtSampleCount, Color3());
@@ -296,13 +422,13 @@ namespace renderer {
                  "Sample Disk Radius: %.4lf, Focus Distance: %.4lf\n\t"
                  "Shutter %s\n\tSSAA Sample Count: %u, Range: %.2lf\n\t"
                  "Raytrace Depth: %u",
-                 windowWidth, windowHeight, backgroundColor.toString().c_str(),
-                 cameraCenter.toString().c_str(), cameraTarget.toString().c_str(),
+                 windowWidth, windowHeight, renderer::toString(backgroundColor).c_str(),
+                 renderer::toString(cameraCenter).c_str(), renderer::toString(cameraTarget).c_str(),
                  horizontalFOV, viewPortWidth, viewPortHeight,
-                 cameraU.toString().c_str(), cameraV.toString().c_str(), cameraW.toString().c_str(),
-                 viewPortPixelDx.toString().c_str(), viewPortPixelDy.toString().c_str(),
-                 viewPortOrigin.toString().c_str(), pixelOrigin.toString().c_str(),
-                 focusDiskRadius, focusDistance, shutterRange.toString().c_str(), sampleCount, sampleRange, rayTraceDepth
+                 renderer::toString(cameraU).c_str(), renderer::toString(cameraV).c_str(), renderer::toString(cameraW).c_str(),
+                 renderer::toString(viewPortPixelDx).c_str(), renderer::toString(viewPortPixelDy).c_str(),
+                 renderer::toString(viewPortOrigin).c_str(), renderer::toString(pixelOrigin).c_str(),
+                 focusDiskRadius, focusDistance, renderer::toString(shutterRange).c_str(), sampleCount, sampleRange, rayTraceDepth
         );
         return ret + buffer;
     }
@@ -14,15 +14,26 @@ namespace renderer {
                          80, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
         SDL_Log("%s", cam.toString().c_str());
 
+        //场景资源：场景中物体引用的材质和纹理，和物体一起在函数结束时释放
+        SceneResources resources;
+
         //定义物体材质
-        const auto groundMat = make_shared<Rough>(Color3(0.7, 0.6, 0.5));
+        const auto groundMat = resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.7, 0.6, 0.5)));
         //向场景中添加物体
         HittableCollection list;
         const auto ground = make_shared<Sphere>(groundMat, Point3(0.0, -1000.0, 0.0), 1000);
         list.add(ground);
 
-        //随机添加材质和物体
-        const int range = 4;
+        //随机添加材质和物体：每格的材质和球的参数在渲染前确定，材质同时登记到场景资源中（渲染期间资源表只读）
+        //球体按TILE x TILE格分块放入程序化节点，只有光线进入的块才在块的分配器中生成球体
+        struct CellSphere {
+            ResourceHandle material;
+            Point3 center, center2;
+            bool isMoving;
+        };
+        const int range = 4, tile = 3;
+        const int tileCount = (2 * range + 1) / tile;
+        vector<vector<CellSphere>> tiles(tileCount * tileCount);
         for (int a = -range; a <= range; a++) {
             for (int b = -range; b <= range; b++) {
                 double chooseMat = randomDouble();
@@ -30,40 +41,55 @@ namespace renderer {
 
                 if (Point3::constructVector(Point3(4.0, 0.2, 0.0), center).length() > 0.9) {
                     shared_ptr<AbstractMaterial> material;
+                    auto center2 = center;
                     if (chooseMat < 0.8) {
                         auto albedo = Color3::randomColor() * Color3::randomColor();
-                        material = make_shared<Rough>(albedo);
-                        auto center2 = center + Vec3(0.0, randomDouble(0.0, 0.5), 0.0);
-                        list.add(make_shared<Sphere>(material, center, center2, 0.2));
+                        material = make_shared<Rough>(resources.textures, albedo);
+                        center2 = center + Vec3(0.0, randomDouble(0.0, 0.5), 0.0);
                     } else if (chooseMat < 0.95) {
                         auto albedo = Color3::randomColor(0.5, 1.0);
                         auto fuzz = randomDouble(0.0, 0.5);
                         material = make_shared<Metal>(albedo, fuzz);
-                        list.add(make_shared<Sphere>(material, center, 0.2));
                     } else {
                         material = make_shared<Dielectric>(1.5);
-                        list.add(make_shared<Sphere>(material, center, 0.2));
                     }
+                    tiles[(a + range) / tile * tileCount + (b + range) / tile].push_back({resources.materials.add(material), center, center2, chooseMat < 0.8});
                 }
             }
         }
 
-        list.add(make_shared<Sphere>(make_shared<Dielectric>(1.5), Point3(0.0, 1.0, 0.0), 1.0));
-        list.add(make_shared<Sphere>(make_shared<Rough>(Color3(0.4, 0.2, 0.1)), Point3(-4.0, 1.0, 0.0), 1.0));
-        list.add(make_shared<Sphere>(make_shared<Metal>(Color3(0.7, 0.6, 0.5), 0.0), Point3(4.0, 1.0, 0.0), 1.0));
+        //球心在格子内偏移至多0.9，半径0.2，运动的球最多上升0.5
+        const auto cache = make_shared<ProceduralNode::Cache>(256 * 1024);
+        for (int i = 0; i < tileCount; i++) {
+            for (int j = 0; j < tileCount; j++) {
+                const vector<CellSphere> & spheres = tiles[i * tileCount + j];
+                const auto generator = [&spheres](SceneArena & arena, vector<shared_ptr<AbstractHittable>> & objects) {
+                    for (const auto & sphere : spheres) {
+                        if (sphere.isMoving) {
+                            objects.push_back(arena.make<Sphere>(sphere.material, sphere.center, sphere.center2, 0.2));
+                        } else {
+                            objects.push_back(arena.make<Sphere>(sphere.material, sphere.center, 0.2));
+                        }
+                    }
+                };
+                const double x = i * tile - range, z = j * tile - range;
+                list.add(make_shared<ProceduralNode>(Point3(x - 0.2, 0.0, z - 0.2), Point3(x + tile + 0.2, 0.9, z + tile + 0.2), generator, cache));
+            }
+        }
 
-        //使用包含所有物体的 list 来构造 BVH 树
-        auto bvhTree = make_shared<BVHTree>(list);
+        list.add(make_shared<Sphere>(resources.materials.add(make_shared<Dielectric>(1.5)), Point3(0.0, 1.0, 0.0), 1.0));
+        list.add(make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.4, 0.2, 0.1))), Point3(-4.0, 1.0, 0.0), 1.0));
+        list.add(make_shared<Sphere>(resources.materials.add(make_shared<Metal>(Color3(0.7, 0.6, 0.5), 0.0)), Point3(4.0, 1.0, 0.0), 1.0));
 
-        //创建一个新的 collection，并将构造好的 BVH 树作为唯一的物体添加进去
-        HittableCollection world;
-        world.add(bvhTree);
-
-        //渲染包含 BVH 树的 world
+        //物体个数超过阈值的列表在第一次求交时自动构造BVH，地面大球不参与划分，直接渲染list即可
         const Uint32 start = SDL_GetTicks();
-        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world);
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, list, resources);
         const Uint32 end = SDL_GetTicks();
         SDL_Log("Render Time: %u ms", end - start);
+        const auto statistics = cache->getStatistics();
+        SDL_Log("Procedural Tiles: %u, Expanded: %u, Evicted: %u, Peak Memory: %u KB",
+                static_cast<Uint32>(cache->chunkCount()), static_cast<Uint32>(statistics.loadCount),
+                static_cast<Uint32>(statistics.evictionCount), static_cast<Uint32>(statistics.peakBytes / 1024));
 
         //显示图像
         SDL_Log("Render Complete");
@@ -79,10 +105,11 @@ namespace renderer {
                          Point3(0.0, 2.0, 10.0), Point3(0.0, 2.0, 0.0),
                          100, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
         SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
 
-        const auto checker = make_shared<CheckerBoard>(Color3(), Color3(1.0, 1.0, 1.0), 0.32);
-        const auto sphere1 = make_shared<Sphere>(make_shared<Rough>(checker), Point3(0.0, -10.0, 0.0), 10.0);
-        const auto sphere2 = make_shared<Sphere>(make_shared<Rough>(checker), Point3(0.0, 10.0, 0.0), 10.0);
+        const auto checker = resources.textures.add(make_shared<CheckerBoard>(resources.textures, Color3(), Color3(1.0, 1.0, 1.0), 0.32));
+        const auto sphere1 = make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, checker)), Point3(0.0, -10.0, 0.0), 10.0);
+        const auto sphere2 = make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, checker)), Point3(0.0, 10.0, 0.0), 10.0);
 
         HittableCollection list;
         list.add(sphere1);
@@ -92,7 +119,7 @@ namespace renderer {
         HittableCollection world;
         world.add(bvhTree);
         const Uint32 start = SDL_GetTicks();
-        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world);
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world, resources);
         const Uint32 end = SDL_GetTicks();
         SDL_Log("Render Time: %u ms", end - start);
 
@@ -109,9 +136,10 @@ namespace renderer {
                          Point3(2.0, 0.0, 10.0), Point3(2.0, 0.0, 0.0),
                          60, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
         SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
 
-        const auto texture = make_shared<Image>(imgSurface);
-        const auto sphere = make_shared<Sphere>(make_shared<Rough>(texture), Point3(2.0, 0.0, 0.0), 2.0);
+        const auto texture = resources.textures.add(make_shared<Image>(imgSurface));
+        const auto sphere = make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, texture)), Point3(2.0, 0.0, 0.0), 2.0);
         HittableCollection list;
         list.add(sphere);
 
@@ -119,7 +147,7 @@ namespace renderer {
         HittableCollection world;
         world.add(bvhTree);
         const Uint32 start = SDL_GetTicks();
-        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world);
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world, resources);
         const Uint32 end = SDL_GetTicks();
         SDL_Log("Render Time: %u ms", end - start);
 
@@ -136,10 +164,11 @@ namespace renderer {
                          Point3(0.0, 2.0, 4.0), Point3(0.0, 2.0, 0.0),
                          100, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
         SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
 
-        const auto texture = make_shared<PerlinNoise>(1.0, PerlinNoiseType::RANDOM_TURBULENCE_NET);
-        const auto sphere1 = make_shared<Sphere>(make_shared<Rough>(texture), Point3(0.0, -1000.0, 0.0), 1000.0);
-        const auto sphere2 = make_shared<Sphere>(make_shared<Rough>(texture), Point3(0.0, 2.0, 0.0), 2.0);
+        const auto texture = resources.textures.add(make_shared<PerlinNoise>(1.0, PerlinNoiseType::RANDOM_TURBULENCE_NET));
+        const auto sphere1 = make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, texture)), Point3(0.0, -1000.0, 0.0), 1000.0);
+        const auto sphere2 = make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, texture)), Point3(0.0, 2.0, 0.0), 2.0);
 
         HittableCollection list;
         list.add(sphere1);
@@ -149,7 +178,7 @@ namespace renderer {
         HittableCollection world;
         world.add(bvhTree);
         const Uint32 start = SDL_GetTicks();
-        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world);
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world, resources);
         const Uint32 end = SDL_GetTicks();
         SDL_Log("Render Time: %u ms", end - start);
 
@@ -166,13 +195,14 @@ namespace renderer {
                          Point3(4.0, 2.0, 10.0), Point3(0.0, 2.0, 0.0),
                          80, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
         SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
 
-        const auto texture = make_shared<PerlinNoise>(3.0);
-        const auto sphere1 = make_shared<Sphere>(make_shared<Rough>(texture), Point3(0.0, -1000.0, 0.0), 1000.0);
-        const auto sphere2 = make_shared<Sphere>(make_shared<Rough>(texture), Point3(0.0, 2.0, 0.0), 2.0);
+        const auto texture = resources.textures.add(make_shared<PerlinNoise>(3.0));
+        const auto sphere1 = make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, texture)), Point3(0.0, -1000.0, 0.0), 1000.0);
+        const auto sphere2 = make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, texture)), Point3(0.0, 2.0, 0.0), 2.0);
 
         //内部计算时使用无限制光强（HDR），仅在写入颜色时限制到LDR的范围
-        const auto light = make_shared<DiffuseLight>(Color3(4.0, 4.0, 4.0));
+        const auto light = resources.materials.add(make_shared<DiffuseLight>(Color3(4.0, 4.0, 4.0)));
         const auto rectangle = make_shared<Parallelogram>(light, Point3(3.0, 1.0, -2.0), Vec3(4.0, 0.0, 0.0), Vec3(0.0, 4.0, 0.0));
 
         HittableCollection list;
@@ -184,7 +214,7 @@ namespace renderer {
         HittableCollection world;
         world.add(bvhTree);
         const Uint32 start = SDL_GetTicks();
-        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world);
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world, resources);
         const Uint32 end = SDL_GetTicks();
         SDL_Log("Render Time: %u ms", end - start);
 
@@ -201,12 +231,13 @@ namespace renderer {
                          Point3(0.0, 0.0, 20.0), Point3(0.0, 0.0, 0.0),
                          80, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
         SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
 
-        const auto leftRedMat = make_shared<Rough>(Color3(1.0, 0.2, 0.2));
-        const auto backGreenMat = make_shared<Rough>(Color3(0.2, 1.0, 0.2));
-        const auto rightBlueMat = make_shared<Rough>(Color3(0.2, 0.2, 1.0));
-        const auto upperOrangeMat = make_shared<Rough>(Color3(1.0, 0.5, 0.0));
-        const auto lowerTealMat = make_shared<Rough>(Color3(0.2, 0.8, 0.8));
+        const auto leftRedMat = resources.materials.add(make_shared<Rough>(resources.textures, Color3(1.0, 0.2, 0.2)));
+        const auto backGreenMat = resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.2, 1.0, 0.2)));
+        const auto rightBlueMat = resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.2, 0.2, 1.0)));
+        const auto upperOrangeMat = resources.materials.add(make_shared<Rough>(resources.textures, Color3(1.0, 0.5, 0.0)));
+        const auto lowerTealMat = resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.2, 0.8, 0.8)));
 
         const auto quad1 = make_shared<Parallelogram>(leftRedMat, Point3(-3.0, -2.0, 5.0), Vec3(0.0, 0.0, -4.0), Vec3(0.0, 4.0, 0.0));
         const auto quad2 = make_shared<Parallelogram>(backGreenMat, Point3(-2.0, -2.0, 0.0), Vec3(4.0, 0.0, 0.0), Vec3(0.0, 4.0, 0.0));
@@ -225,7 +256,7 @@ namespace renderer {
         HittableCollection world;
         world.add(bvhTree);
         const Uint32 start = SDL_GetTicks();
-        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world);
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world, resources);
         const Uint32 end = SDL_GetTicks();
         SDL_Log("Render Time: %u ms", end - start);
 
@@ -242,11 +273,11 @@ namespace renderer {
                          Point3(10.0, 2.0, 10.0), Point3(0.0, 0.0, 0.0),
                          80, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
         SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
 
-        const auto red = make_shared<Rough>(Color3(.65, .05, .05));
-        const auto white = make_shared<Rough>(Color3(.73, .73, .73));
-        const auto green = make_shared<Rough>(Color3(.12, .45, .15));
-        const auto light = make_shared<DiffuseLight>(Color3(15.0, 15.0, 15.0));
+        const auto red = resources.materials.add(make_shared<Rough>(resources.textures, Color3(.65, .05, .05)));
+        const auto white = resources.materials.add(make_shared<Rough>(resources.textures, Color3(.73, .73, .73)));
+        const auto green = resources.materials.add(make_shared<Rough>(resources.textures, Color3(.12, .45, .15)));
 
         HittableCollection list;
 
@@ -262,7 +293,7 @@ namespace renderer {
         HittableCollection world;
         world.add(bvhTree);
         const Uint32 start = SDL_GetTicks();
-        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world);
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world, resources);
         const Uint32 end = SDL_GetTicks();
         SDL_Log("Render Time: %u ms", end - start);
 
@@ -280,16 +311,17 @@ namespace renderer {
                          80, 0.0, Range(0.0, 1.0),
                          10, 0.5, 10);
         SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
 
         HittableCollection list;
 
         //材质
-        const auto red = make_shared<Rough>(Color3(.65, .05, .05));
-        const auto white = make_shared<Rough>(Color3(.73, .73, .73));
-        const auto green = make_shared<Rough>(Color3(.12, .45, .15));
-        const auto light = make_shared<DiffuseLight>(Color3(15, 15, 15));
-        const auto metal = make_shared<Metal>(Color3(0.8, 0.85, 0.88), 0.0);
-        const auto glass = make_shared<Dielectric>(1.5);
+        const auto red = resources.materials.add(make_shared<Rough>(resources.textures, Color3(.65, .05, .05)));
+        const auto white = resources.materials.add(make_shared<Rough>(resources.textures, Color3(.73, .73, .73)));
+        const auto green = resources.materials.add(make_shared<Rough>(resources.textures, Color3(.12, .45, .15)));
+        const auto light = resources.materials.add(make_shared<DiffuseLight>(Color3(15, 15, 15)));
+        const auto metal = resources.materials.add(make_shared<Metal>(Color3(0.8, 0.85, 0.88), 0.0));
+        const auto glass = resources.materials.add(make_shared<Dielectric>(1.5));
 
         //墙壁
         const auto w1 = make_shared<Parallelogram>(green, Point3(555.0, 0.0, 0.0), Vec3(0.0, 0.0, 555.0), Vec3(0.0, 555.0, 0.0));
@@ -307,13 +339,13 @@ namespace renderer {
         list.add(w6);
 
         //初始化列表不能直接转换为std::array，需要显式调用array的构造
-        const auto box1 = Parallelogram::constructBox(white, Point3(), Point3(165.0, 165.0, 165.0));
-        const auto box2 = Parallelogram::constructBox(metal, Point3(), Point3(165.0, 330.0, 165.0));
+        const auto box1 = make_shared<Box>(white, Point3(), Point3(165.0, 165.0, 165.0));
+        const auto box2 = make_shared<Box>(metal, Point3(), Point3(165.0, 330.0, 165.0));
         const auto trans1 = make_shared<Transform>(box1, array<double, 3>{0.0, -15.0, 0.0}, array<double, 3>{130, 0.0, 65.0}/*, array<double, 3>{1.5, 1.5, 1.5}*/);
         const auto trans2 = make_shared<Transform>(box2, array<double, 3>{0.0, 18.0, 0.0}, array<double, 3>{265.0, 0.0, 295.0}/*, array<double, 3>{1.5, 1.5, 1.5}*/);
 
-        const auto iso1 = make_shared<Isotropic>(Color3());
-        const auto iso2 = make_shared<Isotropic>(Color3(5.0, 5.0, 5.0));
+        const auto iso1 = resources.materials.add(make_shared<Isotropic>(Color3()));
+        const auto iso2 = resources.materials.add(make_shared<Isotropic>(Color3(5.0, 5.0, 5.0)));
         const auto volumeWhite = make_shared<ConstantMedium>(trans1, iso2, 0.01);
         const auto volumeBlack = make_shared<ConstantMedium>(trans2, iso1, 0.01);
         //list.add(trans1);
@@ -326,12 +358,14 @@ namespace renderer {
         pdfList.push_back(w6);
         pdfList.push_back(sphere);
 
-        auto bvhTree = make_shared<BVHTree>(list);
-        HittableCollection world;
-        world.add(bvhTree);
+        //展开嵌套的集合并烘焙变换，w6和sphere没有变换，在优化结果中仍是同一个对象，光源采样列表依然有效
+        SceneOptimizer::Statistics statistics;
+        const auto world = SceneOptimizer::optimize(list, &statistics);
+        SDL_Log("Scene Optimize: %u objects, %u baked, %u transforms collapsed", static_cast<Uint32>(statistics.objectCount),
+                static_cast<Uint32>(statistics.bakedCount), static_cast<Uint32>(statistics.collapsedCount));
 
         const Uint32 start = SDL_GetTicks();
-        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world, &pdfList);
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, *world, resources, &pdfList);
         const Uint32 end = SDL_GetTicks();
         SDL_Log("Render Time: %u ms", end - start);
         SDL_Log("Render Complete");
@@ -342,6 +376,214 @@ namespace renderer {
         releaseSDLResourcesImpl();
     }
 
+    void Example::test09() {
+        initSDLResources();
+
+        Camera cam(WINDOW_WIDTH, WINDOW_HEIGHT, Color3(0.7, 0.8, 1.0),
+                         Point3(-30.0, 25.0, -30.0), Point3(10.0, 0.0, 10.0),
+                         70, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
+        SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
+
+        const auto ground = resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.48, 0.83, 0.53)));
+        const auto white = resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.73, 0.73, 0.73)));
+
+        //由大量轴对齐长方体组成的建筑群
+        HittableCollection list;
+        list.add(make_shared<InfinitePlane>(ground, Point3(), Vec3(0.0, 1.0, 0.0)));
+        const int count = 20;
+        for (int i = 0; i < count; i++) {
+            for (int j = 0; j < count; j++) {
+                const double x = i * 2.0;
+                const double z = j * 2.0;
+                const double height = randomDouble(0.5, 6.0);
+                list.add(make_shared<Box>(white, Point3(x, 0.0, z), Point3(x + 1.2, height, z + 1.2)));
+            }
+        }
+
+        //使用相同的物体列表分别构造BVH和kd树，比较渲染时间
+        const shared_ptr<AbstractHittable> accelerators[2] = {make_shared<BVHTree>(list), make_shared<KDTree>(list)};
+        const char * names[2] = {"BVH", "KD Tree"};
+        for (int i = 0; i < 2; i++) {
+            HittableCollection world;
+            world.add(accelerators[i]);
+
+            const Uint32 start = SDL_GetTicks();
+            cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, world, resources);
+            const Uint32 end = SDL_GetTicks();
+            SDL_Log("%s Render Time: %u ms", names[i], end - start);
+            SDL_UpdateWindowSurface(window);
+        }
+
+        SDL_Log("Render Complete");
+        SDL_Delay(1000 * 1);
+        releaseSDLResourcesImpl();
+    }
+
+    void Example::test10() {
+        initSDLResources();
+
+        Camera cam(WINDOW_WIDTH, WINDOW_HEIGHT, Color3(0.7, 0.8, 1.0),
+                         Point3(0.0, 12.0, -40.0), Point3(0.0, 2.0, 0.0),
+                         50, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
+        SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
+
+        const auto ground = resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.48, 0.83, 0.53)));
+        const auto white = resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.73, 0.73, 0.73)));
+
+        //随机旋转的细长方体，轴对齐包围盒在旋转后会变得很松
+        struct BoxParameter {
+            array<double, 3> size;
+            array<double, 3> rotate;
+            array<double, 3> shift;
+        };
+        vector<BoxParameter> parameters;
+        for (int i = 0; i < 600; i++) {
+            parameters.push_back({{randomDouble(0.2, 0.5), randomDouble(3.0, 6.0), randomDouble(0.2, 0.5)},
+                                  {randomDouble(0.0, 90.0), randomDouble(0.0, 90.0), randomDouble(0.0, 90.0)},
+                                  {randomDouble(-15.0, 15.0), randomDouble(0.0, 8.0), randomDouble(-15.0, 15.0)}});
+        }
+
+        //分别只使用轴对齐包围盒和自动选择包围盒构造相同的场景，比较渲染时间
+        const BoundingBoxSelector::Policy policies[2] = {BoundingBoxSelector::Policy::AXIS_ALIGNED_ONLY, BoundingBoxSelector::Policy::TIGHTEST};
+        const char * names[2] = {"AABB Only", "AABB + OBB + k-DOP"};
+        for (int i = 0; i < 2; i++) {
+            BoundingBoxSelector::policy() = policies[i];
+
+            HittableCollection list;
+            list.add(make_shared<InfinitePlane>(ground, Point3(), Vec3(0.0, 1.0, 0.0)));
+            for (const auto & p : parameters) {
+                const auto box = make_shared<Box>(white, Point3(), Point3(p.size[0], p.size[1], p.size[2]));
+                list.add(make_shared<Transform>(box, p.rotate, p.shift));
+            }
+
+            const Uint32 start = SDL_GetTicks();
+            cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, list, resources);
+            const Uint32 end = SDL_GetTicks();
+            SDL_Log("%s Render Time: %u ms", names[i], end - start);
+            SDL_UpdateWindowSurface(window);
+        }
+        BoundingBoxSelector::policy() = BoundingBoxSelector::Policy::TIGHTEST;
+
+        SDL_Log("Render Complete");
+        SDL_Delay(1000 * 1);
+        releaseSDLResourcesImpl();
+    }
+
+    void Example::test11() {
+        initSDLResources();
+
+        Camera cam(WINDOW_WIDTH, WINDOW_HEIGHT, Color3(0.7, 0.8, 1.0),
+                         Point3(0.0, 5.0, -40.0), Point3(0.0, 5.0, 0.0),
+                         30, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
+        SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
+
+        //大量随机小球，相机只能看到其中一部分。小球和材质从场景分配器中连续分配，场景销毁时整体释放
+        SceneArena arena;
+        vector<shared_ptr<AbstractHittable>> objects;
+        objects.push_back(make_shared<InfinitePlane>(resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.48, 0.83, 0.53))), Point3(), Vec3(0.0, 1.0, 0.0)));
+        for (int i = 0; i < 3000; i++) {
+            const auto material = resources.materials.add(arena.make<Rough>(resources.textures, Color3(randomDouble(), randomDouble(), randomDouble())));
+            objects.push_back(arena.make<Sphere>(material, Point3(randomDouble(-20.0, 20.0), randomDouble(0.0, 10.0), randomDouble(-20.0, 20.0)), randomDouble(0.1, 0.4)));
+        }
+        const auto tree = make_shared<BVHTree>(objects);
+        HittableCollection list;
+        list.add(tree);
+
+        Uint32 start = SDL_GetTicks();
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, list, resources);
+        SDL_Log("Original BVH Render Time: %u ms", SDL_GetTicks() - start);
+        SDL_UpdateWindowSurface(window);
+
+        //预渲染记录光线，根据光线分布优化BVH树
+        start = SDL_GetTicks();
+        BVHOptimizer::optimize(*tree, cam.recordRays(tree, resources));
+        SDL_Log("Record And Optimize Time: %u ms", SDL_GetTicks() - start);
+
+        start = SDL_GetTicks();
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, list, resources);
+        SDL_Log("Optimized BVH Render Time: %u ms", SDL_GetTicks() - start);
+        SDL_UpdateWindowSurface(window);
+
+        SDL_Log("Render Complete");
+        SDL_Delay(1000 * 1);
+        releaseSDLResourcesImpl();
+    }
+
+    void Example::test12() {
+        initSDLResources();
+
+        Camera cam(WINDOW_WIDTH, WINDOW_HEIGHT, Color3(0.7, 0.8, 1.0),
+                         Point3(0.0, 4.0, 16.0), Point3(0.0, 0.0, -8.0),
+                         80, 0.0, Range(0.0, 1.0), 10, 0.5, 10);
+        SDL_Log("%s", cam.toString().c_str());
+        SceneResources resources;
+
+        HittableCollection list;
+        list.add(make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.7, 0.6, 0.5))), Point3(0.0, -1000.0, 0.0), 1000));
+
+        //随机物体场按TILE x TILE格分块，每块是一个程序化节点，只有光线进入的块才生成其中的球体
+        //生成函数在渲染期间调用，材质需要提前登记到场景资源中，生成函数使用由块的位置决定的种子，换出后重新生成的结果相同
+        const int range = 24, tile = 4;
+        vector<ResourceHandle> roughMats, metalMats;
+        for (int i = 0; i < 32; i++) {
+            roughMats.push_back(resources.materials.add(make_shared<Rough>(resources.textures, Color3::randomColor() * Color3::randomColor())));
+            metalMats.push_back(resources.materials.add(make_shared<Metal>(Color3::randomColor(0.5, 1.0), randomDouble(0.0, 0.5))));
+        }
+        const ResourceHandle glassMat = resources.materials.add(make_shared<Dielectric>(1.5));
+
+        //所有块共享2MB的缓存，每块展开后约8KB，超过容量时换出最久未被光线访问的块
+        const auto cache = make_shared<ProceduralNode::Cache>(2 * 1024 * 1024);
+        for (int x = -range; x < range; x += tile) {
+            for (int z = -range; z < range; z += tile) {
+                const auto generator = [=](SceneArena & arena, vector<shared_ptr<AbstractHittable>> & objects) {
+                    mt19937 engine(static_cast<Uint32>((x + range) * 4 * range + (z + range)));
+                    uniform_real_distribution<double> distribution(0.0, 1.0);
+                    for (int a = x; a < x + tile; a++) {
+                        for (int b = z; b < z + tile; b++) {
+                            const double chooseMat = distribution(engine);
+                            const double offsetX = distribution(engine), offsetZ = distribution(engine), offsetY = distribution(engine);
+                            const auto index = static_cast<size_t>(distribution(engine) * 32);
+                            Point3 center(a + 0.9 * offsetX, 0.2, b + 0.9 * offsetZ);
+
+                            if (Point3::constructVector(Point3(4.0, 0.2, 0.0), center).length() > 0.9) {
+                                if (chooseMat < 0.8) {
+                                    auto center2 = center + Vec3(0.0, 0.5 * offsetY, 0.0);
+                                    objects.push_back(arena.make<Sphere>(roughMats[index], center, center2, 0.2));
+                                } else if (chooseMat < 0.95) {
+                                    objects.push_back(arena.make<Sphere>(metalMats[index], center, 0.2));
+                                } else {
+                                    objects.push_back(arena.make<Sphere>(glassMat, center, 0.2));
+                                }
+                            }
+                        }
+                    }
+                };
+                //球心在格子内偏移至多0.9，半径0.2，运动的球最多上升0.5
+                list.add(make_shared<ProceduralNode>(Point3(x - 0.2, 0.0, z - 0.2), Point3(x + tile + 0.2, 0.9, z + tile + 0.2), generator, cache));
+            }
+        }
+
+        list.add(make_shared<Sphere>(resources.materials.add(make_shared<Dielectric>(1.5)), Point3(0.0, 1.0, 0.0), 1.0));
+        list.add(make_shared<Sphere>(resources.materials.add(make_shared<Rough>(resources.textures, Color3(0.4, 0.2, 0.1))), Point3(-4.0, 1.0, 0.0), 1.0));
+        list.add(make_shared<Sphere>(resources.materials.add(make_shared<Metal>(Color3(0.7, 0.6, 0.5), 0.0)), Point3(4.0, 1.0, 0.0), 1.0));
+
+        const Uint32 start = SDL_GetTicks();
+        cam.render(window, static_cast<Uint32 *>(surface->pixels), surface->format, list, resources);
+        SDL_Log("Render Time: %u ms", SDL_GetTicks() - start);
+        const auto statistics = cache->getStatistics();
+        SDL_Log("Procedural Tiles: %u, Expanded: %u, Evicted: %u, Peak Memory: %u KB",
+                static_cast<Uint32>(cache->chunkCount()), static_cast<Uint32>(statistics.loadCount),
+                static_cast<Uint32>(statistics.evictionCount), static_cast<Uint32>(statistics.peakBytes / 1024));
+
+        SDL_Log("Render Complete");
+        SDL_UpdateWindowSurface(window);
+        SDL_Delay(1000 * 1);
+        releaseSDLResourcesImpl();
+    }
+
     void Example::testAll() {
         test01();
         test02();
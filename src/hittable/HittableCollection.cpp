@@ -0,0 +1,49 @@
+#include <hittable/HittableCollection.hpp>
+#include <box/BVHTree.hpp>
+
+namespace renderer {
+    void HittableCollection::buildAccelerator() const {
+        std::lock_guard<std::mutex> lock(acceleratorMutex);
+        //其他线程可能已经完成构造
+        if (isAccelerated.load(std::memory_order_relaxed)) {
+            return;
+        }
+        accelerator = std::make_shared<BVHTree>(list);
+        isAccelerated.store(true, std::memory_order_release);
+    }
+
+    bool HittableCollection::isUnbounded(const std::shared_ptr<AbstractHittable> & obj) {
+        return obj->getBounds().isUnbounded();
+    }
+
+    void HittableCollection::separateUnbounded(const std::vector<std::shared_ptr<AbstractHittable>> & objects,
+                                               std::vector<std::shared_ptr<AbstractHittable>> & bounded,
+                                               std::vector<std::shared_ptr<AbstractHittable>> & unbounded) {
+        //计算每个有限物体包围盒的最长边
+        std::vector<Real> extents(objects.size(), INFINITY);
+        std::vector<Real> finiteExtents;
+        finiteExtents.reserve(objects.size());
+        for (size_t i = 0; i < objects.size(); i++) {
+            if (isUnbounded(objects[i])) continue;
+            const Bounds & bounds = objects[i]->getBounds();
+            extents[i] = std::max({bounds[0].length(), bounds[1].length(), bounds[2].length()});
+            finiteExtents.push_back(extents[i]);
+        }
+
+        //使用中位数作为典型物体尺寸，不受少数特别大的物体影响
+        Real limit = INFINITY;
+        if (!finiteExtents.empty()) {
+            const size_t middle = (finiteExtents.size() - 1) / 2;
+            std::nth_element(finiteExtents.begin(), finiteExtents.begin() + (long)middle, finiteExtents.end());
+            limit = finiteExtents[middle] * LARGE_PRIMITIVE_RATIO;
+        }
+
+        for (size_t i = 0; i < objects.size(); i++) {
+            if (std::isinf(extents[i]) || extents[i] > limit) {
+                unbounded.push_back(objects[i]);
+            } else {
+                bounded.push_back(objects[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,309 @@
+#include <hittable/StreamedMesh.hpp>
+#include <util/MeshFile.hpp>
+#include <fstream>
+
+namespace renderer {
+    constexpr char StreamedMesh::MAGIC[4];
+    constexpr Uint32 StreamedMesh::VERSION;
+
+    static_assert(sizeof(StreamedMesh::Header) == 80 && sizeof(StreamedMesh::ChunkEntry) == 72, "Streamed mesh header must not contain padding");
+
+    namespace {
+        //递归地在三角形中心的最长轴上按中位数划分，直到每组不超过limit个三角形
+        void partition(const std::vector<Real> & centers, std::vector<Uint32> & triangles, size_t start, size_t end, size_t limit,
+                       std::vector<std::pair<size_t, size_t>> & groups) {
+            if (end - start <= limit) {
+                groups.emplace_back(start, end);
+                return;
+            }
+            Bounds bounds;
+            for (size_t i = start; i < end; i++) {
+                const Real * c = &centers[3 * triangles[i]];
+                bounds.merge(Point3(c[0], c[1], c[2]));
+            }
+            const int axis = bounds.longestAxis();
+            const size_t middle = start + (end - start) / 2;
+            std::nth_element(triangles.begin() + (long)start, triangles.begin() + (long)middle, triangles.begin() + (long)end,
+                             [&](Uint32 t1, Uint32 t2) { return centers[3 * t1 + axis] < centers[3 * t2 + axis]; });
+            partition(centers, triangles, start, middle, limit, groups);
+            partition(centers, triangles, middle, end, limit, groups);
+        }
+    }
+
+    // ====== Writer ======
+
+    StreamedMesh::Writer::Writer(const std::string & path) : file(fopen(path.c_str(), "wb")), path(path), position(0), header() {
+        if (file == null) {
+            throw std::runtime_error("Failed to create file: " + path);
+        }
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        for (size_t i = 0; i < 6; i += 2) {
+            header.bounds[i] = std::numeric_limits<double>::max();
+            header.bounds[i + 1] = std::numeric_limits<double>::lowest();
+        }
+        //文件头在close时重写
+        write(&header, sizeof(Header));
+    }
+
+    StreamedMesh::Writer::~Writer() {
+        if (file != null) fclose(file);
+    }
+
+    void StreamedMesh::Writer::write(const void * data, size_t size) {
+        if (size > 0 && fwrite(data, 1, size, file) != size) {
+            throw std::runtime_error("Failed to write file: " + path);
+        }
+        position += size;
+    }
+
+    void StreamedMesh::Writer::addChunk(MeshBuffers buffers) {
+        if (file == null) {
+            throw std::runtime_error("Streamed mesh writer is closed: " + path);
+        }
+        const std::vector<unsigned char> image = MeshFile::encode(std::move(buffers));
+        MeshFile::Header chunkHeader {};
+        memcpy(&chunkHeader, image.data(), sizeof(MeshFile::Header));
+
+        //块的起点对齐，块内各数组相对块起点的偏移量保持对齐
+        static const char ZEROS[MeshFile::SECTION_ALIGNMENT] = {};
+        write(ZEROS, MeshFile::alignOffset(position) - position);
+
+        ChunkEntry entry {};
+        entry.offset = position;
+        entry.size = image.size();
+        entry.triangleCount = chunkHeader.triangleCount;
+        for (size_t i = 0; i < 6; i += 2) {
+            entry.bounds[i] = chunkHeader.bounds[i];
+            entry.bounds[i + 1] = chunkHeader.bounds[i + 1];
+            header.bounds[i] = std::min(header.bounds[i], entry.bounds[i]);
+            header.bounds[i + 1] = std::max(header.bounds[i + 1], entry.bounds[i + 1]);
+        }
+        write(image.data(), image.size());
+        table.push_back(entry);
+        header.chunkCount++;
+        header.triangleCount += entry.triangleCount;
+    }
+
+    void StreamedMesh::Writer::close() {
+        if (file == null) {
+            return;
+        }
+        if (table.empty()) {
+            throw std::runtime_error("Streamed mesh has no chunk: " + path);
+        }
+        header.tableOffset = position;
+        write(table.data(), sizeof(ChunkEntry) * table.size());
+        if (fseek(file, 0, SEEK_SET) != 0) {
+            throw std::runtime_error("Failed to write file: " + path);
+        }
+        write(&header, sizeof(Header));
+        const int result = fclose(file);
+        file = null;
+        if (result != 0) {
+            throw std::runtime_error("Failed to write file: " + path);
+        }
+    }
+
+    void StreamedMesh::write(const std::string & path, const MeshBuffers & buffers, size_t trianglesPerChunk) {
+        if (buffers.vertices.size() % 3 != 0 || buffers.indices.size() % 3 != 0 || buffers.indices.empty()) {
+            throw std::runtime_error("Invalid mesh buffers!");
+        }
+        const size_t vertexCount = buffers.vertices.size() / 3;
+        const size_t triangleCount = buffers.indices.size() / 3;
+        std::vector<Real> centers(3 * triangleCount);
+        std::vector<Uint32> triangles(triangleCount);
+        for (size_t i = 0; i < triangleCount; i++) {
+            for (size_t axis = 0; axis < 3; axis++) {
+                Real sum = 0.0;
+                for (size_t j = 0; j < 3; j++) {
+                    const Uint32 index = buffers.indices[3 * i + j];
+                    if (index >= vertexCount) {
+                        throw std::runtime_error("Mesh vertex index out of range!");
+                    }
+                    sum += buffers.vertices[3 * index + axis];
+                }
+                centers[3 * i + axis] = sum / 3.0;
+            }
+            triangles[i] = static_cast<Uint32>(i);
+        }
+        std::vector<std::pair<size_t, size_t>> groups;
+        partition(centers, triangles, 0, triangleCount, std::max<size_t>(1, trianglesPerChunk), groups);
+
+        //每个块只包含自己引用的顶点，remap记录原顶点在当前块中的下标，stamp标记remap属于哪个块
+        Writer writer(path);
+        std::vector<Uint32> remap(vertexCount), stamp(vertexCount, 0);
+        Uint32 group = 0;
+        for (const auto & range : groups) {
+            group++;
+            MeshBuffers chunk;
+            for (size_t i = range.first; i < range.second; i++) {
+                for (size_t j = 0; j < 3; j++) {
+                    const Uint32 index = buffers.indices[3 * triangles[i] + j];
+                    if (stamp[index] != group) {
+                        stamp[index] = group;
+                        remap[index] = static_cast<Uint32>(chunk.vertices.size() / 3);
+                        chunk.vertices.insert(chunk.vertices.end(), &buffers.vertices[3 * index], &buffers.vertices[3 * index] + 3);
+                        if (!buffers.normals.empty()) chunk.normals.insert(chunk.normals.end(), &buffers.normals[3 * index], &buffers.normals[3 * index] + 3);
+                        if (!buffers.uvs.empty()) chunk.uvs.insert(chunk.uvs.end(), &buffers.uvs[2 * index], &buffers.uvs[2 * index] + 2);
+                    }
+                    chunk.indices.push_back(remap[index]);
+                }
+            }
+            writer.addChunk(std::move(chunk));
+        }
+        writer.close();
+    }
+
+    // ====== Chunk ======
+
+    StreamedMesh::Chunk::Chunk(GeometryCache & cache, size_t index, const ChunkEntry & entry) :
+        cache(cache), index(index), cost(1.5 + std::log2(static_cast<double>(std::max<Uint64>(1, entry.triangleCount))))
+    {
+        setBounds(AxisAlignedBoundingBox(
+                Point3(entry.bounds[0], entry.bounds[2], entry.bounds[4]), Point3(entry.bounds[1], entry.bounds[3], entry.bounds[5])));
+    }
+
+    bool StreamedMesh::Chunk::intersect(const Ray & ray, const Range & range, HitRecord & record) const {
+        //批量求交时不等待载入，记录光线后跳过该块
+        Deferral * deferral = currentDeferral();
+        if (deferral != null) {
+            const auto mesh = cache.find(index);
+            if (!mesh) {
+                deferral->rays[index].push_back(deferral->ray);
+                return false;
+            }
+            return intersect(*mesh, ray, range, record);
+        }
+        return intersect(*cache.acquire(index), ray, range, record);
+    }
+
+    std::string StreamedMesh::Chunk::toString() const {
+        char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
+        snprintf(buffer, TOSTRING_BUFFER_SIZE, "StreamedMesh::Chunk: Index = %zu", index);
+        return {buffer};
+    }
+
+    // ====== StreamedMesh ======
+
+    std::shared_ptr<TriangleMesh> StreamedMesh::loadChunk(const std::string & path, const ChunkEntry & entry, ResourceHandle material) {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+        //使用double数组作为缓冲区，保证数据按标量对齐
+        auto storage = std::make_shared<std::vector<double>>((entry.size + sizeof(double) - 1) / sizeof(double));
+        auto * data = reinterpret_cast<unsigned char *>(storage->data());
+        stream.seekg(static_cast<std::streamoff>(entry.offset));
+        stream.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(entry.size));
+        if (!stream) {
+            throw std::runtime_error("Failed to read file: " + path);
+        }
+        return MeshFile::load(std::move(storage), data, entry.size, material);
+    }
+
+    StreamedMesh::StreamedMesh(ResourceHandle material, const std::string & path, size_t cacheCapacity) :
+        path(path), material(material), totalTriangleCount(0)
+    {
+        //只读取文件头和块表
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+        stream.seekg(0, std::ios::end);
+        const auto fileSize = static_cast<Uint64>(stream.tellg());
+        stream.seekg(0);
+        Header header {};
+        if (fileSize < sizeof(Header) || !stream.read(reinterpret_cast<char *>(&header), sizeof(Header)) ||
+            memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Invalid streamed mesh file: " + path);
+        }
+        if (header.version != VERSION) {
+            throw std::runtime_error("Unsupported streamed mesh file version: " + path);
+        }
+        if (header.chunkCount == 0 || header.tableOffset < sizeof(Header) || header.tableOffset > fileSize ||
+            header.chunkCount > (fileSize - header.tableOffset) / sizeof(ChunkEntry)) {
+            throw std::runtime_error("Invalid streamed mesh file: " + path);
+        }
+        std::vector<ChunkEntry> table(header.chunkCount);
+        stream.seekg(static_cast<std::streamoff>(header.tableOffset));
+        if (!stream.read(reinterpret_cast<char *>(table.data()), static_cast<std::streamsize>(sizeof(ChunkEntry) * table.size()))) {
+            throw std::runtime_error("Invalid streamed mesh file: " + path);
+        }
+        for (const auto & entry : table) {
+            if (entry.offset % MeshFile::SECTION_ALIGNMENT != 0 || entry.offset < sizeof(Header) || entry.offset > header.tableOffset ||
+                entry.size > header.tableOffset - entry.offset) {
+                throw std::runtime_error("Invalid streamed mesh file: " + path);
+            }
+        }
+        totalTriangleCount = header.triangleCount;
+
+        cache = std::make_shared<GeometryCache>(cacheCapacity, table.size(), [path, table, material](size_t chunk) {
+            return loadChunk(path, table[chunk], material);
+        });
+        std::vector<std::shared_ptr<AbstractHittable>> proxies;
+        for (size_t i = 0; i < table.size(); i++) {
+            chunks.push_back(std::make_shared<Chunk>(*cache, i, table[i]));
+            proxies.push_back(chunks.back());
+        }
+        tree = std::make_shared<BVHTree>(proxies);
+        setBounds(tree->getBounds());
+    }
+
+    void StreamedMesh::intersect(const std::vector<Ray> & rays, const Range & range, std::vector<HitRecord> & records, std::vector<bool> & isHit) const {
+        records.assign(rays.size(), HitRecord());
+        isHit.assign(rays.size(), false);
+
+        //第一遍只测试已驻留的块，遇到未驻留的块的光线按块记录
+        Deferral deferral;
+        deferral.rays.resize(chunks.size());
+        currentDeferral() = &deferral;
+        try {
+            for (size_t i = 0; i < rays.size(); i++) {
+                deferral.ray = static_cast<Uint32>(i);
+                isHit[i] = tree->intersect(rays[i], range, records[i]);
+            }
+        } catch (...) {
+            currentDeferral() = null;
+            throw;
+        }
+        currentDeferral() = null;
+
+        //推迟光线多的块先载入，每个块载入一次，测试其所有推迟光线，范围截止到光线当前的最近交点
+        std::vector<size_t> order;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            if (!deferral.rays[i].empty()) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&](size_t c1, size_t c2) { return deferral.rays[c1].size() > deferral.rays[c2].size(); });
+        for (const size_t chunk : order) {
+            const auto mesh = cache->acquire(chunk);
+            for (const Uint32 ray : deferral.rays[chunk]) {
+                const Range rayRange(range.getMin(), isHit[ray] ? records[ray].t : range.getMax());
+                if (chunks[chunk]->intersect(*mesh, rays[ray], rayRange, records[ray])) {
+                    isHit[ray] = true;
+                }
+            }
+        }
+
+        //按击中的块分组完成求交记录，同样每个块只获取一次，逐条finalize会让已换出的块被反复载入
+        std::vector<std::vector<Uint32>> hits(chunks.size());
+        for (size_t i = 0; i < rays.size(); i++) {
+            if (isHit[i]) hits[static_cast<const Chunk *>(records[i].object)->getIndex()].push_back(static_cast<Uint32>(i));
+        }
+        for (size_t chunk = 0; chunk < chunks.size(); chunk++) {
+            if (hits[chunk].empty()) continue;
+            const auto mesh = cache->acquire(chunk);
+            for (const Uint32 ray : hits[chunk]) {
+                mesh->finalize(rays[ray], records[ray]);
+            }
+        }
+    }
+
+    std::string StreamedMesh::toString() const {
+        const auto statistics = cache->getStatistics();
+        char buffer[TOSTRING_BUFFER_SIZE] = { 0 };
+        snprintf(buffer, TOSTRING_BUFFER_SIZE, "StreamedMesh: Path = %s, Chunks = %zu, Triangles = %zu, Resident = %zu / %zu bytes",
+                 path.c_str(), chunks.size(), totalTriangleCount, statistics.residentBytes, cache->getCapacity());
+        return {buffer};
+    }
+}
@@ -0,0 +1,84 @@
+#include <util/SIMDKernels.hpp>
+#include <SDL2/SDL_cpuinfo.h>
+#include <SDL2/SDL_log.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace renderer {
+    namespace {
+        //标量实现：宽度为1的向量包，编译器可能自动向量化，但只使用基础指令集
+        template <typename T>
+        struct ScalarPack {
+            using Scalar = T;
+            using Vector = T;
+            using Mask = bool;
+            static constexpr size_t WIDTH = 1;
+
+            static Vector load(const T * p) { return *p; }
+            static void store(T * p, Vector a) { *p = a; }
+            static void storeInt(int32_t * p, Vector a) { *p = static_cast<int32_t>(a); }
+            static Vector broadcast(T a) { return a; }
+
+            static Vector add(Vector a, Vector b) { return a + b; }
+            static Vector sub(Vector a, Vector b) { return a - b; }
+            static Vector mul(Vector a, Vector b) { return a * b; }
+            static Vector div(Vector a, Vector b) { return a / b; }
+            //和SSE的min/max指令相同，存在NaN时返回第二个参数
+            static Vector min(Vector a, Vector b) { return a < b ? a : b; }
+            static Vector max(Vector a, Vector b) { return a > b ? a : b; }
+            static Vector sqrt(Vector a) { return std::sqrt(a); }
+            static Vector floor(Vector a) { return std::floor(a); }
+
+            static Mask less(Vector a, Vector b) { return a < b; }
+            static Mask lessEqual(Vector a, Vector b) { return a <= b; }
+            static Mask both(Mask a, Mask b) { return a && b; }
+            static unsigned bits(Mask m) { return m ? 1u : 0u; }
+            static Vector select(Mask m, Vector a, Vector b) { return m ? a : b; }
+        };
+
+        const KernelTable SCALAR_KERNELS = makeKernelTable<ScalarPack<Real>, ScalarPack<float>>(InstructionSet::SCALAR, "Scalar");
+
+        //环境变量RENDERER_ISA限制的最高指令集，没有设置时不限制
+        InstructionSet instructionSetLimit() {
+            const char * value = std::getenv("RENDERER_ISA");
+            if (value == null) return InstructionSet::AVX512;
+            if (std::strcmp(value, "scalar") == 0) return InstructionSet::SCALAR;
+            if (std::strcmp(value, "sse42") == 0) return InstructionSet::SSE42;
+            if (std::strcmp(value, "avx2") == 0) return InstructionSet::AVX2;
+            return InstructionSet::AVX512;
+        }
+
+        const KernelTable * selectKernels() {
+            const InstructionSet limit = instructionSetLimit();
+            const InstructionSet supported = KernelDispatch::detect();
+            const InstructionSet detected = supported < limit ? supported : limit;
+
+            //从支持的最高指令集开始向下查找，编译器不支持某个指令集时对应的函数表为null
+            const KernelTable * table = null;
+            if (detected >= InstructionSet::AVX512) table = avx512Kernels();
+            if (table == null && detected >= InstructionSet::AVX2) table = avx2Kernels();
+            if (table == null && detected >= InstructionSet::SSE42) table = sse42Kernels();
+            if (table == null) table = scalarKernels();
+            SDL_Log("Kernel Instruction Set: %s", table->name);
+            return table;
+        }
+    }
+
+    const KernelTable * scalarKernels() {
+        return &SCALAR_KERNELS;
+    }
+
+    const KernelTable & KernelDispatch::kernels() {
+        static const KernelTable * table = selectKernels();
+        return *table;
+    }
+
+    InstructionSet KernelDispatch::detect() {
+        //SDL同时检查CPU和操作系统是否保存了对应的寄存器状态
+        if (SDL_HasAVX512F()) return InstructionSet::AVX512;
+        if (SDL_HasAVX2()) return InstructionSet::AVX2;
+        if (SDL_HasSSE42()) return InstructionSet::SSE42;
+        return InstructionSet::SCALAR;
+    }
+}
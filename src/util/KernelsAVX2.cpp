@@ -0,0 +1,81 @@
+#include <util/SIMDKernels.hpp>
+
+/*
+ * AVX2版本的计算核，此文件使用-mavx2编译
+ * 256位寄存器，一次处理8个float或4个double
+ * 不使用FMA：SDL没有提供FMA的检测函数，乘加分开计算也使结果和其他版本保持一致
+ */
+#ifdef __AVX2__
+#include <immintrin.h>
+
+namespace renderer {
+    namespace {
+        struct AVXFloat {
+            using Scalar = float;
+            using Vector = __m256;
+            using Mask = __m256;
+            static constexpr size_t WIDTH = 8;
+
+            static Vector load(const float * p) { return _mm256_loadu_ps(p); }
+            static void store(float * p, Vector a) { _mm256_storeu_ps(p, a); }
+            static void storeInt(int32_t * p, Vector a) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm256_cvttps_epi32(a)); }
+            static Vector broadcast(float a) { return _mm256_set1_ps(a); }
+
+            static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+            static Vector div(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+            static Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+            static Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+            static Vector sqrt(Vector a) { return _mm256_sqrt_ps(a); }
+            static Vector floor(Vector a) { return _mm256_floor_ps(a); }
+
+            static Mask less(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+            static Mask lessEqual(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+            static Mask both(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+            static unsigned bits(Mask m) { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+            static Vector select(Mask m, Vector a, Vector b) { return _mm256_blendv_ps(b, a, m); }
+        };
+
+        struct AVXDouble {
+            using Scalar = double;
+            using Vector = __m256d;
+            using Mask = __m256d;
+            static constexpr size_t WIDTH = 4;
+
+            static Vector load(const double * p) { return _mm256_loadu_pd(p); }
+            static void store(double * p, Vector a) { _mm256_storeu_pd(p, a); }
+            static Vector broadcast(double a) { return _mm256_set1_pd(a); }
+
+            static Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+            static Vector div(Vector a, Vector b) { return _mm256_div_pd(a, b); }
+            static Vector min(Vector a, Vector b) { return _mm256_min_pd(a, b); }
+            static Vector max(Vector a, Vector b) { return _mm256_max_pd(a, b); }
+            static Vector sqrt(Vector a) { return _mm256_sqrt_pd(a); }
+            static Vector floor(Vector a) { return _mm256_floor_pd(a); }
+
+            static Mask less(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+            static Mask lessEqual(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+            static Mask both(Mask a, Mask b) { return _mm256_and_pd(a, b); }
+            static unsigned bits(Mask m) { return static_cast<unsigned>(_mm256_movemask_pd(m)); }
+            static Vector select(Mask m, Vector a, Vector b) { return _mm256_blendv_pd(b, a, m); }
+        };
+
+        using AVXReal = std::conditional<std::is_same<Real, float>::value, AVXFloat, AVXDouble>::type;
+
+        const KernelTable AVX2_KERNELS = makeKernelTable<AVXReal, AVXFloat>(InstructionSet::AVX2, "AVX2");
+    }
+
+    const KernelTable * avx2Kernels() {
+        return &AVX2_KERNELS;
+    }
+}
+#else
+namespace renderer {
+    const KernelTable * avx2Kernels() {
+        return null;
+    }
+}
+#endif
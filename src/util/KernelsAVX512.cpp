@@ -0,0 +1,80 @@
+#include <util/SIMDKernels.hpp>
+
+/*
+ * AVX-512版本的计算核，此文件使用-mavx512f编译，只使用AVX-512F中的指令
+ * 512位寄存器，一次处理16个float或8个double，比较结果为掩码寄存器
+ */
+#ifdef __AVX512F__
+#include <immintrin.h>
+
+namespace renderer {
+    namespace {
+        struct AVX512Float {
+            using Scalar = float;
+            using Vector = __m512;
+            using Mask = __mmask16;
+            static constexpr size_t WIDTH = 16;
+
+            static Vector load(const float * p) { return _mm512_loadu_ps(p); }
+            static void store(float * p, Vector a) { _mm512_storeu_ps(p, a); }
+            static void storeInt(int32_t * p, Vector a) { _mm512_storeu_si512(p, _mm512_cvttps_epi32(a)); }
+            static Vector broadcast(float a) { return _mm512_set1_ps(a); }
+
+            static Vector add(Vector a, Vector b) { return _mm512_add_ps(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm512_sub_ps(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm512_mul_ps(a, b); }
+            static Vector div(Vector a, Vector b) { return _mm512_div_ps(a, b); }
+            static Vector min(Vector a, Vector b) { return _mm512_min_ps(a, b); }
+            static Vector max(Vector a, Vector b) { return _mm512_max_ps(a, b); }
+            static Vector sqrt(Vector a) { return _mm512_sqrt_ps(a); }
+            static Vector floor(Vector a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+            static Mask less(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+            static Mask lessEqual(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+            static Mask both(Mask a, Mask b) { return static_cast<Mask>(a & b); }
+            static unsigned bits(Mask m) { return static_cast<unsigned>(m); }
+            static Vector select(Mask m, Vector a, Vector b) { return _mm512_mask_blend_ps(m, b, a); }
+        };
+
+        struct AVX512Double {
+            using Scalar = double;
+            using Vector = __m512d;
+            using Mask = __mmask8;
+            static constexpr size_t WIDTH = 8;
+
+            static Vector load(const double * p) { return _mm512_loadu_pd(p); }
+            static void store(double * p, Vector a) { _mm512_storeu_pd(p, a); }
+            static Vector broadcast(double a) { return _mm512_set1_pd(a); }
+
+            static Vector add(Vector a, Vector b) { return _mm512_add_pd(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm512_sub_pd(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm512_mul_pd(a, b); }
+            static Vector div(Vector a, Vector b) { return _mm512_div_pd(a, b); }
+            static Vector min(Vector a, Vector b) { return _mm512_min_pd(a, b); }
+            static Vector max(Vector a, Vector b) { return _mm512_max_pd(a, b); }
+            static Vector sqrt(Vector a) { return _mm512_sqrt_pd(a); }
+            static Vector floor(Vector a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+            static Mask less(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+            static Mask lessEqual(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+            static Mask both(Mask a, Mask b) { return static_cast<Mask>(a & b); }
+            static unsigned bits(Mask m) { return static_cast<unsigned>(m); }
+            static Vector select(Mask m, Vector a, Vector b) { return _mm512_mask_blend_pd(m, b, a); }
+        };
+
+        using AVX512Real = std::conditional<std::is_same<Real, float>::value, AVX512Float, AVX512Double>::type;
+
+        const KernelTable AVX512_KERNELS = makeKernelTable<AVX512Real, AVX512Float>(InstructionSet::AVX512, "AVX-512");
+    }
+
+    const KernelTable * avx512Kernels() {
+        return &AVX512_KERNELS;
+    }
+}
+#else
+namespace renderer {
+    const KernelTable * avx512Kernels() {
+        return null;
+    }
+}
+#endif
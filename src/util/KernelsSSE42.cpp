@@ -0,0 +1,80 @@
+#include <util/SIMDKernels.hpp>
+
+/*
+ * SSE4.2版本的计算核，此文件使用-msse4.2编译
+ * 128位寄存器，一次处理4个float或2个double
+ */
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(_M_X64))
+#include <immintrin.h>
+
+namespace renderer {
+    namespace {
+        struct SSEFloat {
+            using Scalar = float;
+            using Vector = __m128;
+            using Mask = __m128;
+            static constexpr size_t WIDTH = 4;
+
+            static Vector load(const float * p) { return _mm_loadu_ps(p); }
+            static void store(float * p, Vector a) { _mm_storeu_ps(p, a); }
+            static void storeInt(int32_t * p, Vector a) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_cvttps_epi32(a)); }
+            static Vector broadcast(float a) { return _mm_set1_ps(a); }
+
+            static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+            static Vector div(Vector a, Vector b) { return _mm_div_ps(a, b); }
+            static Vector min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+            static Vector max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+            static Vector sqrt(Vector a) { return _mm_sqrt_ps(a); }
+            static Vector floor(Vector a) { return _mm_floor_ps(a); }
+
+            static Mask less(Vector a, Vector b) { return _mm_cmplt_ps(a, b); }
+            static Mask lessEqual(Vector a, Vector b) { return _mm_cmple_ps(a, b); }
+            static Mask both(Mask a, Mask b) { return _mm_and_ps(a, b); }
+            static unsigned bits(Mask m) { return static_cast<unsigned>(_mm_movemask_ps(m)); }
+            static Vector select(Mask m, Vector a, Vector b) { return _mm_blendv_ps(b, a, m); }
+        };
+
+        struct SSEDouble {
+            using Scalar = double;
+            using Vector = __m128d;
+            using Mask = __m128d;
+            static constexpr size_t WIDTH = 2;
+
+            static Vector load(const double * p) { return _mm_loadu_pd(p); }
+            static void store(double * p, Vector a) { _mm_storeu_pd(p, a); }
+            static Vector broadcast(double a) { return _mm_set1_pd(a); }
+
+            static Vector add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+            static Vector sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+            static Vector mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+            static Vector div(Vector a, Vector b) { return _mm_div_pd(a, b); }
+            static Vector min(Vector a, Vector b) { return _mm_min_pd(a, b); }
+            static Vector max(Vector a, Vector b) { return _mm_max_pd(a, b); }
+            static Vector sqrt(Vector a) { return _mm_sqrt_pd(a); }
+            static Vector floor(Vector a) { return _mm_floor_pd(a); }
+
+            static Mask less(Vector a, Vector b) { return _mm_cmplt_pd(a, b); }
+            static Mask lessEqual(Vector a, Vector b) { return _mm_cmple_pd(a, b); }
+            static Mask both(Mask a, Mask b) { return _mm_and_pd(a, b); }
+            static unsigned bits(Mask m) { return static_cast<unsigned>(_mm_movemask_pd(m)); }
+            static Vector select(Mask m, Vector a, Vector b) { return _mm_blendv_pd(b, a, m); }
+        };
+
+        using SSEReal = std::conditional<std::is_same<Real, float>::value, SSEFloat, SSEDouble>::type;
+
+        const KernelTable SSE42_KERNELS = makeKernelTable<SSEReal, SSEFloat>(InstructionSet::SSE42, "SSE4.2");
+    }
+
+    const KernelTable * sse42Kernels() {
+        return &SSE42_KERNELS;
+    }
+}
+#else
+namespace renderer {
+    const KernelTable * sse42Kernels() {
+        return null;
+    }
+}
+#endif
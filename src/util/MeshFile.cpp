@@ -0,0 +1,249 @@
+#include <util/MeshFile.hpp>
+#include <util/MeshLoader.hpp>
+#include <util/MeshOptimizer.hpp>
+#include <util/MappedFile.hpp>
+
+namespace renderer {
+    constexpr char MeshFile::MAGIC[4];
+    constexpr Uint32 MeshFile::VERSION;
+    constexpr size_t MeshFile::SECTION_ALIGNMENT;
+    constexpr Uint32 MeshFile::MAX_LEAF_SIZE;
+
+    static_assert(sizeof(MeshFile::Header) == 152, "Mesh file header must not contain padding");
+    static_assert(std::is_trivially_copyable<TriangleMesh::Node>::value && std::is_standard_layout<TriangleMesh::Node>::value,
+                  "Mesh node must be a plain value type to be mapped from file");
+
+    namespace {
+        //写入失败时关闭文件并抛出异常
+        class FileWriter {
+        private:
+            FILE * file;
+            std::string path;
+            size_t position;
+
+        public:
+            explicit FileWriter(const std::string & path) : file(fopen(path.c_str(), "wb")), path(path), position(0) {
+                if (file == null) {
+                    throw std::runtime_error("Failed to create file: " + path);
+                }
+            }
+
+            ~FileWriter() {
+                if (file != null) fclose(file);
+            }
+
+            void write(const void * data, size_t size) {
+                if (size > 0 && fwrite(data, 1, size, file) != size) {
+                    throw std::runtime_error("Failed to write file: " + path);
+                }
+                position += size;
+            }
+
+            //用0填充到offset
+            void padTo(size_t offset) {
+                static const char ZEROS[MeshFile::SECTION_ALIGNMENT] = {};
+                while (position < offset) {
+                    write(ZEROS, std::min(offset - position, sizeof(ZEROS)));
+                }
+            }
+
+            void close() {
+                const int result = fclose(file);
+                file = null;
+                if (result != 0) {
+                    throw std::runtime_error("Failed to write file: " + path);
+                }
+            }
+        };
+
+        //将网格文件写入内存，用于把网格嵌入其他文件
+        class BufferWriter {
+        private:
+            std::vector<unsigned char> & buffer;
+
+        public:
+            explicit BufferWriter(std::vector<unsigned char> & buffer) : buffer(buffer) {}
+
+            void write(const void * data, size_t size) {
+                const auto * bytes = static_cast<const unsigned char *>(data);
+                buffer.insert(buffer.end(), bytes, bytes + size);
+            }
+
+            void padTo(size_t offset) {
+                if (buffer.size() < offset) buffer.resize(offset, 0);
+            }
+        };
+
+        //构造BVH并按文件布局写入网格，buffers中的索引会被重排和补齐
+        template <typename Writer>
+        void writeImage(Writer & writer, MeshBuffers & buffers) {
+            if (!MeshFile::isLittleEndianHost()) {
+                throw std::runtime_error("Mesh file requires a little-endian host!");
+            }
+            std::vector<Real> packets;
+            const std::vector<TriangleMesh::Node> nodes = TriangleMesh::buildBVH(buffers, packets);
+
+            MeshFile::Header header {};
+            memcpy(header.magic, MeshFile::MAGIC, sizeof(MeshFile::MAGIC));
+            header.version = MeshFile::VERSION;
+            header.scalarSize = sizeof(Real);
+            header.nodeSize = sizeof(TriangleMesh::Node);
+            header.leafSize = TriangleMesh::LEAF_SIZE;
+            header.vertexCount = buffers.vertices.size() / 3;
+            header.packetCount = packets.size() / (9 * TriangleMesh::LEAF_SIZE);
+            header.nodeCount = nodes.size();
+            for (const auto & node : nodes) {
+                header.triangleCount += node.count;
+            }
+            for (size_t i = 0; i < 3; i++) {
+                header.bounds[2 * i] = nodes[0].bounds.minimum[i];
+                header.bounds[2 * i + 1] = nodes[0].bounds.maximum[i];
+            }
+
+            //依次计算各数组的偏移量，空数组的偏移量为0
+            const void * sections[MeshFile::SECTION_COUNT] = {buffers.vertices.data(), buffers.normals.data(), buffers.uvs.data(),
+                                                              buffers.indices.data(), packets.data(), nodes.data()};
+            const size_t sizes[MeshFile::SECTION_COUNT] = {sizeof(Real) * buffers.vertices.size(), sizeof(Real) * buffers.normals.size(),
+                                                           sizeof(Real) * buffers.uvs.size(), sizeof(Uint32) * buffers.indices.size(),
+                                                           sizeof(Real) * packets.size(), sizeof(TriangleMesh::Node) * nodes.size()};
+            size_t offset = sizeof(MeshFile::Header);
+            for (size_t i = 0; i < MeshFile::SECTION_COUNT; i++) {
+                if (sizes[i] == 0) continue;
+                offset = static_cast<size_t>(MeshFile::alignOffset(offset));
+                header.offsets[i] = offset;
+                offset += sizes[i];
+            }
+
+            writer.write(&header, sizeof(MeshFile::Header));
+            for (size_t i = 0; i < MeshFile::SECTION_COUNT; i++) {
+                if (sizes[i] == 0) continue;
+                writer.padTo(header.offsets[i]);
+                writer.write(sections[i], sizes[i]);
+            }
+        }
+
+        //读取scalarSize与Real不同的文件中的标量数组
+        void readScalars(const unsigned char * data, size_t count, Uint32 scalarSize, std::vector<Real> & target) {
+            target.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                if (scalarSize == 4) {
+                    float value;
+                    memcpy(&value, data + 4 * i, 4);
+                    target[i] = static_cast<Real>(value);
+                } else {
+                    double value;
+                    memcpy(&value, data + 8 * i, 8);
+                    target[i] = static_cast<Real>(value);
+                }
+            }
+        }
+    }
+
+    void MeshFile::write(const std::string & path, MeshBuffers buffers) {
+        FileWriter writer(path);
+        writeImage(writer, buffers);
+        writer.close();
+    }
+
+    std::vector<unsigned char> MeshFile::encode(MeshBuffers buffers) {
+        std::vector<unsigned char> ret;
+        BufferWriter writer(ret);
+        writeImage(writer, buffers);
+        return ret;
+    }
+
+    void MeshFile::convert(const std::string & source, const std::string & target) {
+        MeshBuffers buffers = MeshLoader::load(source);
+        MeshOptimizer::optimize(buffers);
+        write(target, std::move(buffers));
+    }
+
+    std::shared_ptr<TriangleMesh> MeshFile::load(const std::string & path, ResourceHandle material, Real bounds[6]) {
+        auto file = std::make_shared<MappedFile>(path, false);
+        const unsigned char * data = file->data();
+        const size_t size = file->size();
+        return load(std::move(file), data, size, path, material, bounds);
+    }
+
+    std::shared_ptr<TriangleMesh> MeshFile::load(std::shared_ptr<const void> storage, const unsigned char * data, size_t size,
+                                                 ResourceHandle material, Real bounds[6]) {
+        return load(std::move(storage), data, size, "<memory>", material, bounds);
+    }
+
+    std::shared_ptr<TriangleMesh> MeshFile::load(std::shared_ptr<const void> storage, const unsigned char * data, size_t size,
+                                                 const std::string & path, ResourceHandle material, Real bounds[6]) {
+        //检查文件头，数组直接按指针类型读取，起始地址需要按标量对齐
+        if (size < sizeof(Header) || reinterpret_cast<uintptr_t>(data) % alignof(double) != 0) {
+            throw std::runtime_error("Invalid mesh file: " + path);
+        }
+        Header header {};
+        memcpy(&header, data, sizeof(Header));
+        if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Invalid mesh file: " + path);
+        }
+        if (header.version != VERSION || !isLittleEndianHost()) {
+            throw std::runtime_error("Unsupported mesh file version: " + path);
+        }
+        if ((header.scalarSize != 4 && header.scalarSize != 8) || header.leafSize == 0 || header.leafSize > MAX_LEAF_SIZE ||
+            header.triangleCount == 0 || header.packetCount == 0 || header.nodeCount == 0 || header.vertexCount >= std::numeric_limits<Uint32>::max() ||
+            header.packetCount > header.triangleCount || header.packetCount > std::numeric_limits<Uint32>::max() / 3 / header.leafSize ||
+            header.triangleCount > header.leafSize * header.packetCount || header.nodeCount >= 2 * header.packetCount) {
+            throw std::runtime_error("Invalid mesh file: " + path);
+        }
+
+        //检查各数组是否位于文件范围内且对齐
+        const size_t slotCount = header.leafSize * header.packetCount;
+        const size_t sizes[SECTION_COUNT] = {header.scalarSize * 3 * header.vertexCount, header.scalarSize * 3 * header.vertexCount,
+                                             header.scalarSize * 2 * header.vertexCount, sizeof(Uint32) * 3 * slotCount,
+                                             header.scalarSize * 9 * slotCount, header.nodeSize * header.nodeCount};
+        const unsigned char * sections[SECTION_COUNT] = {};
+        for (size_t i = 0; i < SECTION_COUNT; i++) {
+            const Uint64 offset = header.offsets[i];
+            if (offset == 0) {
+                if (i == VERTICES || i == INDICES || i == PACKETS || i == NODES) throw std::runtime_error("Invalid mesh file: " + path);
+                continue;
+            }
+            if (offset % SECTION_ALIGNMENT != 0 || offset < sizeof(Header) || offset > size || sizes[i] > size - offset) {
+                throw std::runtime_error("Invalid mesh file: " + path);
+            }
+            sections[i] = data + offset;
+        }
+        if (bounds != null) {
+            for (size_t i = 0; i < 6; i++) {
+                bounds[i] = static_cast<Real>(header.bounds[i]);
+            }
+        }
+
+        if (header.scalarSize == sizeof(Real) && header.nodeSize == sizeof(TriangleMesh::Node) && header.leafSize == TriangleMesh::LEAF_SIZE) {
+            //布局和当前程序一致，网格直接使用映射内存或storage中的数据
+            TriangleMesh::View view {};
+            view.vertices = reinterpret_cast<const Real *>(sections[VERTICES]);
+            view.normals = reinterpret_cast<const Real *>(sections[NORMALS]);
+            view.uvs = reinterpret_cast<const Real *>(sections[UVS]);
+            view.indices = reinterpret_cast<const Uint32 *>(sections[INDICES]);
+            view.packets = reinterpret_cast<const Real *>(sections[PACKETS]);
+            view.nodes = reinterpret_cast<const TriangleMesh::Node *>(sections[NODES]);
+            view.vertexCount = header.vertexCount;
+            view.triangleCount = header.triangleCount;
+            view.packetCount = header.packetCount;
+            view.nodeCount = header.nodeCount;
+            return std::make_shared<TriangleMesh>(material, std::move(storage), view);
+        }
+
+        //标量类型或叶子宽度不同（float和double版本的程序之间交换文件），转换数据并重新构造BVH
+        MeshBuffers buffers;
+        readScalars(sections[VERTICES], 3 * header.vertexCount, header.scalarSize, buffers.vertices);
+        if (sections[NORMALS] != null) readScalars(sections[NORMALS], 3 * header.vertexCount, header.scalarSize, buffers.normals);
+        if (sections[UVS] != null) readScalars(sections[UVS], 2 * header.vertexCount, header.scalarSize, buffers.uvs);
+        //去掉叶子中补齐的位置，补齐的三角形三个下标都为0
+        const auto * indices = reinterpret_cast<const Uint32 *>(sections[INDICES]);
+        buffers.indices.reserve(3 * header.triangleCount);
+        for (size_t i = 0; i < slotCount; i++) {
+            const Uint32 * triangle = indices + 3 * i;
+            if (triangle[0] != 0 || triangle[1] != 0 || triangle[2] != 0) {
+                buffers.indices.insert(buffers.indices.end(), triangle, triangle + 3);
+            }
+        }
+        return std::make_shared<TriangleMesh>(material, std::move(buffers));
+    }
+}
@@ -0,0 +1,680 @@
+#include <util/MeshLoader.hpp>
+#include <util/MeshFile.hpp>
+#include <util/MappedFile.hpp>
+#include <cctype>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace renderer {
+    namespace {
+        //每个线程至少解析的字节数，小文件不值得启动线程
+        constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+        //表示顶点没有纹理坐标或法向量的下标
+        constexpr Uint32 NO_INDEX = std::numeric_limits<Uint32>::max();
+
+        size_t threadCount(size_t workSize) {
+            const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+            return std::max<size_t>(1, std::min(hardware, workSize / MIN_CHUNK_SIZE));
+        }
+
+        //将[0, count)分为threads段，每段调用一次func(线程编号, 起点, 终点)，第0段在当前线程中执行
+        template <typename F>
+        void parallelFor(size_t threads, size_t count, const F & func) {
+            std::vector<std::thread> workers;
+            std::vector<std::exception_ptr> errors(threads);
+            for (size_t i = 1; i < threads; i++) {
+                workers.emplace_back([&, i] {
+                    try {
+                        func(i, count * i / threads, count * (i + 1) / threads);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+            try {
+                func(0, 0, count / threads);
+            } catch (...) {
+                errors[0] = std::current_exception();
+            }
+            for (auto & worker : workers) {
+                worker.join();
+            }
+            for (const auto & error : errors) {
+                if (error) std::rethrow_exception(error);
+            }
+        }
+
+        //将每个线程的数组依次拼接
+        template <typename T>
+        void concatenate(std::vector<std::vector<T>> & parts, std::vector<T> & target) {
+            size_t total = 0;
+            for (const auto & part : parts) {
+                total += part.size();
+            }
+            target.clear();
+            target.reserve(total);
+            for (auto & part : parts) {
+                target.insert(target.end(), part.begin(), part.end());
+                std::vector<T>().swap(part);
+            }
+        }
+
+        // ====== OBJ ======
+
+        //面的一个顶点在OBJ文件中的三个下标，解析时暂存为局部下标，合并各线程结果时再转为全局下标
+        struct ObjCorner {
+            int64_t vertex, uv, normal;
+        };
+
+        //一个线程解析一段文件的结果
+        struct ObjChunk {
+            std::vector<Real> vertices, uvs, normals;
+            std::vector<ObjCorner> corners;     //三角形的顶点，每3个为一个三角形
+            Bounds bounds;
+        };
+
+        bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        const char * skipSpace(const char * p, const char * end) {
+            while (p < end && isSpace(*p)) p++;
+            return p;
+        }
+
+        const char * skipLine(const char * p, const char * end) {
+            while (p < end && *p != '\n') p++;
+            return p < end ? p + 1 : end;
+        }
+
+        //解析十进制浮点数，不依赖区域设置，比strtod快数倍
+        const char * parseReal(const char * p, const char * end, Real & value) {
+            static const double POWERS[] = {
+                    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+            p = skipSpace(p, end);
+            bool isNegative = false;
+            if (p < end && (*p == '-' || *p == '+')) {
+                isNegative = *p == '-';
+                p++;
+            }
+
+            uint64_t mantissa = 0;
+            int exponent = 0, digits = 0;
+            for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+                if (mantissa < 1000000000000000000ULL) mantissa = mantissa * 10 + (*p - '0'); else exponent++;
+            }
+            if (p < end && *p == '.') {
+                for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+                    if (mantissa < 1000000000000000000ULL) {
+                        mantissa = mantissa * 10 + (*p - '0');
+                        exponent--;
+                    }
+                }
+            }
+            if (digits == 0) {
+                throw std::runtime_error("Invalid number in OBJ file!");
+            }
+            if (p < end && (*p == 'e' || *p == 'E')) {
+                p++;
+                bool isExponentNegative = false;
+                if (p < end && (*p == '-' || *p == '+')) {
+                    isExponentNegative = *p == '-';
+                    p++;
+                }
+                int e = 0;
+                for (; p < end && *p >= '0' && *p <= '9'; p++) {
+                    if (e < 10000) e = e * 10 + (*p - '0');
+                }
+                exponent += isExponentNegative ? -e : e;
+            }
+
+            double result = static_cast<double>(mantissa);
+            if (exponent < 0) {
+                result = -exponent <= 22 ? result / POWERS[-exponent] : result * std::pow(10.0, exponent);
+            } else if (exponent > 0) {
+                result = exponent <= 22 ? result * POWERS[exponent] : result * std::pow(10.0, exponent);
+            }
+            value = static_cast<Real>(isNegative ? -result : result);
+            return p;
+        }
+
+        //OBJ下标的最大绝对值，超过时一定越界
+        constexpr int64_t MAX_OBJ_INDEX = int64_t(1) << 33;
+        //相对下标编码的基准值，编码后的值大于MAX_OBJ_INDEX，不会和全局下标混淆
+        constexpr int64_t RELATIVE_BASE = int64_t(1) << 40;
+        //没有该属性
+        constexpr int64_t MISSING_INDEX = std::numeric_limits<int64_t>::min();
+
+        const char * parseInteger(const char * p, const char * end, int64_t & value) {
+            bool isNegative = false;
+            if (p < end && (*p == '-' || *p == '+')) {
+                isNegative = *p == '-';
+                p++;
+            }
+            if (p == end || *p < '0' || *p > '9') {
+                throw std::runtime_error("Invalid index in OBJ file!");
+            }
+            value = 0;
+            for (; p < end && *p >= '0' && *p <= '9'; p++) {
+                //超过MAX_OBJ_INDEX后不再累加，避免溢出，之后按越界处理
+                if (value <= MAX_OBJ_INDEX) value = value * 10 + (*p - '0');
+            }
+            if (isNegative) value = -value;
+            return p;
+        }
+
+        /*
+         * OBJ的下标从1开始，负数表示相对于当前已定义的顶点个数
+         * 正数直接转为从0开始的全局下标；负数转为相对于当前块起点的下标（可能指向之前的块），加上RELATIVE_BASE编码，合并时再加上之前各块的顶点个数
+         */
+        int64_t encodeIndex(int64_t index, size_t localCount) {
+            if (index > MAX_OBJ_INDEX || index < -MAX_OBJ_INDEX) {
+                throw std::runtime_error("OBJ face index out of range!");
+            }
+            if (index > 0) return index - 1;
+            if (index < 0) return RELATIVE_BASE + static_cast<int64_t>(localCount) + index;
+            return MISSING_INDEX;
+        }
+
+        //解析面的一个顶点：v、v/vt、v//vn或v/vt/vn
+        const char * parseCorner(const char * p, const char * end, const ObjChunk & chunk, ObjCorner & corner) {
+            int64_t index;
+            p = parseInteger(p, end, index);
+            if (index == 0) {
+                throw std::runtime_error("Invalid index in OBJ file!");
+            }
+            corner.vertex = encodeIndex(index, chunk.vertices.size() / 3);
+            corner.uv = corner.normal = MISSING_INDEX;
+            if (p < end && *p == '/') {
+                p++;
+                if (p < end && *p != '/') {
+                    p = parseInteger(p, end, index);
+                    corner.uv = encodeIndex(index, chunk.uvs.size() / 2);
+                }
+                if (p < end && *p == '/') {
+                    p = parseInteger(p + 1, end, index);
+                    corner.normal = encodeIndex(index, chunk.normals.size() / 3);
+                }
+            }
+            return p;
+        }
+
+        void parseObjChunk(const char * p, const char * end, ObjChunk & chunk) {
+            std::vector<ObjCorner> polygon;
+            while (p < end) {
+                p = skipSpace(p, end);
+                if (p == end) break;
+                const char c0 = *p;
+                const char c1 = p + 1 < end ? p[1] : '\n';
+                if (c0 == 'v' && isSpace(c1)) {
+                    Real point[3];
+                    for (auto & i : point) {
+                        p = parseReal(p + 1, end, i);
+                    }
+                    chunk.vertices.insert(chunk.vertices.end(), point, point + 3);
+                    chunk.bounds.merge(point);
+                } else if (c0 == 'v' && c1 == 't') {
+                    Real u, v = 0.0;
+                    p = parseReal(p + 2, end, u);
+                    //部分文件只有一个纹理坐标分量
+                    const char * next = skipSpace(p, end);
+                    if (next < end && *next != '\n') p = parseReal(next, end, v);
+                    chunk.uvs.push_back(u);
+                    chunk.uvs.push_back(v);
+                } else if (c0 == 'v' && c1 == 'n') {
+                    Real normal[3];
+                    p += 2;
+                    for (auto & i : normal) {
+                        p = parseReal(p, end, i);
+                    }
+                    chunk.normals.insert(chunk.normals.end(), normal, normal + 3);
+                } else if (c0 == 'f' && isSpace(c1)) {
+                    polygon.clear();
+                    p = skipSpace(p + 1, end);
+                    while (p < end && *p != '\n' && *p != '#') {
+                        ObjCorner corner {};
+                        p = skipSpace(parseCorner(p, end, chunk, corner), end);
+                        polygon.push_back(corner);
+                    }
+                    //扇形三角化
+                    for (size_t i = 2; i < polygon.size(); i++) {
+                        chunk.corners.push_back(polygon[0]);
+                        chunk.corners.push_back(polygon[i - 1]);
+                        chunk.corners.push_back(polygon[i]);
+                    }
+                }
+                //注释、对象、分组、材质等其他语句直接跳过
+                p = skipLine(p, end);
+            }
+        }
+
+        //将编码后的下标转为全局下标并检查范围，没有该属性时返回NO_INDEX
+        Uint32 resolveIndex(int64_t encoded, size_t offset, size_t count) {
+            if (encoded == MISSING_INDEX) {
+                return NO_INDEX;
+            }
+            const int64_t index = encoded > MAX_OBJ_INDEX ? static_cast<int64_t>(offset) + encoded - RELATIVE_BASE : encoded;
+            if (index < 0 || static_cast<size_t>(index) >= count) {
+                throw std::runtime_error("OBJ face index out of range!");
+            }
+            return static_cast<Uint32>(index);
+        }
+
+        struct CornerKeyHash {
+            size_t operator()(const std::array<Uint32, 3> & key) const {
+                return std::hash<uint64_t>()((static_cast<uint64_t>(key[0]) << 32 | key[1]) ^ (static_cast<uint64_t>(key[2]) * 0x9E3779B97F4A7C15ULL));
+            }
+        };
+
+        // ====== PLY ======
+
+        enum class PlyType {
+            INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64
+        };
+
+        struct PlyProperty {
+            std::string name;
+            PlyType type;
+            bool isList;
+            PlyType countType;      //列表长度的类型
+        };
+
+        struct PlyElement {
+            std::string name;
+            size_t count;
+            std::vector<PlyProperty> properties;
+        };
+
+        PlyType parsePlyType(const std::string & name) {
+            if (name == "char" || name == "int8") return PlyType::INT8;
+            if (name == "uchar" || name == "uint8") return PlyType::UINT8;
+            if (name == "short" || name == "int16") return PlyType::INT16;
+            if (name == "ushort" || name == "uint16") return PlyType::UINT16;
+            if (name == "int" || name == "int32") return PlyType::INT32;
+            if (name == "uint" || name == "uint32") return PlyType::UINT32;
+            if (name == "float" || name == "float32") return PlyType::FLOAT32;
+            if (name == "double" || name == "float64") return PlyType::FLOAT64;
+            throw std::runtime_error("Unknown PLY property type: " + name);
+        }
+
+        size_t plyTypeSize(PlyType type) {
+            switch (type) {
+                case PlyType::INT8: case PlyType::UINT8: return 1;
+                case PlyType::INT16: case PlyType::UINT16: return 2;
+                case PlyType::INT32: case PlyType::UINT32: case PlyType::FLOAT32: return 4;
+                default: return 8;
+            }
+        }
+
+        //读取一个标量，swap为true时文件字节序和本机相反
+        double readPlyValue(const unsigned char * p, PlyType type, bool swap) {
+            unsigned char bytes[8];
+            const size_t size = plyTypeSize(type);
+            for (size_t i = 0; i < size; i++) {
+                bytes[i] = swap ? p[size - 1 - i] : p[i];
+            }
+            switch (type) {
+                case PlyType::INT8: { int8_t v; memcpy(&v, bytes, 1); return v; }
+                case PlyType::UINT8: { uint8_t v; memcpy(&v, bytes, 1); return v; }
+                case PlyType::INT16: { int16_t v; memcpy(&v, bytes, 2); return v; }
+                case PlyType::UINT16: { uint16_t v; memcpy(&v, bytes, 2); return v; }
+                case PlyType::INT32: { int32_t v; memcpy(&v, bytes, 4); return v; }
+                case PlyType::UINT32: { uint32_t v; memcpy(&v, bytes, 4); return v; }
+                case PlyType::FLOAT32: { float v; memcpy(&v, bytes, 4); return v; }
+                default: { double v; memcpy(&v, bytes, 8); return v; }
+            }
+        }
+
+        //读取列表长度或顶点下标
+        int64_t readPlyInteger(const unsigned char * p, PlyType type, bool swap) {
+            return static_cast<int64_t>(readPlyValue(p, type, swap));
+        }
+
+        //元素中不含列表属性时每个元素的字节数，含列表属性时返回0
+        size_t plyElementStride(const PlyElement & element) {
+            size_t stride = 0;
+            for (const auto & property : element.properties) {
+                if (property.isList) return 0;
+                stride += plyTypeSize(property.type);
+            }
+            return stride;
+        }
+
+        //跳过一个含列表属性的元素，返回下一个元素的起点
+        const unsigned char * skipPlyElement(const unsigned char * p, const unsigned char * end, const PlyElement & element, bool swap) {
+            for (const auto & property : element.properties) {
+                if (property.isList) {
+                    if (p + plyTypeSize(property.countType) > end) throw std::runtime_error("Unexpected end of PLY file!");
+                    const int64_t count = readPlyInteger(p, property.countType, swap);
+                    p += plyTypeSize(property.countType) + static_cast<size_t>(count) * plyTypeSize(property.type);
+                } else {
+                    p += plyTypeSize(property.type);
+                }
+            }
+            return p;
+        }
+    }
+
+    MeshBuffers MeshLoader::load(const std::string & path, Real bounds[6]) {
+        std::string extension = path.substr(path.find_last_of('.') == std::string::npos ? path.size() : path.find_last_of('.'));
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (extension == ".obj") {
+            return loadOBJ(path, bounds);
+        } else if (extension == ".ply") {
+            return loadPLY(path, bounds);
+        }
+        throw std::runtime_error("Unsupported mesh file format: " + path);
+    }
+
+    MeshBuffers MeshLoader::loadOBJ(const std::string & path, Real bounds[6]) {
+        const MappedFile file(path);
+        const char * const begin = file.begin();
+        const char * const end = file.end();
+
+        //按字节数分块，块的边界移动到下一行的开头，每个块由一个线程解析
+        const size_t threads = threadCount(file.size());
+        std::vector<const char *> starts(threads + 1, end);
+        starts[0] = begin;
+        for (size_t i = 1; i < threads; i++) {
+            const char * p = std::max(begin + file.size() * i / threads, starts[i - 1]);
+            starts[i] = p == begin ? p : skipLine(p - 1, end);
+        }
+        std::vector<ObjChunk> chunks(threads);
+        parallelFor(threads, threads, [&](size_t, size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                parseObjChunk(starts[i], starts[i + 1], chunks[i]);
+            }
+        });
+
+        //计算每个块之前的顶点、纹理坐标和法向量个数，用于转换相对下标
+        std::vector<size_t> vertexOffsets(threads + 1, 0), uvOffsets(threads + 1, 0), normalOffsets(threads + 1, 0), cornerOffsets(threads + 1, 0);
+        for (size_t i = 0; i < threads; i++) {
+            vertexOffsets[i + 1] = vertexOffsets[i] + chunks[i].vertices.size() / 3;
+            uvOffsets[i + 1] = uvOffsets[i] + chunks[i].uvs.size() / 2;
+            normalOffsets[i + 1] = normalOffsets[i] + chunks[i].normals.size() / 3;
+            cornerOffsets[i + 1] = cornerOffsets[i] + chunks[i].corners.size();
+        }
+        const size_t vertexCount = vertexOffsets[threads];
+        const size_t cornerCount = cornerOffsets[threads];
+        if (vertexCount >= NO_INDEX || cornerCount > std::numeric_limits<Uint32>::max()) {
+            throw std::runtime_error("OBJ file is too large!");
+        }
+
+        //并行转换为全局下标，同时检查每个顶点是否都带有纹理坐标和法向量、以及各属性的下标是否和顶点下标一致
+        std::vector<Uint32> positionIndices(cornerCount), uvIndices(cornerCount), normalIndices(cornerCount);
+        std::vector<char> hasUV(threads, 1), hasNormal(threads, 1), isUnified(threads, 1);
+        parallelFor(threads, threads, [&](size_t, size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                const auto & corners = chunks[i].corners;
+                for (size_t j = 0; j < corners.size(); j++) {
+                    const size_t k = cornerOffsets[i] + j;
+                    positionIndices[k] = resolveIndex(corners[j].vertex, vertexOffsets[i], vertexCount);
+                    uvIndices[k] = resolveIndex(corners[j].uv, uvOffsets[i], uvOffsets[threads]);
+                    normalIndices[k] = resolveIndex(corners[j].normal, normalOffsets[i], normalOffsets[threads]);
+                    hasUV[i] &= uvIndices[k] != NO_INDEX;
+                    hasNormal[i] &= normalIndices[k] != NO_INDEX;
+                    isUnified[i] &= (uvIndices[k] == NO_INDEX || uvIndices[k] == positionIndices[k]) &&
+                                    (normalIndices[k] == NO_INDEX || normalIndices[k] == positionIndices[k]);
+                }
+                std::vector<ObjCorner>().swap(chunks[i].corners);
+            }
+        });
+        const bool useUV = cornerCount > 0 && std::all_of(hasUV.begin(), hasUV.end(), [](char c) { return c != 0; });
+        const bool useNormal = cornerCount > 0 && std::all_of(hasNormal.begin(), hasNormal.end(), [](char c) { return c != 0; });
+        const bool unified = std::all_of(isUnified.begin(), isUnified.end(), [](char c) { return c != 0; }) &&
+                             (!useUV || uvOffsets[threads] == vertexCount) && (!useNormal || normalOffsets[threads] == vertexCount);
+
+        if (bounds != null) {
+            Bounds total;
+            for (const auto & chunk : chunks) {
+                total.merge(chunk.bounds);
+            }
+            total.copyTo(bounds);
+        }
+
+        std::vector<std::vector<Real>> vertexParts(threads), uvParts(threads), normalParts(threads);
+        for (size_t i = 0; i < threads; i++) {
+            vertexParts[i].swap(chunks[i].vertices);
+            uvParts[i].swap(chunks[i].uvs);
+            normalParts[i].swap(chunks[i].normals);
+        }
+        std::vector<Real> positions, uvs, normals;
+        concatenate(vertexParts, positions);
+        if (useUV) concatenate(uvParts, uvs);
+        if (useNormal) concatenate(normalParts, normals);
+
+        MeshBuffers ret;
+        if (unified) {
+            //所有属性的下标和顶点下标一致（扫描数据和多数导出工具的输出），直接使用顶点下标
+            ret.vertices.swap(positions);
+            ret.uvs.swap(uvs);
+            ret.normals.swap(normals);
+            ret.indices.swap(positionIndices);
+            return ret;
+        }
+
+        //属性下标不一致时，每种下标组合生成一个新顶点
+        std::unordered_map<std::array<Uint32, 3>, Uint32, CornerKeyHash> vertexMap;
+        vertexMap.reserve(vertexCount);
+        ret.indices.resize(cornerCount);
+        for (size_t k = 0; k < cornerCount; k++) {
+            const std::array<Uint32, 3> key = {positionIndices[k], useUV ? uvIndices[k] : NO_INDEX, useNormal ? normalIndices[k] : NO_INDEX};
+            const auto result = vertexMap.emplace(key, static_cast<Uint32>(vertexMap.size()));
+            if (result.second) {
+                ret.vertices.insert(ret.vertices.end(), &positions[3 * key[0]], &positions[3 * key[0]] + 3);
+                if (useUV) ret.uvs.insert(ret.uvs.end(), &uvs[2 * key[1]], &uvs[2 * key[1]] + 2);
+                if (useNormal) ret.normals.insert(ret.normals.end(), &normals[3 * key[2]], &normals[3 * key[2]] + 3);
+            }
+            ret.indices[k] = result.first->second;
+        }
+        return ret;
+    }
+
+    MeshBuffers MeshLoader::loadPLY(const std::string & path, Real bounds[6]) {
+        const MappedFile file(path);
+        const unsigned char * const end = file.data() + file.size();
+
+        //解析文本格式的文件头
+        const char * headerEnd = file.begin();
+        const std::string endHeader("end_header");
+        std::vector<PlyElement> elements;
+        bool isBinaryLittleEndian = false;
+        bool isFirstLine = true;
+        while (true) {
+            const char * lineEnd = headerEnd;
+            while (lineEnd < file.end() && *lineEnd != '\n') lineEnd++;
+            if (lineEnd == file.end()) {
+                throw std::runtime_error("PLY header is not terminated: " + path);
+            }
+            std::string line(headerEnd, lineEnd);
+            headerEnd = lineEnd + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+
+            std::istringstream stream(line);
+            std::string keyword;
+            stream >> keyword;
+            if (isFirstLine) {
+                if (keyword != "ply") throw std::runtime_error("Not a PLY file: " + path);
+                isFirstLine = false;
+            } else if (keyword == "format") {
+                std::string format;
+                stream >> format;
+                if (format == "binary_little_endian") {
+                    isBinaryLittleEndian = true;
+                } else if (format != "binary_big_endian") {
+                    throw std::runtime_error("Unsupported PLY format: " + format);
+                }
+            } else if (keyword == "element") {
+                PlyElement element;
+                stream >> element.name >> element.count;
+                elements.push_back(element);
+            } else if (keyword == "property") {
+                if (elements.empty()) throw std::runtime_error("PLY property without element: " + path);
+                PlyProperty property {};
+                std::string type;
+                stream >> type;
+                if (type == "list") {
+                    std::string countType;
+                    stream >> countType >> type;
+                    property.isList = true;
+                    property.countType = parsePlyType(countType);
+                }
+                property.type = parsePlyType(type);
+                stream >> property.name;
+                elements.back().properties.push_back(property);
+            } else if (keyword == endHeader) {
+                break;
+            }
+        }
+        const bool swap = isBinaryLittleEndian != MeshFile::isLittleEndianHost();
+        const size_t threads = threadCount(file.size());
+
+        MeshBuffers ret;
+        Bounds total;
+        const auto * p = reinterpret_cast<const unsigned char *>(headerEnd);
+        for (const auto & element : elements) {
+            const size_t stride = plyElementStride(element);
+
+            if (element.name == "vertex") {
+                //顶点元素只有标量属性，每个顶点的字节数固定，按顶点下标分段并行读取
+                if (stride == 0) throw std::runtime_error("PLY vertex element must not contain list properties!");
+                if (p + stride * element.count > end) throw std::runtime_error("Unexpected end of PLY file!");
+                if (element.count >= NO_INDEX) throw std::runtime_error("PLY file is too large!");
+
+                //依次为x、y、z、nx、ny、nz、u、v属性在顶点内的字节偏移
+                const char * const names[8][3] = {{"x"}, {"y"}, {"z"}, {"nx"}, {"ny"}, {"nz"},
+                                                  {"u", "s", "texture_u"}, {"v", "t", "texture_v"}};
+                int offsets[8];
+                PlyType types[8];
+                std::fill(offsets, offsets + 8, -1);
+                size_t offset = 0;
+                for (const auto & property : element.properties) {
+                    for (size_t i = 0; i < 8; i++) {
+                        for (const char * name : names[i]) {
+                            if (name != null && property.name == name) {
+                                offsets[i] = static_cast<int>(offset);
+                                types[i] = property.type;
+                            }
+                        }
+                    }
+                    offset += plyTypeSize(property.type);
+                }
+                if (offsets[0] < 0 || offsets[1] < 0 || offsets[2] < 0) {
+                    throw std::runtime_error("PLY vertex element has no position: " + path);
+                }
+                const bool useNormal = offsets[3] >= 0 && offsets[4] >= 0 && offsets[5] >= 0;
+                const bool useUV = offsets[6] >= 0 && offsets[7] >= 0;
+
+                ret.vertices.resize(3 * element.count);
+                if (useNormal) ret.normals.resize(3 * element.count);
+                if (useUV) ret.uvs.resize(2 * element.count);
+                const size_t vertexThreads = std::max<size_t>(1, std::min(threads, stride * element.count / MIN_CHUNK_SIZE));
+                std::vector<Bounds> threadBounds(vertexThreads);
+                parallelFor(vertexThreads, element.count, [&](size_t thread, size_t first, size_t last) {
+                    Bounds & localBounds = threadBounds[thread];
+                    for (size_t i = first; i < last; i++) {
+                        const unsigned char * vertex = p + stride * i;
+                        for (size_t j = 0; j < 3; j++) {
+                            ret.vertices[3 * i + j] = static_cast<Real>(readPlyValue(vertex + offsets[j], types[j], swap));
+                            if (useNormal) ret.normals[3 * i + j] = static_cast<Real>(readPlyValue(vertex + offsets[3 + j], types[3 + j], swap));
+                        }
+                        if (useUV) {
+                            ret.uvs[2 * i] = static_cast<Real>(readPlyValue(vertex + offsets[6], types[6], swap));
+                            ret.uvs[2 * i + 1] = static_cast<Real>(readPlyValue(vertex + offsets[7], types[7], swap));
+                        }
+                        localBounds.merge(&ret.vertices[3 * i]);
+                    }
+                });
+                for (const auto & b : threadBounds) {
+                    total.merge(b);
+                }
+                p += stride * element.count;
+
+            } else if (element.name == "face") {
+                //找到顶点下标列表，其余属性只计算字节数
+                size_t before = 0, after = 0;
+                const PlyProperty * list = null;
+                for (const auto & property : element.properties) {
+                    if (property.isList && (property.name == "vertex_indices" || property.name == "vertex_index") && list == null) {
+                        list = &property;
+                    } else if (property.isList) {
+                        throw std::runtime_error("Unsupported PLY face list property: " + property.name);
+                    } else {
+                        (list == null ? before : after) += plyTypeSize(property.type);
+                    }
+                }
+                if (list == null) throw std::runtime_error("PLY face element has no vertex_indices: " + path);
+                const size_t countSize = plyTypeSize(list->countType);
+                const size_t indexSize = plyTypeSize(list->type);
+                const size_t vertexCount = ret.vertices.size() / 3;
+
+                //扫描数据通常全部为三角形，此时每个面的字节数固定，先并行检查假设，再按面下标分段并行读取
+                const size_t triangleStride = before + countSize + 3 * indexSize + after;
+                bool isAllTriangles = p + triangleStride * element.count <= end;
+                const size_t faceThreads = std::max<size_t>(1, std::min(threads, triangleStride * element.count / MIN_CHUNK_SIZE));
+                if (isAllTriangles) {
+                    std::vector<char> results(faceThreads, 1);
+                    parallelFor(faceThreads, element.count, [&](size_t thread, size_t first, size_t last) {
+                        for (size_t i = first; i < last && results[thread]; i++) {
+                            results[thread] = readPlyInteger(p + triangleStride * i + before, list->countType, swap) == 3;
+                        }
+                    });
+                    isAllTriangles = std::all_of(results.begin(), results.end(), [](char c) { return c != 0; });
+                }
+
+                const auto readIndex = [&](const unsigned char * q) {
+                    const int64_t index = readPlyInteger(q, list->type, swap);
+                    if (index < 0 || static_cast<size_t>(index) >= vertexCount) {
+                        throw std::runtime_error("PLY face index out of range!");
+                    }
+                    return static_cast<Uint32>(index);
+                };
+                if (isAllTriangles) {
+                    if (3 * element.count > std::numeric_limits<Uint32>::max()) throw std::runtime_error("PLY file is too large!");
+                    ret.indices.resize(3 * element.count);
+                    parallelFor(faceThreads, element.count, [&](size_t, size_t first, size_t last) {
+                        for (size_t i = first; i < last; i++) {
+                            const unsigned char * face = p + triangleStride * i + before + countSize;
+                            for (size_t j = 0; j < 3; j++) {
+                                ret.indices[3 * i + j] = readIndex(face + j * indexSize);
+                            }
+                        }
+                    });
+                    p += triangleStride * element.count;
+                } else {
+                    //含多边形时面的字节数不固定，顺序读取并扇形三角化
+                    ret.indices.reserve(3 * element.count);
+                    for (size_t i = 0; i < element.count; i++) {
+                        if (p + before + countSize > end) throw std::runtime_error("Unexpected end of PLY file!");
+                        const size_t count = static_cast<size_t>(readPlyInteger(p + before, list->countType, swap));
+                        const unsigned char * face = p + before + countSize;
+                        if (face + count * indexSize + after > end) throw std::runtime_error("Unexpected end of PLY file!");
+                        for (size_t j = 2; j < count; j++) {
+                            ret.indices.push_back(readIndex(face));
+                            ret.indices.push_back(readIndex(face + (j - 1) * indexSize));
+                            ret.indices.push_back(readIndex(face + j * indexSize));
+                        }
+                        p = face + count * indexSize + after;
+                    }
+                }
+
+            } else {
+                //跳过其他元素
+                if (stride != 0) {
+                    p += stride * element.count;
+                } else {
+                    for (size_t i = 0; i < element.count; i++) {
+                        p = skipPlyElement(p, end, element, swap);
+                    }
+                }
+                if (p > end) throw std::runtime_error("Unexpected end of PLY file!");
+            }
+        }
+        if (bounds != null) {
+            total.copyTo(bounds);
+        }
+        return ret;
+    }
+}
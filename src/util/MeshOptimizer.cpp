@@ -0,0 +1,290 @@
+#include <util/MeshOptimizer.hpp>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace renderer {
+    constexpr Real MeshOptimizer::ATTRIBUTE_TOLERANCE;
+
+    namespace {
+        //链表结束或没有对应顶点的下标
+        constexpr Uint32 NO_INDEX = std::numeric_limits<Uint32>::max();
+
+        //顶点缓冲区和索引缓冲区的字节数
+        size_t bufferBytes(const MeshBuffers & buffers) {
+            return sizeof(Real) * (buffers.vertices.size() + buffers.normals.size() + buffers.uvs.size()) + sizeof(Uint32) * buffers.indices.size();
+        }
+
+        void check(const MeshBuffers & buffers) {
+            const size_t vertexCount = buffers.vertices.size() / 3;
+            if (buffers.vertices.size() % 3 != 0 || buffers.indices.size() % 3 != 0) {
+                throw std::runtime_error("Mesh buffer size is not a multiple of 3!");
+            }
+            if ((!buffers.normals.empty() && buffers.normals.size() != 3 * vertexCount) ||
+                (!buffers.uvs.empty() && buffers.uvs.size() != 2 * vertexCount)) {
+                throw std::runtime_error("Mesh attribute count does not match vertex count!");
+            }
+            for (const auto index : buffers.indices) {
+                if (index >= vertexCount) {
+                    throw std::runtime_error("Mesh vertex index out of range!");
+                }
+            }
+        }
+
+        //网格单元坐标的散列值，不同单元的散列值相同时只会使链表变长，不影响结果
+        Uint64 cellKey(long long x, long long y, long long z) {
+            Uint64 key = static_cast<Uint64>(x) * 0x9E3779B97F4A7C15ULL;
+            key ^= static_cast<Uint64>(y) * 0xC2B2AE3D27D4EB4FULL + (key << 6) + (key >> 2);
+            key ^= static_cast<Uint64>(z) * 0x165667B19E3779F9ULL + (key << 6) + (key >> 2);
+            return key;
+        }
+
+        /*
+         * 坐标所在的网格单元，tolerance不大于0时只合并完全相同的位置，直接使用坐标的二进制表示作为单元
+         * 坐标相对tolerance过大时单元坐标被截断，只会使不同的单元共用链表
+         */
+        long long cellOf(Real value, Real tolerance) {
+            if (tolerance > 0.0) {
+                constexpr double limit = static_cast<double>(1LL << 62);
+                return static_cast<long long>(std::max(-limit, std::min(limit, std::floor(static_cast<double>(value) / tolerance))));
+            }
+            //0.0和-0.0是相同的位置
+            const Real normalized = value == 0.0 ? 0.0 : value;
+            long long bits = 0;
+            memcpy(&bits, &normalized, sizeof(Real));
+            return bits;
+        }
+
+        bool closeEnough(const Real * a, const Real * b, size_t count, Real tolerance) {
+            for (size_t i = 0; i < count; i++) {
+                if (std::abs(a[i] - b[i]) > tolerance) return false;
+            }
+            return true;
+        }
+
+        /*
+         * 焊接顶点：按边长为tolerance的网格划分空间，每个顶点只和所在单元及相邻26个单元中已保留的顶点比较，tolerance不大于0时只比较所在单元
+         * 保留的顶点按原顺序就地压缩到缓冲区前部，返回被焊接的顶点数
+         */
+        size_t weldVertices(MeshBuffers & buffers, Real tolerance) {
+            const size_t vertexCount = buffers.vertices.size() / 3;
+            const bool hasNormals = !buffers.normals.empty();
+            const bool hasUVs = !buffers.uvs.empty();
+            const long long neighbor = tolerance > 0.0 ? 1 : 0;
+            const double toleranceSquare = tolerance > 0.0 ? static_cast<double>(tolerance) * tolerance : 0.0;
+
+            //heads为每个单元中最后保留的顶点，next将同一单元中保留的顶点串成链表
+            std::unordered_map<Uint64, Uint32> heads;
+            heads.reserve(vertexCount);
+            std::vector<Uint32> next;
+            next.reserve(vertexCount);
+            std::vector<Uint32> remap(vertexCount);
+
+            Uint32 count = 0;
+            for (size_t i = 0; i < vertexCount; i++) {
+                const Real * p = &buffers.vertices[3 * i];
+                long long cell[3];
+                for (size_t axis = 0; axis < 3; axis++) {
+                    cell[axis] = cellOf(p[axis], tolerance);
+                }
+
+                Uint32 found = NO_INDEX;
+                for (long long dx = -neighbor; dx <= neighbor && found == NO_INDEX; dx++) {
+                    for (long long dy = -neighbor; dy <= neighbor && found == NO_INDEX; dy++) {
+                        for (long long dz = -neighbor; dz <= neighbor && found == NO_INDEX; dz++) {
+                            const auto iterator = heads.find(cellKey(cell[0] + dx, cell[1] + dy, cell[2] + dz));
+                            if (iterator == heads.end()) continue;
+                            for (Uint32 j = iterator->second; j != NO_INDEX; j = next[j]) {
+                                const Real * q = &buffers.vertices[3 * j];
+                                double distanceSquare = 0.0;
+                                for (size_t axis = 0; axis < 3; axis++) {
+                                    const double d = static_cast<double>(p[axis]) - q[axis];
+                                    distanceSquare += d * d;
+                                }
+                                if (distanceSquare <= toleranceSquare &&
+                                    (!hasNormals || closeEnough(&buffers.normals[3 * i], &buffers.normals[3 * j], 3, MeshOptimizer::ATTRIBUTE_TOLERANCE)) &&
+                                    (!hasUVs || closeEnough(&buffers.uvs[2 * i], &buffers.uvs[2 * j], 2, MeshOptimizer::ATTRIBUTE_TOLERANCE))) {
+                                    found = j;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+                if (found != NO_INDEX) {
+                    remap[i] = found;
+                    continue;
+                }
+
+                //保留的顶点写入的位置不会超过当前顶点，之后读取的顶点不会被覆盖
+                if (count != i) {
+                    std::copy_n(&buffers.vertices[3 * i], 3, &buffers.vertices[3 * count]);
+                    if (hasNormals) std::copy_n(&buffers.normals[3 * i], 3, &buffers.normals[3 * count]);
+                    if (hasUVs) std::copy_n(&buffers.uvs[2 * i], 2, &buffers.uvs[2 * count]);
+                }
+                Uint32 & head = heads.emplace(cellKey(cell[0], cell[1], cell[2]), NO_INDEX).first->second;
+                next.push_back(head);
+                head = count;
+                remap[i] = count++;
+            }
+
+            buffers.vertices.resize(3 * count);
+            if (hasNormals) buffers.normals.resize(3 * count);
+            if (hasUVs) buffers.uvs.resize(2 * count);
+            for (auto & index : buffers.indices) {
+                index = remap[index];
+            }
+            return vertexCount - count;
+        }
+
+        //和顶点顺序及环绕方向无关的三角形的键
+        struct TriangleKey {
+            Uint32 index[3];
+
+            bool operator==(const TriangleKey & key) const {
+                return index[0] == key.index[0] && index[1] == key.index[1] && index[2] == key.index[2];
+            }
+        };
+
+        struct TriangleKeyHash {
+            size_t operator()(const TriangleKey & key) const {
+                return static_cast<size_t>(cellKey(key.index[0], key.index[1], key.index[2]));
+            }
+        };
+
+        //两条边夹角的正弦值小于机器精度时认为三角形退化，使用double计算避免float的叉积下溢
+        bool isDegenerate(const MeshBuffers & buffers, const Uint32 * index) {
+            if (index[0] == index[1] || index[1] == index[2] || index[0] == index[2]) {
+                return true;
+            }
+            const Real * p0 = &buffers.vertices[3 * index[0]];
+            const Real * p1 = &buffers.vertices[3 * index[1]];
+            const Real * p2 = &buffers.vertices[3 * index[2]];
+            double e1[3], e2[3];
+            for (size_t axis = 0; axis < 3; axis++) {
+                e1[axis] = static_cast<double>(p1[axis]) - p0[axis];
+                e2[axis] = static_cast<double>(p2[axis]) - p0[axis];
+            }
+            const double cross[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            const double crossSquare = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+            const double lengthSquare = (e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]) * (e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2]);
+            constexpr double epsilon = std::numeric_limits<Real>::epsilon();
+            return crossSquare <= epsilon * epsilon * lengthSquare;
+        }
+
+        //删除退化和重复的三角形，保留的三角形按原顺序压缩到索引缓冲区前部
+        void removeTriangles(MeshBuffers & buffers, size_t & degenerateCount, size_t & duplicateCount) {
+            const size_t triangleCount = buffers.indices.size() / 3;
+            std::unordered_set<TriangleKey, TriangleKeyHash> triangles;
+            triangles.reserve(triangleCount);
+
+            size_t count = 0;
+            for (size_t i = 0; i < triangleCount; i++) {
+                const Uint32 * index = &buffers.indices[3 * i];
+                if (isDegenerate(buffers, index)) {
+                    degenerateCount++;
+                    continue;
+                }
+                TriangleKey key = {{index[0], index[1], index[2]}};
+                std::sort(std::begin(key.index), std::end(key.index));
+                if (!triangles.insert(key).second) {
+                    duplicateCount++;
+                    continue;
+                }
+                if (count != i) {
+                    std::copy_n(index, 3, &buffers.indices[3 * count]);
+                }
+                count++;
+            }
+            buffers.indices.resize(3 * count);
+        }
+
+        //将10位整数的每一位间隔两位展开，三个轴交错后得到30位的Morton码
+        Uint32 expandBits(Uint32 value) {
+            value = (value * 0x00010001u) & 0xFF0000FFu;
+            value = (value * 0x00000101u) & 0x0F00F00Fu;
+            value = (value * 0x00000011u) & 0xC30C30C3u;
+            value = (value * 0x00000005u) & 0x49249249u;
+            return value;
+        }
+
+        //按三角形中心的Morton码重排三角形，再按第一次被引用的顺序重排顶点，返回删除的未引用顶点数
+        size_t reorder(MeshBuffers & buffers) {
+            const size_t vertexCount = buffers.vertices.size() / 3;
+            const size_t triangleCount = buffers.indices.size() / 3;
+
+            Bounds bounds;
+            for (const auto index : buffers.indices) {
+                bounds.merge(&buffers.vertices[3 * index]);
+            }
+
+            //三角形中心量化到每个轴1024格，Morton码相同时保持原顺序
+            std::vector<std::pair<Uint32, Uint32>> codes(triangleCount);
+            for (size_t i = 0; i < triangleCount; i++) {
+                Uint32 code = 0;
+                for (size_t axis = 0; axis < 3; axis++) {
+                    Real center = 0.0;
+                    for (size_t j = 0; j < 3; j++) {
+                        center += buffers.vertices[3 * buffers.indices[3 * i + j] + axis];
+                    }
+                    const Real extent = bounds.maximum[axis] - bounds.minimum[axis];
+                    const Real relative = extent > 0.0 ? (center / 3.0 - bounds.minimum[axis]) / extent : 0.0;
+                    const auto cell = static_cast<Uint32>(std::min<Real>(std::max<Real>(relative * 1024.0, 0.0), 1023.0));
+                    code |= expandBits(cell) << (2 - axis);
+                }
+                codes[i] = std::make_pair(code, static_cast<Uint32>(i));
+            }
+            std::sort(codes.begin(), codes.end());
+
+            std::vector<Uint32> indices(buffers.indices.size());
+            std::vector<Uint32> remap(vertexCount, NO_INDEX);
+            Uint32 count = 0;
+            for (size_t i = 0; i < triangleCount; i++) {
+                for (size_t j = 0; j < 3; j++) {
+                    Uint32 & target = remap[buffers.indices[3 * codes[i].second + j]];
+                    if (target == NO_INDEX) target = count++;
+                    indices[3 * i + j] = target;
+                }
+            }
+            buffers.indices.swap(indices);
+
+            //顶点属性按新的顺序写入新数组，未被引用的顶点被丢弃
+            const auto permute = [&](std::vector<Real> & attribute, size_t size) {
+                if (attribute.empty()) return;
+                std::vector<Real> result(size * count);
+                for (size_t i = 0; i < vertexCount; i++) {
+                    if (remap[i] == NO_INDEX) continue;
+                    std::copy_n(&attribute[size * i], size, &result[size * remap[i]]);
+                }
+                attribute.swap(result);
+            };
+            permute(buffers.vertices, 3);
+            permute(buffers.normals, 3);
+            permute(buffers.uvs, 2);
+            return vertexCount - count;
+        }
+    }
+
+    MeshOptimizer::Statistics MeshOptimizer::optimize(MeshBuffers & buffers, Real tolerance) {
+        check(buffers);
+        Statistics statistics;
+        statistics.inputVertexCount = buffers.vertices.size() / 3;
+        statistics.inputTriangleCount = buffers.indices.size() / 3;
+        statistics.inputBytes = bufferBytes(buffers);
+
+        statistics.weldedCount = weldVertices(buffers, tolerance);
+        removeTriangles(buffers, statistics.degenerateCount, statistics.duplicateCount);
+        statistics.unusedCount = reorder(buffers);
+
+        statistics.vertexCount = buffers.vertices.size() / 3;
+        statistics.triangleCount = buffers.indices.size() / 3;
+        statistics.bytes = bufferBytes(buffers);
+
+        SDL_Log("Mesh Optimize: %u -> %u vertices (%u welded, %u unused), %u -> %u triangles (%u degenerate, %u duplicate), %.2f MB saved",
+                static_cast<Uint32>(statistics.inputVertexCount), static_cast<Uint32>(statistics.vertexCount),
+                static_cast<Uint32>(statistics.weldedCount), static_cast<Uint32>(statistics.unusedCount),
+                static_cast<Uint32>(statistics.inputTriangleCount), static_cast<Uint32>(statistics.triangleCount),
+                static_cast<Uint32>(statistics.degenerateCount), static_cast<Uint32>(statistics.duplicateCount),
+                static_cast<double>(statistics.inputBytes - statistics.bytes) / (1024.0 * 1024.0));
+        return statistics;
+    }
+}
@@ -1,4 +1,5 @@
 #include "util/PerlinGenerator.hpp"
+#include "util/KernelDispatch.hpp"
 
 namespace renderer {
     void PerlinGenerator::perlinGenerate(int *arr) {
@@ -12,7 +13,7 @@ namespace renderer {
         }
     }
 
-    double PerlinGenerator::perlinNoiseNoSmooth(const Point3 &point) const {
+    Real PerlinGenerator::perlinNoiseNoSmooth(const Point3 &point) const {
         //放大坐标，并使用按位与限定范围在0到255之间，快速取模运算（x % 256）
         const int i = static_cast<int>(4 * point[0]) & 255;
         const int j = static_cast<int>(4 * point[1]) & 255;
@@ -22,7 +23,7 @@ namespace renderer {
         return randomNumber[perlinX[i] ^ perlinY[j] ^ perlinZ[k]];
     }
 
-    double PerlinGenerator::perlinNoiseLinearSmooth(const Point3 &point) const {
+    Real PerlinGenerator::perlinNoiseLinearSmooth(const Point3 &point) const {
         //点坐标整数部分，代表了该点所在的立方体的“左下角”或起始顶点坐标
         const auto i = static_cast<int>(std::floor(point[0]));
         const auto j = static_cast<int>(std::floor(point[1]));
@@ -34,7 +35,7 @@ namespace renderer {
         const auto w = point[2] - std::floor(point[2]);
 
         //获取立方体 8 个顶点的噪声值，三重循环遍历立方体每一个顶点
-        double c[2][2][2];
+        Real c[2][2][2];
         for (int l = 0; l < 2; l++) {
             for (int m = 0; m < 2; m++) {
                 for (int n = 0; n < 2; n++) {
@@ -50,7 +51,7 @@ namespace renderer {
 
         //三线性插值 (Trilinear Interpolation)
         //通过加权平均将 8 个顶点的噪声值 c[l][m][n] 混合起来
-        double accum = 0.0;
+        Real accum = 0.0;
         for (int l = 0; l < 2; l++) {
             for (int m = 0; m < 2; m++) {
                 for (int n = 0; n < 2; n++) {
@@ -62,7 +63,7 @@ namespace renderer {
         return accum;
     }
 
-    double PerlinGenerator::hermitianSmoothImprove(const Point3 &point) const {
+    Real PerlinGenerator::hermitianSmoothImprove(const Point3 &point) const {
         const auto i = static_cast<int>(std::floor(point[0]));
         const auto j = static_cast<int>(std::floor(point[1]));
         const auto k = static_cast<int>(std::floor(point[2]));
@@ -88,7 +89,7 @@ namespace renderer {
         v = v * v * (3 - 2 * v);
         w = w * w * (3 - 2 * w);
 
-        double c[2][2][2];
+        Real c[2][2][2];
         for (int l = 0; l < 2; l++) {
             for (int m = 0; m < 2; m++) {
                 for (int n = 0; n < 2; n++) {
@@ -97,7 +98,7 @@ namespace renderer {
             }
         }
 
-        double accum = 0.0;
+        Real accum = 0.0;
         for (int l = 0; l < 2; l++) {
             for (int m = 0; m < 2; m++) {
                 for (int n = 0; n < 2; n++) {
@@ -108,7 +109,7 @@ namespace renderer {
         return accum;
     }
 
-    double PerlinGenerator::vectorLatticePoint(const Point3 &point) const {
+    Real PerlinGenerator::vectorLatticePoint(const Point3 &point) const {
         const auto i = static_cast<int>(std::floor(point[0]));
         const auto j = static_cast<int>(std::floor(point[1]));
         const auto k = static_cast<int>(std::floor(point[2]));
@@ -126,7 +127,7 @@ namespace renderer {
             }
         }
 
-        double accum = 0.0;
+        Real accum = 0.0;
         for (int l = 0; l < 2; l++) {
             for (int m = 0; m < 2; m++) {
                 for (int n = 0; n < 2; n++) {
@@ -138,20 +139,31 @@ namespace renderer {
         return accum;
     }
 
-    double PerlinGenerator::turbulenceNoise(const Point3 &point) const {
+    Real PerlinGenerator::turbulenceNoise(const Point3 &point) const {
         constexpr int depth = 7;
 
-        double accum = 0.0;
+        //每一层的坐标为原坐标乘以2的幂，各层互相独立，使用计算核一次计算所有层
+        Real x[depth], y[depth], z[depth], noise[depth];
         Point3 temp(point);
-        double weight = 1.0;
-
         for (int i = 0; i < depth; i++) {
-            accum += weight * vectorLatticePoint(temp);
-            weight /= 2.0;
+            x[i] = temp[0];
+            y[i] = temp[1];
+            z[i] = temp[2];
             for (int j = 0; j < 3; j++) {
                 temp[j] *= 2.0;
             }
         }
+
+        static_assert(sizeof(Vec3) == 3 * sizeof(Real), "Vec3 must be three packed scalars");
+        const PerlinTables tables {perlinX, perlinY, perlinZ, reinterpret_cast<const Real *>(randomVector)};
+        KernelDispatch::kernels().perlinVectorNoise(tables, x, y, z, depth, noise);
+
+        Real accum = 0.0;
+        Real weight = 1.0;
+        for (int i = 0; i < depth; i++) {
+            accum += weight * noise[i];
+            weight /= 2.0;
+        }
         return std::abs(accum);
     }
 